@@ -3,119 +3,8976 @@
 #include <iostream>
 #include <vector>
 #include <map>
+#include <list>
+#include <set>
 #include <filesystem> // For file system operations
 #include <fstream>    // For writing files
-#include <cstdlib>    // For std::system
-#include <cstdio>     // For popen, pclose (Unix-like)
+#include <sstream>
+#include <cstdlib>
+#include <cstdio>     // For popen, pclose (spawn benchmark only)
 #include <chrono>     // For unique directory name
+#include <ctime>
 #include <thread>
 #include <mutex>
+#include <future>
 #include <glibmm/dispatcher.h>
 #include <memory>
+#include <regex>      // For parsing compiler diagnostics
+#include <cmath>
+#include <random>
+#include <cstring>
+#include <cctype>
+#include <algorithm>
+#include <functional>
+#include <spawn.h>    // For posix_spawn
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/ioctl.h>
+#include <sys/utsname.h>
+#include <sys/mman.h>
+#include <sys/prctl.h>
+#include <sys/personality.h>
+#include <sys/file.h>
+#include <linux/perf_event.h>
+#include <elf.h>
+#include <termios.h>
+#include <sched.h>
+#include <poll.h>
+#include <csignal>
+
+extern char** environ;
+
+// --- JSON ---
+
+/**
+ * @brief Minimal JSON document model.
+ * Used to read structured compiler output and to export reports.
+ */
+struct JsonValue {
+    enum class Type { Null, Bool, Number, String, Array, Object };
+
+    Type type = Type::Null;
+    bool boolean = false;
+    double number = 0.0;
+    std::string string;
+    std::vector<JsonValue> array;
+    std::vector<std::pair<std::string, JsonValue>> object;
+
+    JsonValue() = default;
+    JsonValue(bool value) : type(Type::Bool), boolean(value) {}
+    JsonValue(int value) : type(Type::Number), number(value) {}
+    JsonValue(unsigned value) : type(Type::Number), number(value) {}
+    JsonValue(long value) : type(Type::Number), number(static_cast<double>(value)) {}
+    JsonValue(long long value) : type(Type::Number), number(static_cast<double>(value)) {}
+    JsonValue(unsigned long value) : type(Type::Number), number(static_cast<double>(value)) {}
+    JsonValue(unsigned long long value) : type(Type::Number), number(static_cast<double>(value)) {}
+    JsonValue(double value) : type(Type::Number), number(value) {}
+    JsonValue(const char* value) : type(Type::String), string(value) {}
+    JsonValue(const std::string& value) : type(Type::String), string(value) {}
+
+    static JsonValue make_array() { JsonValue v; v.type = Type::Array; return v; }
+    static JsonValue make_object() { JsonValue v; v.type = Type::Object; return v; }
+
+    bool is_null() const { return type == Type::Null; }
+    bool is_array() const { return type == Type::Array; }
+    bool is_object() const { return type == Type::Object; }
+
+    /**
+     * @brief Looks up a member of an object.
+     * @return The member, or a shared null value when absent.
+     */
+    const JsonValue& operator[](const std::string& key) const {
+        static const JsonValue null_value;
+        if (type == Type::Object) {
+            for (const auto& [k, v] : object) {
+                if (k == key) return v;
+            }
+        }
+        return null_value;
+    }
+    std::string as_string(const std::string& fallback = "") const {
+        return type == Type::String ? string : fallback;
+    }
+    double as_number(double fallback = 0.0) const {
+        return type == Type::Number ? number : fallback;
+    }
+    bool as_bool(bool fallback = false) const {
+        return type == Type::Bool ? boolean : fallback;
+    }
+
+    /** @brief Sets (or appends) an object member and returns *this for chaining. */
+    JsonValue& set(const std::string& key, JsonValue value) {
+        type = Type::Object;
+        for (auto& [k, v] : object) {
+            if (k == key) { v = std::move(value); return *this; }
+        }
+        object.emplace_back(key, std::move(value));
+        return *this;
+    }
+    /** @brief Appends an array element and returns *this for chaining. */
+    JsonValue& push(JsonValue value) {
+        type = Type::Array;
+        array.push_back(std::move(value));
+        return *this;
+    }
+};
+
+/**
+ * @brief Escapes a string for inclusion in a JSON document (quotes included).
+ */
+std::string json_quote(const std::string& text) {
+    std::string out = "\"";
+    for (unsigned char c : text) {
+        switch (c) {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if (c < 0x20) {
+                    char escaped[8];
+                    std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+                    out += escaped;
+                } else {
+                    out += static_cast<char>(c);
+                }
+        }
+    }
+    return out + "\"";
+}
+
+/**
+ * @brief Serialises a JSON value.
+ * @param value The value to write.
+ * @param indent Indentation width; 0 writes everything on one line.
+ * @param depth Current nesting depth (used for recursion).
+ */
+std::string to_json(const JsonValue& value, int indent = 2, int depth = 0) {
+    std::string pad = indent ? "\n" + std::string((depth + 1) * indent, ' ') : "";
+    std::string close_pad = indent ? "\n" + std::string(depth * indent, ' ') : "";
+    switch (value.type) {
+        case JsonValue::Type::Null: return "null";
+        case JsonValue::Type::Bool: return value.boolean ? "true" : "false";
+        case JsonValue::Type::Number: {
+            if (!std::isfinite(value.number)) return "null";
+            char buffer[32];
+            if (value.number == std::floor(value.number) && std::fabs(value.number) < 1e15) {
+                std::snprintf(buffer, sizeof(buffer), "%.0f", value.number);
+            } else {
+                std::snprintf(buffer, sizeof(buffer), "%.9g", value.number);
+            }
+            return buffer;
+        }
+        case JsonValue::Type::String: return json_quote(value.string);
+        case JsonValue::Type::Array: {
+            if (value.array.empty()) return "[]";
+            std::string out = "[";
+            for (size_t i = 0; i < value.array.size(); ++i) {
+                out += (i ? "," : "") + pad + to_json(value.array[i], indent, depth + 1);
+            }
+            return out + close_pad + "]";
+        }
+        case JsonValue::Type::Object: {
+            if (value.object.empty()) return "{}";
+            std::string out = "{";
+            for (size_t i = 0; i < value.object.size(); ++i) {
+                out += (i ? "," : "") + pad + json_quote(value.object[i].first) + (indent ? ": " : ":")
+                     + to_json(value.object[i].second, indent, depth + 1);
+            }
+            return out + close_pad + "}";
+        }
+    }
+    return "null";
+}
+
+/**
+ * @brief Recursive-descent JSON parser.
+ * Throws std::runtime_error on malformed input.
+ */
+class JsonParser {
+public:
+    explicit JsonParser(const std::string& text) : text_(text) {}
+
+    JsonValue parse() {
+        JsonValue value = parse_value(0);
+        skip_whitespace();
+        if (pos_ != text_.size()) fail("trailing characters");
+        return value;
+    }
+
+private:
+    const std::string& text_;
+    size_t pos_ = 0;
+
+    [[noreturn]] void fail(const std::string& what) const {
+        throw std::runtime_error("JSON parse error at offset " + std::to_string(pos_) + ": " + what);
+    }
+    void skip_whitespace() {
+        while (pos_ < text_.size() && std::isspace(static_cast<unsigned char>(text_[pos_]))) ++pos_;
+    }
+    bool consume(char c) {
+        skip_whitespace();
+        if (pos_ < text_.size() && text_[pos_] == c) { ++pos_; return true; }
+        return false;
+    }
+    void expect(char c) {
+        if (!consume(c)) fail(std::string("expected '") + c + "'");
+    }
+    bool consume_literal(const char* literal) {
+        size_t len = std::strlen(literal);
+        if (text_.compare(pos_, len, literal) == 0) { pos_ += len; return true; }
+        return false;
+    }
+    JsonValue parse_value(int depth) {
+        if (depth > 256) fail("nesting too deep");
+        skip_whitespace();
+        if (pos_ >= text_.size()) fail("unexpected end of input");
+        char c = text_[pos_];
+        if (c == '{') return parse_object(depth);
+        if (c == '[') return parse_array(depth);
+        if (c == '"') return JsonValue(parse_string());
+        if (consume_literal("true")) return JsonValue(true);
+        if (consume_literal("false")) return JsonValue(false);
+        if (consume_literal("null")) return JsonValue();
+        return JsonValue(parse_number());
+    }
+    JsonValue parse_object(int depth) {
+        JsonValue value = JsonValue::make_object();
+        expect('{');
+        if (consume('}')) return value;
+        do {
+            skip_whitespace();
+            if (pos_ >= text_.size() || text_[pos_] != '"') fail("expected member name");
+            std::string key = parse_string();
+            expect(':');
+            value.object.emplace_back(std::move(key), parse_value(depth + 1));
+        } while (consume(','));
+        expect('}');
+        return value;
+    }
+    JsonValue parse_array(int depth) {
+        JsonValue value = JsonValue::make_array();
+        expect('[');
+        if (consume(']')) return value;
+        do {
+            value.array.push_back(parse_value(depth + 1));
+        } while (consume(','));
+        expect(']');
+        return value;
+    }
+    double parse_number() {
+        const char* start = text_.c_str() + pos_;
+        char* end = nullptr;
+        double number = std::strtod(start, &end);
+        if (end == start) fail("unexpected character");
+        pos_ += static_cast<size_t>(end - start);
+        return number;
+    }
+    static void append_utf8(std::string& out, unsigned long cp) {
+        if (cp < 0x80) {
+            out += static_cast<char>(cp);
+        } else if (cp < 0x800) {
+            out += static_cast<char>(0xC0 | (cp >> 6));
+            out += static_cast<char>(0x80 | (cp & 0x3F));
+        } else if (cp < 0x10000) {
+            out += static_cast<char>(0xE0 | (cp >> 12));
+            out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (cp & 0x3F));
+        } else {
+            out += static_cast<char>(0xF0 | (cp >> 18));
+            out += static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+            out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (cp & 0x3F));
+        }
+    }
+    unsigned long parse_hex4() {
+        if (pos_ + 4 > text_.size()) fail("truncated \\u escape");
+        for (size_t i = pos_; i < pos_ + 4; ++i) {
+            if (!std::isxdigit(static_cast<unsigned char>(text_[i]))) fail("invalid \\u escape");
+        }
+        unsigned long cp = std::stoul(text_.substr(pos_, 4), nullptr, 16);
+        pos_ += 4;
+        return cp;
+    }
+    std::string parse_string() {
+        std::string out;
+        ++pos_; // opening quote
+        while (pos_ < text_.size()) {
+            char c = text_[pos_++];
+            if (c == '"') return out;
+            if (c != '\\') { out += c; continue; }
+            if (pos_ >= text_.size()) break;
+            char esc = text_[pos_++];
+            switch (esc) {
+                case 'n': out += '\n'; break;
+                case 't': out += '\t'; break;
+                case 'r': out += '\r'; break;
+                case 'b': out += '\b'; break;
+                case 'f': out += '\f'; break;
+                case 'u': {
+                    unsigned long cp = parse_hex4();
+                    if (cp >= 0xD800 && cp < 0xDC00) {
+                        // A high surrogate needs a low one next; unpaired halves become U+FFFD
+                        unsigned long low = 0;
+                        if (text_.compare(pos_, 2, "\\u") == 0) {
+                            size_t escape = pos_;
+                            pos_ += 2;
+                            low = parse_hex4();
+                            if (low < 0xDC00 || low > 0xDFFF) {
+                                pos_ = escape;  // Decoded on its own next
+                                low = 0;
+                            }
+                        }
+                        cp = low ? 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00) : 0xFFFD;
+                    } else if (cp >= 0xDC00 && cp <= 0xDFFF) {
+                        cp = 0xFFFD;
+                    }
+                    append_utf8(out, cp);
+                    break;
+                }
+                default: out += esc; break;
+            }
+        }
+        fail("unterminated string");
+    }
+};
+
+/**
+ * @brief Parses a JSON document.
+ * @param text The JSON text.
+ * @return The parsed value. Throws std::runtime_error on malformed input.
+ */
+JsonValue parse_json(const std::string& text) {
+    return JsonParser(text).parse();
+}
+
+// --- Process Spawning ---
+
+/**
+ * @brief How one of a child's standard streams is connected.
+ */
+enum class StdioMode {
+    Inherit,  // Share the launcher's stream
+    Null,     // /dev/null
+    Pipe,     // New pipe; the parent end is returned in ChildProcess
+    ToStdout, // stderr only: same destination as stdout
+    Fd        // Caller-supplied descriptor
+};
+
+/**
+ * @brief Everything needed to start a child without going through /bin/sh.
+ */
+struct SpawnOptions {
+    std::vector<std::string> argv;          // argv[0] is looked up in PATH
+    std::filesystem::path working_dir;      // Empty to inherit the launcher's
+    std::vector<std::string> env;           // "NAME=value" entries added to (or replacing) the launcher's environment
+    StdioMode stdin_mode = StdioMode::Null;
+    StdioMode stdout_mode = StdioMode::Pipe;
+    StdioMode stderr_mode = StdioMode::ToStdout;
+    int stdin_fd = -1;                      // Used with StdioMode::Fd
+    int stdout_fd = -1;
+    int stderr_fd = -1;
+
+    // Pre-exec setup
+    struct ResourceLimit {
+        int resource;   // RLIMIT_*
+        rlim_t soft;
+        rlim_t hard;
+    };
+    bool new_process_group = false;         // setpgid(0, 0), so the run and its children can be signalled together
+    std::vector<ResourceLimit> rlimits;
+    std::filesystem::path cgroup;           // cgroup v2 directory to join; empty to stay in the launcher's
+    bool pty = false;                       // Run on a new pseudo-terminal (stdio modes are ignored)
+    bool disable_thp = false;               // prctl(PR_SET_THP_DISABLE): no transparent hugepages for the run (spawn helper only)
+    std::vector<int> cpus;                  // sched_setaffinity(): the CPUs the run may use; empty for the launcher's
+    int nice = 0;                           // setpriority(): niceness of the run; 0 keeps the launcher's
+    int fifo_priority = 0;                  // sched_setscheduler(SCHED_FIFO) at this priority (1-99); 0 for the default policy
+    bool no_aslr = false;                   // personality(ADDR_NO_RANDOMIZE): the same address layout every run
+    // Called with the child's pid while it is held just before exec (held = true),
+    // or right after it started when it cannot be held (posix_spawn fallback)
+    std::function<void(pid_t pid, bool held)> before_exec;
+    // False to go straight to posix_spawn, e.g. from a before_exec hook while the helper holds a child
+    bool use_helper = true;
+};
+
+/**
+ * @brief A running (or exited but not yet reaped) child process.
+ * Owns the pidfd and the parent ends of any pipes; move-only. For pty runs
+ * stdin_fd and stdout_fd both refer to the terminal's master side.
+ */
+class ChildProcess {
+public:
+    pid_t pid = -1;
+    int pidfd = -1;      // -1 when the kernel has no pidfd_open
+    int stdin_fd = -1;
+    int stdout_fd = -1;
+    int stderr_fd = -1;
+    bool pty = false;
+
+    ChildProcess() = default;
+    ChildProcess(const ChildProcess&) = delete;
+    ChildProcess& operator=(const ChildProcess&) = delete;
+    ChildProcess(ChildProcess&& other) noexcept { *this = std::move(other); }
+    ChildProcess& operator=(ChildProcess&& other) noexcept {
+        if (this != &other) {
+            terminate();
+            pid = std::exchange(other.pid, -1);
+            pidfd = std::exchange(other.pidfd, -1);
+            stdin_fd = std::exchange(other.stdin_fd, -1);
+            stdout_fd = std::exchange(other.stdout_fd, -1);
+            stderr_fd = std::exchange(other.stderr_fd, -1);
+            pty = std::exchange(other.pty, false);
+        }
+        return *this;
+    }
+    ~ChildProcess() { terminate(); }
+
+    /**
+     * @brief Kills and reaps the child if it is still owned, so that an
+     * exception or early return between spawning and waiting leaves no zombie.
+     */
+    void terminate() {
+        close_fds();
+        if (pid > 0) {
+            ::kill(pid, SIGKILL);
+            wait();
+        }
+    }
+
+    /**
+     * @brief Blocks until the child exits and reaps it.
+     * @param usage Optional resource usage of the child.
+     * @return The raw wait status, or -1 on error.
+     */
+    int wait(struct rusage* usage = nullptr) {
+        if (pid <= 0) return -1;
+        int status = 0;
+        pid_t result;
+        do {
+            result = wait4(pid, &status, 0, usage);
+        } while (result < 0 && errno == EINTR);
+        pid = -1;
+        return result < 0 ? -1 : status;
+    }
+
+    static void close_fd(int& fd) {
+        if (fd >= 0) ::close(fd);
+        fd = -1;
+    }
+    void close_fds() {
+        close_fd(pidfd);
+        close_fd(stdin_fd);
+        close_fd(stdout_fd);
+        close_fd(stderr_fd);
+    }
+};
+
+/**
+ * @brief Converts a wait status into a shell-style exit code (128+signal if killed).
+ */
+int exit_code_of(int status) {
+    if (status < 0) return -1;
+    if (WIFEXITED(status)) return WEXITSTATUS(status);
+    if (WIFSIGNALED(status)) return 128 + WTERMSIG(status);
+    return -1;
+}
+
+/**
+ * @brief Writes a value to a cgroup control file.
+ * Uses write(2) directly, since the kernel reports rejected values from the write itself.
+ */
+bool write_cgroup_file(const std::filesystem::path& path, const std::string& value) {
+    int fd = ::open(path.c_str(), O_WRONLY | O_CLOEXEC);
+    if (fd < 0) return false;
+    bool ok = ::write(fd, value.data(), value.size()) == static_cast<ssize_t>(value.size());
+    ::close(fd);
+    return ok;
+}
+
+/**
+ * @brief Opens a pidfd for a child, or returns -1 if unsupported.
+ */
+int open_pidfd(pid_t pid) {
+#ifdef SYS_pidfd_open
+    return static_cast<int>(syscall(SYS_pidfd_open, pid, 0));
+#else
+    (void)pid;
+    return -1;
+#endif
+}
+
+/**
+ * @brief Builds the child's environment: the launcher's plus overrides.
+ */
+std::vector<std::string> build_environment(const std::vector<std::string>& overrides) {
+    std::vector<std::string> env;
+    for (char** entry = environ; entry && *entry; ++entry) {
+        std::string var = *entry;
+        std::string name = var.substr(0, var.find('='));
+        bool overridden = std::any_of(overrides.begin(), overrides.end(), [&name](const std::string& o) {
+            return o.compare(0, name.size() + 1, name + "=") == 0;
+        });
+        if (!overridden) env.push_back(std::move(var));
+    }
+    env.insert(env.end(), overrides.begin(), overrides.end());
+    return env;
+}
+
+std::vector<char*> to_c_array(std::vector<std::string>& strings) {
+    std::vector<char*> array;
+    array.reserve(strings.size() + 1);
+    for (auto& s : strings) array.push_back(s.data());
+    array.push_back(nullptr);
+    return array;
+}
+
+// --- Spawn Helper ---
+
+/**
+ * @brief Length-prefixed encoding used on the spawn helper socket.
+ */
+struct WireWriter {
+    std::string data;
+    void u32(uint32_t value) { data.append(reinterpret_cast<const char*>(&value), sizeof(value)); }
+    void u64(uint64_t value) { data.append(reinterpret_cast<const char*>(&value), sizeof(value)); }
+    void str(const std::string& value) { u32(static_cast<uint32_t>(value.size())); data += value; }
+    void strings(const std::vector<std::string>& values) {
+        u32(static_cast<uint32_t>(values.size()));
+        for (const auto& v : values) str(v);
+    }
+};
+
+struct WireReader {
+    const std::string& data;
+    size_t pos = 0;
+    bool ok = true;
+    explicit WireReader(const std::string& d) : data(d) {}
+    uint32_t u32() {
+        uint32_t value = 0;
+        if (pos + sizeof(value) > data.size()) { ok = false; return 0; }
+        std::memcpy(&value, data.data() + pos, sizeof(value));
+        pos += sizeof(value);
+        return value;
+    }
+    uint64_t u64() {
+        uint64_t value = 0;
+        if (pos + sizeof(value) > data.size()) { ok = false; return 0; }
+        std::memcpy(&value, data.data() + pos, sizeof(value));
+        pos += sizeof(value);
+        return value;
+    }
+    std::string str() {
+        uint32_t len = u32();
+        if (!ok || pos + len > data.size()) { ok = false; return ""; }
+        std::string value = data.substr(pos, len);
+        pos += len;
+        return value;
+    }
+    std::vector<std::string> strings() {
+        std::vector<std::string> values(u32());
+        for (auto& v : values) v = str();
+        return values;
+    }
+};
+
+bool write_fully(int fd, const void* data, size_t size) {
+    const char* p = static_cast<const char*>(data);
+    while (size > 0) {
+        ssize_t n = ::write(fd, p, size);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        p += n;
+        size -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+bool read_fully(int fd, void* data, size_t size) {
+    char* p = static_cast<char*>(data);
+    while (size > 0) {
+        ssize_t n = ::read(fd, p, size);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        p += n;
+        size -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+/**
+ * @brief Small pre-forked process that creates children on the launcher's behalf.
+ * It is forked at the very top of main(), before GTK maps its libraries and
+ * buffers, so each fork copies a tiny address space. Children are created with
+ * CLONE_PARENT, which makes them direct children of the launcher: wait4(),
+ * rusage and pidfds work exactly as for posix_spawn.
+ *
+ * Besides the cheaper fork, the helper is the only place where per-run state
+ * can be applied between fork and exec without touching the launcher: the THP
+ * flag, the personality, the cgroup, rlimits and the start gate all go into
+ * the child alone. posix_spawn has no hook for those, so the fallback in
+ * spawn_process() applies what it can after the child has started and
+ * refuses the THP flag.
+ */
+class SpawnHelper {
+public:
+    /**
+     * @brief Forks the helper. Must be called before any threads exist.
+     * @return True if the helper is running.
+     */
+    bool start() {
+        int fds[2];
+        if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, fds) != 0) return false;
+        pid_t pid = fork();
+        if (pid < 0) {
+            ::close(fds[0]);
+            ::close(fds[1]);
+            return false;
+        }
+        if (pid == 0) {
+            ::close(fds[0]);
+            serve(fds[1]);
+        }
+        ::close(fds[1]);
+        fd_ = fds[0];
+        helper_pid_ = pid;
+        return true;
+    }
+
+    bool available() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return fd_ >= 0 && enabled_;
+    }
+    void set_enabled(bool enabled) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        enabled_ = enabled;
+    }
+
+    /**
+     * @brief Asks the helper to start a child.
+     * @param options Command, environment and working directory.
+     * @param child_fds Descriptors to install as the child's 0/1/2; -1 inherits the launcher's.
+     * @param terminal Path of a pty slave to make the child's stdio and controlling terminal, or "".
+     * @return The child's pid; throws std::runtime_error if exec failed.
+     */
+    pid_t spawn(const SpawnOptions& options, const int child_fds[3], const std::string& terminal) {
+        WireWriter request;
+        request.strings(options.argv);
+        request.strings(build_environment(options.env));
+        request.str(options.working_dir.string());
+        request.u32((options.new_process_group ? kNewProcessGroup : 0) | (options.disable_thp ? kDisableThp : 0)
+                    | (options.no_aslr ? kNoAslr : 0));
+        request.u32(static_cast<uint32_t>(options.rlimits.size()));
+        for (const auto& limit : options.rlimits) {
+            request.u32(static_cast<uint32_t>(limit.resource));
+            request.u64(limit.soft);
+            request.u64(limit.hard);
+        }
+        request.str(options.cgroup.empty() ? std::string() : (options.cgroup / "cgroup.procs").string());
+        request.str(terminal);
+        request.u32(static_cast<uint32_t>(options.cpus.size()));
+        for (int cpu : options.cpus) request.u32(static_cast<uint32_t>(cpu));
+        request.u32(static_cast<uint32_t>(options.nice));
+        request.u32(static_cast<uint32_t>(options.fifo_priority));
+        uint32_t fd_mask = 0;
+        std::vector<int> passed;
+        for (int i = 0; i < 3; ++i) {
+            if (child_fds[i] >= 0) {
+                fd_mask |= 1u << i;
+                passed.push_back(child_fds[i]);
+            }
+        }
+        // Start gate: the child reports its pid on it and waits for a byte before exec
+        int gate[2] = {-1, -1};
+        if (options.before_exec) {
+            if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, gate) != 0) {
+                throw std::runtime_error(std::string("socketpair() failed: ") + std::strerror(errno));
+            }
+            fd_mask |= 1u << kGateFd;
+            passed.push_back(gate[1]);
+        }
+        struct GateGuard {
+            int* fds;
+            ~GateGuard() { for (int i = 0; i < 2; ++i) if (fds[i] >= 0) ::close(fds[i]); }
+        } gate_guard{gate};
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        uint32_t header[2] = {static_cast<uint32_t>(request.data.size()), fd_mask};
+        struct iovec iov = {header, sizeof(header)};
+        char control[CMSG_SPACE(kMaxPassedFds * sizeof(int))] = {};
+        struct msghdr msg = {};
+        msg.msg_iov = &iov;
+        msg.msg_iovlen = 1;
+        if (!passed.empty()) {
+            msg.msg_control = control;
+            msg.msg_controllen = CMSG_SPACE(passed.size() * sizeof(int));
+            struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+            cmsg->cmsg_level = SOL_SOCKET;
+            cmsg->cmsg_type = SCM_RIGHTS;
+            cmsg->cmsg_len = CMSG_LEN(passed.size() * sizeof(int));
+            std::memcpy(CMSG_DATA(cmsg), passed.data(), passed.size() * sizeof(int));
+        }
+        int32_t reply[2] = {-1, 0};
+        bool sent = sendmsg(fd_, &msg, MSG_NOSIGNAL) == static_cast<ssize_t>(sizeof(header)) &&
+                    write_fully(fd_, request.data.data(), request.data.size());
+        if (sent && gate[0] >= 0) {
+            // Only the helper may hold the child's end, so that EOF means the child died before the gate
+            ChildProcess::close_fd(gate[1]);
+            pid_t held_pid = -1;
+            if (read_fully(gate[0], &held_pid, sizeof(held_pid))) {
+                options.before_exec(held_pid, true);
+                char go = 1;
+                write_fully(gate[0], &go, 1);
+            }
+        }
+        if (!sent || !read_fully(fd_, reply, sizeof(reply))) {
+            // The helper is gone; fall back to posix_spawn from now on.
+            ::close(fd_);
+            fd_ = -1;
+            throw std::runtime_error("spawn helper unavailable");
+        }
+        pid_t pid = reply[0];
+        if (reply[1] != 0) {
+            if (pid > 0) waitpid(pid, nullptr, 0);
+            throw std::runtime_error("Could not start " + options.argv[0] + ": " + std::strerror(reply[1]));
+        }
+        return pid;
+    }
+
+private:
+    static constexpr uint32_t kNewProcessGroup = 1;
+    static constexpr uint32_t kDisableThp = 2;
+    static constexpr uint32_t kNoAslr = 4;
+    static constexpr int kGateFd = 3;        // fd_mask bit of the start gate, after stdin/stdout/stderr
+    static constexpr int kMaxPassedFds = 4;
+
+    int fd_ = -1;
+    pid_t helper_pid_ = -1;
+    bool enabled_ = true;
+    mutable std::mutex mutex_;  // Guards fd_, enabled_ and the request/reply exchange
+
+    [[noreturn]] static void serve(int fd) {
+        signal(SIGINT, SIG_IGN); // Ctrl-C in the terminal is for the launcher
+        while (true) {
+            uint32_t header[2];
+            char control[CMSG_SPACE(kMaxPassedFds * sizeof(int))] = {};
+            struct iovec iov = {header, sizeof(header)};
+            struct msghdr msg = {};
+            msg.msg_iov = &iov;
+            msg.msg_iovlen = 1;
+            msg.msg_control = control;
+            msg.msg_controllen = sizeof(control);
+            ssize_t n;
+            do {
+                n = recvmsg(fd, &msg, MSG_CMSG_CLOEXEC | MSG_WAITALL);
+            } while (n < 0 && errno == EINTR);
+            if (n != static_cast<ssize_t>(sizeof(header))) _exit(0); // Launcher exited
+
+            int fds[kMaxPassedFds] = {-1, -1, -1, -1};
+            std::vector<int> received;
+            for (struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg); cmsg; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+                if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_RIGHTS) {
+                    size_t count = (cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+                    received.resize(count);
+                    std::memcpy(received.data(), CMSG_DATA(cmsg), count * sizeof(int));
+                }
+            }
+            for (int i = 0, next = 0; i < kMaxPassedFds; ++i) {
+                if ((header[1] & (1u << i)) && next < static_cast<int>(received.size())) fds[i] = received[next++];
+            }
+            std::string payload(header[0], '\0');
+            if (!read_fully(fd, payload.data(), payload.size())) _exit(0);
+
+            int32_t reply[2] = {-1, 0};
+            spawn_child(payload, fds, reply);
+            for (int received_fd : received) ::close(received_fd);
+            if (!write_fully(fd, reply, sizeof(reply))) _exit(0);
+        }
+    }
+
+    static void spawn_child(const std::string& payload, const int fds[kMaxPassedFds], int32_t reply[2]) {
+        WireReader reader(payload);
+        std::vector<std::string> args = reader.strings();
+        std::vector<std::string> env = reader.strings();
+        std::string working_dir = reader.str();
+        uint32_t flags = reader.u32();
+        std::vector<SpawnOptions::ResourceLimit> rlimits(reader.u32());
+        for (auto& limit : rlimits) {
+            limit.resource = static_cast<int>(reader.u32());
+            limit.soft = reader.u64();
+            limit.hard = reader.u64();
+        }
+        std::string cgroup_procs = reader.str();
+        std::string terminal = reader.str();
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        uint32_t cpu_count = reader.u32();
+        for (uint32_t i = 0; i < cpu_count && reader.ok; ++i) {
+            uint32_t cpu = reader.u32();
+            if (cpu < CPU_SETSIZE) CPU_SET(cpu, &cpus);
+        }
+        int nice = static_cast<int>(reader.u32());
+        int fifo_priority = static_cast<int>(reader.u32());
+        if (!reader.ok || args.empty()) {
+            reply[1] = EINVAL;
+            return;
+        }
+        ChildSetup setup;
+        setup.args = to_c_array(args);
+        setup.env = to_c_array(env);
+        setup.working_dir = working_dir.empty() ? nullptr : working_dir.c_str();
+        setup.new_process_group = flags & kNewProcessGroup;
+        setup.disable_thp = flags & kDisableThp;
+        setup.no_aslr = flags & kNoAslr;
+        setup.nice = nice;
+        setup.fifo_priority = fifo_priority;
+        setup.rlimits = &rlimits;
+        setup.cgroup_procs = cgroup_procs.empty() ? nullptr : cgroup_procs.c_str();
+        setup.terminal = terminal.empty() ? nullptr : terminal.c_str();
+        setup.cpus = cpu_count > 0 ? &cpus : nullptr;
+        std::copy(fds, fds + 3, setup.fds);
+        setup.gate_fd = fds[kGateFd];
+
+        // vfork-style: the child borrows the helper's memory until it execs,
+        // so nothing is copied and exec errors come back through setup.error.
+        static char stack[64 * 1024];
+        pid_t pid = clone(child_main, stack + sizeof(stack), CLONE_PARENT | CLONE_VM | CLONE_VFORK | SIGCHLD, &setup);
+        if (setup.disable_thp) prctl(PR_SET_THP_DISABLE, 0, 0, 0, 0);
+        if (pid < 0) {
+            reply[1] = errno;
+            return;
+        }
+        reply[0] = pid;
+        reply[1] = setup.error;
+    }
+
+    /** @brief Pre-exec state shared with the vfork-style child. */
+    struct ChildSetup {
+        std::vector<char*> args;
+        std::vector<char*> env;
+        const char* working_dir = nullptr;
+        bool new_process_group = false;
+        bool disable_thp = false;
+        const std::vector<SpawnOptions::ResourceLimit>* rlimits = nullptr;
+        const char* cgroup_procs = nullptr;   // <cgroup>/cgroup.procs to join
+        const char* terminal = nullptr;       // pty slave for a new session
+        const cpu_set_t* cpus = nullptr;      // Affinity of the run, or null to keep the helper's
+        int nice = 0;
+        int fifo_priority = 0;
+        bool no_aslr = false;
+        int fds[3] = {-1, -1, -1};
+        int gate_fd = -1;
+        int error = 0;
+    };
+
+    static int child_main(void* arg) {
+        auto* setup = static_cast<ChildSetup*>(arg);
+        for (int i = 0; i < 3; ++i) {
+            if (setup->fds[i] >= 0) dup2(setup->fds[i], i);
+        }
+        if (setup->working_dir && chdir(setup->working_dir) != 0) {
+            setup->error = errno;
+            _exit(127);
+        }
+        if (setup->terminal) {
+            // A new session (and so process group) with the pty as controlling terminal
+            int fd = -1;
+            if (setsid() < 0 || (fd = open(setup->terminal, O_RDWR)) < 0 || ioctl(fd, TIOCSCTTY, 0) != 0) {
+                setup->error = errno;
+                _exit(127);
+            }
+            for (int i = 0; i < 3; ++i) dup2(fd, i);
+            if (fd > 2) close(fd);
+        } else if (setup->new_process_group && setpgid(0, 0) != 0) {
+            setup->error = errno;
+            _exit(127);
+        }
+        if (setup->cgroup_procs) {
+            // Joining before exec means the cgroup's caps cover the run from its first instruction
+            int fd = open(setup->cgroup_procs, O_WRONLY | O_CLOEXEC);
+            if (fd < 0 || write(fd, "0", 1) != 1) {
+                setup->error = errno;
+                _exit(127);
+            }
+            close(fd);
+        }
+        for (const auto& limit : *setup->rlimits) {
+            struct rlimit value = {limit.soft, limit.hard};
+            if (setrlimit(limit.resource, &value) != 0) {
+                setup->error = errno;
+                _exit(127);
+            }
+        }
+        // Kept across exec. Until then the flag is on the memory shared with the helper, which clears it again.
+        if (setup->disable_thp && prctl(PR_SET_THP_DISABLE, 1, 0, 0, 0) != 0) {
+            setup->error = errno;
+            _exit(127);
+        }
+        // Affinity, niceness, policy and personality are per thread (task), so unlike
+        // the THP flag these do not touch the helper
+        if (setup->cpus && sched_setaffinity(0, sizeof(cpu_set_t), setup->cpus) != 0) {
+            setup->error = errno;
+            _exit(127);
+        }
+        if (setup->nice != 0 && setpriority(PRIO_PROCESS, 0, setup->nice) != 0) {
+            setup->error = errno;
+            _exit(127);
+        }
+        if (setup->fifo_priority > 0) {
+            struct sched_param param = {};
+            param.sched_priority = setup->fifo_priority;
+            if (sched_setscheduler(0, SCHED_FIFO, &param) != 0) {
+                setup->error = errno;
+                _exit(127);
+            }
+        }
+        if (setup->no_aslr) {
+            int persona = personality(0xffffffff);
+            if (persona == -1 || personality(static_cast<unsigned long>(persona) | ADDR_NO_RANDOMIZE) == -1) {
+                setup->error = errno;
+                _exit(127);
+            }
+        }
+        // Like POSIX_SPAWN_SETSIGDEF | POSIX_SPAWN_SETSIGMASK: the helper ignores SIGINT and
+        // inherited the launcher's dispositions and mask, none of which the program should see
+        struct sigaction default_action = {};
+        default_action.sa_handler = SIG_DFL;
+        for (int sig = 1; sig < _NSIG; ++sig) {
+            if (sig != SIGKILL && sig != SIGSTOP) sigaction(sig, &default_action, nullptr);
+        }
+        sigset_t empty_mask;
+        sigemptyset(&empty_mask);
+        sigprocmask(SIG_SETMASK, &empty_mask, nullptr);
+        if (setup->gate_fd >= 0) {
+            // Last step before exec, so whatever the launcher attaches sees only the new program
+            pid_t self = static_cast<pid_t>(syscall(SYS_getpid));
+            char go = 0;
+            if (write(setup->gate_fd, &self, sizeof(self)) != static_cast<ssize_t>(sizeof(self)) ||
+                read(setup->gate_fd, &go, 1) != 1) {
+                setup->error = ECANCELED;
+                _exit(127);
+            }
+        }
+        execvpe(setup->args[0], setup->args.data(), setup->env.data());
+        setup->error = errno;
+        _exit(127);
+    }
+};
+
+// Global spawn helper, started at the top of main()
+SpawnHelper g_spawn_helper;
+
+/**
+ * @brief Starts a child process.
+ * No shell is involved: arguments are passed verbatim and nothing is quoted.
+ * Children are created by the pre-forked SpawnHelper when it is running, and
+ * with posix_spawn otherwise.
+ * @param options The command, environment and stream redirections.
+ * @return The child; throws std::runtime_error if it could not be started.
+ */
+ChildProcess spawn_process(const SpawnOptions& options) {
+    if (options.argv.empty()) throw std::runtime_error("spawn_process: empty argv");
+
+    // Descriptors owned by this call, closed on every exit path
+    struct FdSet {
+        std::vector<int> fds;
+        int take(int fd) { fds.push_back(fd); return fd; }
+        ~FdSet() { for (int fd : fds) if (fd >= 0) ::close(fd); }
+    } owned;
+    auto make_pipe = [&owned](int ends[2]) {
+        if (pipe2(ends, O_CLOEXEC) != 0) throw std::runtime_error(std::string("pipe2() failed: ") + std::strerror(errno));
+        owned.take(ends[0]);
+        owned.take(ends[1]);
+    };
+
+    // What the child gets as 0/1/2 (-1 inherits), and the parent ends of pipes
+    int child_fds[3] = {-1, -1, -1};
+    int parent_fds[3] = {-1, -1, -1};
+    const StdioMode modes[3] = {options.stdin_mode, options.stdout_mode, options.stderr_mode};
+    const int user_fds[3] = {options.stdin_fd, options.stdout_fd, options.stderr_fd};
+
+    // A pty makes libc line-buffer the child's stdout. Echo is turned off, since
+    // the output view shows input itself, and so is output processing (\n -> \r\n).
+    int master = -1;
+    std::string terminal;
+    if (options.pty) {
+        master = owned.take(posix_openpt(O_RDWR | O_NOCTTY | O_CLOEXEC));
+        char name[64];
+        if (master < 0 || grantpt(master) != 0 || unlockpt(master) != 0 || ptsname_r(master, name, sizeof(name)) != 0) {
+            throw std::runtime_error(std::string("Could not allocate a pseudo-terminal: ") + std::strerror(errno));
+        }
+        terminal = name;
+        struct termios attributes;
+        if (tcgetattr(master, &attributes) == 0) {
+            attributes.c_lflag &= ~static_cast<tcflag_t>(ECHO);
+            attributes.c_oflag &= ~static_cast<tcflag_t>(OPOST);
+            tcsetattr(master, TCSANOW, &attributes);
+        }
+        struct winsize size = {24, 80, 0, 0};
+        ioctl(master, TIOCSWINSZ, &size);
+    }
+    for (int i = 0; i < 3 && !options.pty; ++i) {
+        switch (modes[i]) {
+            case StdioMode::Inherit:
+                break;
+            case StdioMode::Null:
+                child_fds[i] = owned.take(::open("/dev/null", (i == 0 ? O_RDONLY : O_WRONLY) | O_CLOEXEC));
+                break;
+            case StdioMode::Pipe: {
+                int ends[2];
+                make_pipe(ends);
+                child_fds[i] = i == 0 ? ends[0] : ends[1];
+                parent_fds[i] = i == 0 ? ends[1] : ends[0];
+                break;
+            }
+            case StdioMode::ToStdout:
+                child_fds[i] = child_fds[STDOUT_FILENO] >= 0 ? child_fds[STDOUT_FILENO] : STDOUT_FILENO;
+                break;
+            case StdioMode::Fd:
+                child_fds[i] = user_fds[i];
+                break;
+        }
+    }
+
+    ChildProcess child;
+    bool spawned = false;
+    if (options.use_helper && g_spawn_helper.available()) {
+        try {
+            child.pid = g_spawn_helper.spawn(options, child_fds, terminal);
+            spawned = true;
+        } catch (const std::exception&) {
+            if (g_spawn_helper.available()) throw; // exec failed; the helper itself is fine
+        }
+    }
+    if (!spawned) {
+        // PR_SET_THP_DISABLE is a flag on the whole address space, so it cannot be
+        // set on the launcher for one spawn without affecting its other threads
+        if (options.disable_thp) {
+            throw std::runtime_error("spawn_process: disabling transparent hugepages needs the spawn helper");
+        }
+        posix_spawn_file_actions_t actions;
+        posix_spawn_file_actions_init(&actions);
+        std::unique_ptr<posix_spawn_file_actions_t, int (*)(posix_spawn_file_actions_t*)> actions_guard(
+            &actions, posix_spawn_file_actions_destroy);
+        for (int i = 0; i < 3; ++i) {
+            if (child_fds[i] >= 0) posix_spawn_file_actions_adddup2(&actions, child_fds[i], i);
+        }
+        if (options.pty) {
+            // Runs after POSIX_SPAWN_SETSID, so opening the slave makes it the controlling terminal
+            posix_spawn_file_actions_addopen(&actions, STDIN_FILENO, terminal.c_str(), O_RDWR, 0);
+            posix_spawn_file_actions_adddup2(&actions, STDIN_FILENO, STDOUT_FILENO);
+            posix_spawn_file_actions_adddup2(&actions, STDIN_FILENO, STDERR_FILENO);
+        }
+        if (!options.working_dir.empty()) {
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 29))
+            posix_spawn_file_actions_addchdir_np(&actions, options.working_dir.c_str());
+#else
+            throw std::runtime_error("spawn_process: working_dir is not supported on this platform");
+#endif
+        }
+
+        posix_spawnattr_t attr;
+        posix_spawnattr_init(&attr);
+        std::unique_ptr<posix_spawnattr_t, int (*)(posix_spawnattr_t*)> attr_guard(&attr, posix_spawnattr_destroy);
+        // Children start with default signal dispositions and an empty mask
+        sigset_t default_signals, empty_mask;
+        sigfillset(&default_signals);
+        sigemptyset(&empty_mask);
+        posix_spawnattr_setsigdefault(&attr, &default_signals);
+        posix_spawnattr_setsigmask(&attr, &empty_mask);
+        short flags = POSIX_SPAWN_SETSIGDEF | POSIX_SPAWN_SETSIGMASK;
+        if (options.pty) {
+#ifdef POSIX_SPAWN_SETSID
+            flags |= POSIX_SPAWN_SETSID;
+#else
+            throw std::runtime_error("spawn_process: pty runs need the spawn helper on this platform");
+#endif
+        } else if (options.new_process_group) {
+            posix_spawnattr_setpgroup(&attr, 0);
+            flags |= POSIX_SPAWN_SETPGROUP;
+        }
+        if (options.fifo_priority > 0) {
+            struct sched_param param = {};
+            param.sched_priority = options.fifo_priority;
+            posix_spawnattr_setschedpolicy(&attr, SCHED_FIFO);
+            posix_spawnattr_setschedparam(&attr, &param);
+            flags |= POSIX_SPAWN_SETSCHEDULER;
+        }
+        posix_spawnattr_setflags(&attr, flags);
+
+        std::vector<std::string> args = options.argv;
+        std::vector<std::string> env = build_environment(options.env);
+        std::vector<char*> c_args = to_c_array(args);
+        std::vector<char*> c_env = to_c_array(env);
+        // The calling thread's affinity and personality are inherited at fork and
+        // belong to this thread only; set them just for the spawn
+        cpu_set_t old_cpus;
+        bool pinned = false;
+        if (!options.cpus.empty() && sched_getaffinity(0, sizeof(old_cpus), &old_cpus) == 0) {
+            cpu_set_t cpus;
+            CPU_ZERO(&cpus);
+            for (int cpu : options.cpus) {
+                if (cpu >= 0 && cpu < CPU_SETSIZE) CPU_SET(cpu, &cpus);
+            }
+            pinned = sched_setaffinity(0, sizeof(cpus), &cpus) == 0;
+            if (!pinned) {
+                throw std::runtime_error("Could not set the CPU affinity of " + options.argv[0] + ": " + std::strerror(errno));
+            }
+        }
+        int old_persona = options.no_aslr ? personality(0xffffffff) : -1;
+        if (old_persona != -1) personality(static_cast<unsigned long>(old_persona) | ADDR_NO_RANDOMIZE);
+        int rc = posix_spawnp(&child.pid, c_args[0], &actions, &attr, c_args.data(), c_env.data());
+        if (old_persona != -1) personality(static_cast<unsigned long>(old_persona));
+        if (pinned) sched_setaffinity(0, sizeof(old_cpus), &old_cpus);
+        if (rc != 0) {
+            child.pid = -1;
+            throw std::runtime_error("Could not start " + options.argv[0] + ": " + std::strerror(rc));
+        }
+        // posix_spawn cannot set limits or niceness before exec (and raising the launcher's
+        // niceness around the spawn could not be undone unprivileged); apply them straight after.
+        if (options.nice != 0) setpriority(PRIO_PROCESS, static_cast<id_t>(child.pid), options.nice);
+        for (const auto& limit : options.rlimits) {
+            struct rlimit value = {limit.soft, limit.hard};
+            prlimit(child.pid, static_cast<__rlimit_resource>(limit.resource), &value, nullptr);
+        }
+        if (!options.cgroup.empty() &&
+            !write_cgroup_file(options.cgroup / "cgroup.procs", std::to_string(child.pid))) {
+            int error = errno;
+            ::kill(child.pid, SIGKILL);
+            waitpid(child.pid, nullptr, 0);
+            child.pid = -1;
+            throw std::runtime_error("Could not move " + options.argv[0] + " into its cgroup: " + std::strerror(error));
+        }
+        if (options.before_exec) options.before_exec(child.pid, false);
+    }
+
+    child.pidfd = open_pidfd(child.pid);
+    if (options.pty) {
+        child.pty = true;
+        child.stdin_fd = fcntl(master, F_DUPFD_CLOEXEC, 0);
+        parent_fds[1] = master;
+    }
+    for (int& fd : owned.fds) {
+        if (fd == parent_fds[0]) child.stdin_fd = std::exchange(fd, -1);
+        else if (fd == parent_fds[1]) child.stdout_fd = std::exchange(fd, -1);
+        else if (fd == parent_fds[2]) child.stderr_fd = std::exchange(fd, -1);
+    }
+    return child;
+}
+
+/**
+ * @brief Renders an argument vector for display (not for execution).
+ */
+std::string format_command(const std::vector<std::string>& argv) {
+    std::string text;
+    for (const auto& arg : argv) {
+        if (!text.empty()) text += ' ';
+        bool needs_quotes = arg.empty() || arg.find_first_of(" \t\"'\\$") != std::string::npos;
+        text += needs_quotes ? json_quote(arg) : arg;
+    }
+    return text;
+}
+
+/**
+ * @brief Splits a command line typed by the user into arguments, the inverse of format_command().
+ * Whitespace separates arguments; '...' is literal, and "..." and a bare
+ * backslash escape the next character. Nothing is expanded.
+ * @return The arguments; throws std::runtime_error on an unterminated quote.
+ */
+std::vector<std::string> split_arguments(const std::string& text) {
+    std::vector<std::string> args;
+    std::string current;
+    bool in_arg = false;
+    for (size_t i = 0; i < text.size(); ++i) {
+        char c = text[i];
+        if (std::isspace(static_cast<unsigned char>(c))) {
+            if (in_arg) args.push_back(std::move(current));
+            current.clear();
+            in_arg = false;
+            continue;
+        }
+        in_arg = true;
+        if (c == '\\' && i + 1 < text.size()) {
+            current += text[++i];
+        } else if (c == '\'' || c == '"') {
+            size_t j = i + 1;
+            for (; j < text.size() && text[j] != c; ++j) {
+                if (c == '"' && text[j] == '\\' && j + 1 < text.size()) ++j;
+                current += text[j];
+            }
+            if (j == text.size()) throw std::runtime_error(std::string("Unterminated ") + c + " in: " + text);
+            i = j;
+        } else {
+            current += c;
+        }
+    }
+    if (in_arg) args.push_back(std::move(current));
+    return args;
+}
+
+/**
+ * @brief Reads a descriptor until EOF.
+ */
+std::string read_all(int fd) {
+    std::string result;
+    char buffer[4096];
+    while (true) {
+        ssize_t n = ::read(fd, buffer, sizeof(buffer));
+        if (n > 0) {
+            result.append(buffer, static_cast<size_t>(n));
+        } else if (n < 0 && errno == EINTR) {
+            continue;
+        } else {
+            break;
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief Result of a child run to completion.
+ */
+struct ProcessResult {
+    int status = -1;     // Raw wait status
+    std::string output;  // stdout and stderr, interleaved
+    bool ok() const { return status == 0; }
+};
+
+/**
+ * @brief Runs a command to completion, capturing stdout and stderr together.
+ * @param argv The command and its arguments.
+ * @param working_dir Optional working directory.
+ * @return Exit status and output; throws std::runtime_error if it could not be started.
+ */
+ProcessResult run_process(const std::vector<std::string>& argv, const std::filesystem::path& working_dir = {}) {
+    SpawnOptions options;
+    options.argv = argv;
+    options.working_dir = working_dir;
+    ChildProcess child = spawn_process(options);
+    ProcessResult result;
+    result.output = read_all(child.stdout_fd);
+    result.status = child.wait();
+    return result;
+}
+
+/**
+ * @brief Function to run a command and capture its output.
+ * @param argv The command and its arguments (no shell is involved).
+ * @return The output of the command.
+ */
+std::string run_command(const std::vector<std::string>& argv) {
+    return run_process(argv).output;
+}
+
+/**
+ * @brief Looks a program up in PATH, as execvp() would.
+ * @return Its full path, or an empty path if it is not installed.
+ */
+std::filesystem::path find_in_path(const std::string& program) {
+    const char* path = std::getenv("PATH");
+    std::stringstream dirs(path ? path : "/usr/local/bin:/usr/bin:/bin");
+    std::string dir;
+    while (std::getline(dirs, dir, ':')) {
+        std::filesystem::path candidate = std::filesystem::path(dir.empty() ? "." : dir) / program;
+        if (access(candidate.c_str(), X_OK) == 0) return candidate;
+    }
+    return {};
+}
+
+/**
+ * @brief Function to clone a Git repository.
+ * @param repo_url The URL of the repository.
+ * @param local_dir The local directory to clone into.
+ * @return True if the clone was successful, false otherwise.
+ */
+bool clone_repository(const std::string& repo_url, const std::string& local_dir) {
+    std::cout << "Cloning " << repo_url << " into " << local_dir << std::endl;
+    SpawnOptions options;
+    options.argv = {"git", "clone", "--depth", "1", "--", repo_url, local_dir};
+    options.stdout_mode = StdioMode::Inherit;
+    options.stderr_mode = StdioMode::Inherit;
+    try {
+        return spawn_process(options).wait() == 0;
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return false;
+    }
+}
+
+/**
+ * @brief Runs git in a repository.
+ * @return Its output with trailing whitespace removed; throws std::runtime_error if git fails.
+ */
+std::string git_output(const std::filesystem::path& repo, const std::vector<std::string>& args) {
+    std::vector<std::string> argv = {"git", "-C", repo.string()};
+    argv.insert(argv.end(), args.begin(), args.end());
+    ProcessResult result = run_process(argv);
+    if (!result.ok()) {
+        throw std::runtime_error(format_command(argv) + " failed: " + result.output);
+    }
+    result.output.erase(result.output.find_last_not_of(" \t\r\n") + 1);
+    return result.output;
+}
+
+/**
+ * @brief Deepens a shallow clone step by step (50 commits, 500, then all of
+ * its history) until found() holds, checking it once before fetching.
+ * @return Whether found() came to hold.
+ */
+bool git_deepen_until(const std::filesystem::path& repo, const std::function<bool()>& found) {
+    if (found()) return true;
+    for (const char* deepen : {"--deepen=50", "--deepen=500", "--unshallow"}) {
+        ProcessResult shallow = run_process({"git", "-C", repo.string(), "rev-parse", "--is-shallow-repository"});
+        if (shallow.output.rfind("true", 0) != 0) break;
+        run_process({"git", "-C", repo.string(), "fetch", "--quiet", deepen, "origin"});
+        if (found()) return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Resolves a revision (SHA, branch, tag, HEAD~n) to a full commit SHA.
+ * Projects are cloned with --depth 1, so a revision that is not present is
+ * fetched by name first, then history is deepened step by step for relative
+ * names. Throws std::runtime_error if it cannot be found.
+ */
+std::string git_resolve_commit(const std::filesystem::path& repo, const std::string& revision) {
+    auto resolve = [&repo](const std::string& name) {
+        ProcessResult result = run_process({"git", "-C", repo.string(), "rev-parse", "--verify", "--quiet", name + "^{commit}"});
+        std::string sha = result.ok() ? result.output : "";
+        sha.erase(sha.find_last_not_of(" \t\r\n") + 1);
+        return sha;
+    };
+    std::string sha = resolve(revision);
+    if (!sha.empty()) return sha;
+    if (run_process({"git", "-C", repo.string(), "fetch", "--quiet", "origin", revision}).ok()) {
+        sha = resolve("FETCH_HEAD");
+        if (!sha.empty()) return sha;
+    }
+    if (git_deepen_until(repo, [&]() { return !(sha = resolve(revision)).empty(); })) return sha;
+    throw std::runtime_error("Revision " + revision + " not found in " + repo.string());
+}
+
+/**
+ * @brief Checks out a commit into a detached worktree, reusing an existing one.
+ * @param worktrees_dir Directory the worktree is created in.
+ * @return The worktree's root directory.
+ */
+std::filesystem::path git_worktree_for(const std::filesystem::path& repo, const std::string& sha,
+                                       const std::filesystem::path& worktrees_dir) {
+    std::filesystem::path worktree = worktrees_dir / (repo.filename().string() + "-" + sha.substr(0, 12));
+    if (!std::filesystem::exists(worktree)) {
+        std::filesystem::create_directories(worktrees_dir);
+        git_output(repo, {"worktree", "add", "--detach", "--quiet", worktree.string(), sha});
+    }
+    return worktree;
+}
+
+/**
+ * @brief Compares process-creation latency of the available strategies.
+ * Run with --bench-spawn [iterations]. Each strategy is measured with and
+ * without a large touched heap standing in for the GTK launcher's footprint,
+ * since fork() cost grows with the parent's address space.
+ */
+void benchmark_spawn(int iterations) {
+    auto time_us = [iterations](const std::function<void()>& spawn_once) {
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; ++i) spawn_once();
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        return std::chrono::duration<double, std::micro>(elapsed).count() / iterations;
+    };
+    auto via_popen = []() {
+        FILE* pipe = popen("true", "r");
+        if (pipe) pclose(pipe);
+    };
+    auto via_fork = []() {
+        pid_t pid = fork();
+        if (pid == 0) {
+            execlp("true", "true", static_cast<char*>(nullptr));
+            _exit(127);
+        }
+        if (pid > 0) waitpid(pid, nullptr, 0);
+    };
+    auto via_spawn = []() {
+        SpawnOptions options;
+        options.argv = {"true"};
+        options.stdout_mode = StdioMode::Null;
+        options.stderr_mode = StdioMode::Null;
+        spawn_process(options).wait();
+    };
+    bool helper = g_spawn_helper.available();
+    auto run_all = [&](const char* label) {
+        double popen_us = time_us(via_popen);
+        double fork_us = time_us(via_fork);
+        g_spawn_helper.set_enabled(false);
+        double posix_us = time_us(via_spawn);
+        g_spawn_helper.set_enabled(true);
+        double helper_us = helper ? time_us(via_spawn) : 0.0;
+        std::printf("%-22s popen %8.1f us | fork+exec %8.1f us | posix_spawn %8.1f us | spawn helper %8.1f us\n",
+                    label, popen_us, fork_us, posix_us, helper_us);
+    };
+    run_all("small heap");
+    std::vector<char> ballast(512u << 20, 1);
+    run_all("512 MiB touched heap");
+    std::printf("(%d iterations each%s, ballast checksum %d)\n", iterations,
+                helper ? "" : ", spawn helper unavailable", ballast[ballast.size() / 2]);
+}
+
+// --- Compiler Diagnostics ---
+
+/**
+ * @brief Compact model of compiler diagnostics.
+ * File names are interned once; notes and template-instantiation context are
+ * stored as children of the diagnostic they belong to.
+ */
+struct DiagnosticList {
+    enum class Severity : unsigned char { Note, Warning, Error, Fatal };
+
+    struct Diagnostic {
+        Severity severity = Severity::Note;
+        int file = -1;               // Index into files, -1 if the diagnostic has no location
+        unsigned line = 0;
+        unsigned column = 0;
+        std::string message;
+        std::vector<size_t> children; // Indices into items
+    };
+
+    std::vector<std::string> files;
+    std::vector<Diagnostic> items;
+    std::vector<size_t> top_level;    // Indices into items, in compiler order
+
+    int intern_file(const std::string& name) {
+        auto it = file_index_.find(name);
+        if (it != file_index_.end()) return it->second;
+        files.push_back(name);
+        file_index_[name] = static_cast<int>(files.size() - 1);
+        return static_cast<int>(files.size() - 1);
+    }
+    size_t count(Severity severity) const {
+        size_t n = 0;
+        for (size_t idx : top_level) {
+            if (items[idx].severity == severity) ++n;
+        }
+        return n;
+    }
+    std::string location(const Diagnostic& diag) const {
+        if (diag.file < 0) return "";
+        std::string loc = files[diag.file];
+        if (diag.line) loc += ":" + std::to_string(diag.line);
+        if (diag.column) loc += ":" + std::to_string(diag.column);
+        return loc;
+    }
+    static const char* severity_name(Severity severity) {
+        switch (severity) {
+            case Severity::Note: return "note";
+            case Severity::Warning: return "warning";
+            case Severity::Error: return "error";
+            case Severity::Fatal: return "fatal error";
+        }
+        return "note";
+    }
+    static Severity severity_from(const std::string& kind) {
+        if (kind == "fatal error") return Severity::Fatal;
+        if (kind == "error") return Severity::Error;
+        if (kind == "warning") return Severity::Warning;
+        return Severity::Note;
+    }
+
+private:
+    std::map<std::string, int> file_index_;
+};
+
+/**
+ * @brief Adds one diagnostic from GCC's -fdiagnostics-format=json output.
+ * @return Index of the new item in list.items.
+ */
+size_t add_json_diagnostic(DiagnosticList& list, const JsonValue& json) {
+    DiagnosticList::Diagnostic diag;
+    diag.severity = DiagnosticList::severity_from(json["kind"].as_string());
+    diag.message = json["message"].as_string();
+    const JsonValue& locations = json["locations"];
+    if (locations.is_array() && !locations.array.empty()) {
+        const JsonValue& caret = locations.array.front()["caret"];
+        if (caret.is_object()) {
+            diag.file = list.intern_file(caret["file"].as_string());
+            diag.line = static_cast<unsigned>(caret["line"].as_number());
+            diag.column = static_cast<unsigned>(caret["column"].as_number());
+        }
+    }
+    list.items.push_back(std::move(diag));
+    size_t index = list.items.size() - 1;
+    const JsonValue& children = json["children"];
+    if (children.is_array()) {
+        for (const auto& child : children.array) {
+            size_t child_index = add_json_diagnostic(list, child);
+            list.items[index].children.push_back(child_index);
+        }
+    }
+    return index;
+}
+
+/**
+ * @brief Parses compiler output into a DiagnosticList.
+ * JSON diagnostic arrays are decoded structurally; any remaining text (linker
+ * errors, or compilers without JSON support) is parsed as classic
+ * "file:line:col: severity: message" lines.
+ * @param output Combined compiler output.
+ */
+DiagnosticList parse_compiler_diagnostics(const std::string& output) {
+    DiagnosticList list;
+    static const std::regex located(R"(^(.+?):(\d+):(?:(\d+):)? (fatal error|error|warning|note): (.*)$)");
+    static const std::regex unlocated(R"(^(.+?): (fatal error|error|warning|note): (.*)$)");
+    // Lines that introduce the diagnostic after them, e.g. "In file included from a.h:3,"
+    static const std::regex context(R"(^(In file included from |\s+from |.*: (In (static |member )?function|In lambda function|In instantiation of|In constructor|In destructor|At global scope|in function)|.*:\d+:(\d+:)?\s+(required|recursively required) (from|by)))");
+    std::vector<size_t> pending_context;  // Items waiting for the diagnostic they introduce
+    size_t start = 0;
+    while (start < output.size()) {
+        size_t end = output.find('\n', start);
+        if (end == std::string::npos) end = output.size();
+        std::string line = output.substr(start, end - start);
+        start = end + 1;
+        if (line.empty()) continue;
+        if (line.front() == '[') {
+            try {
+                JsonValue json = parse_json(line);
+                for (const auto& entry : json.array) {
+                    list.top_level.push_back(add_json_diagnostic(list, entry));
+                }
+                continue;
+            } catch (const std::exception&) {
+                // Not a JSON document after all; fall through to text parsing.
+            }
+        }
+        DiagnosticList::Diagnostic diag;
+        std::smatch match;
+        if (std::regex_match(line, match, located)) {
+            diag.file = list.intern_file(match[1]);
+            diag.line = static_cast<unsigned>(std::stoul(match[2]));
+            diag.column = match[3].matched ? static_cast<unsigned>(std::stoul(match[3])) : 0;
+            diag.severity = DiagnosticList::severity_from(match[4]);
+            diag.message = match[5];
+        } else if (std::regex_match(line, match, unlocated)) {
+            diag.file = list.intern_file(match[1]);
+            diag.severity = DiagnosticList::severity_from(match[2]);
+            diag.message = match[3];
+        } else {
+            diag.message = line;
+            if (line.find("undefined reference") != std::string::npos ||
+                line.find("multiple definition") != std::string::npos) {
+                diag.severity = DiagnosticList::Severity::Error;
+            } else if (std::regex_search(line, context)) {
+                list.items.push_back(std::move(diag));
+                pending_context.push_back(list.items.size() - 1);
+                continue;
+            }
+        }
+        list.items.push_back(std::move(diag));
+        size_t index = list.items.size() - 1;
+        // Notes and source excerpts belong to the preceding top-level diagnostic,
+        // include and instantiation context to the one that follows it.
+        if (list.items[index].severity == DiagnosticList::Severity::Note && !list.top_level.empty()
+            && pending_context.empty()) {
+            list.items[list.top_level.back()].children.push_back(index);
+        } else {
+            std::vector<size_t>& children = list.items[index].children;
+            children.insert(children.begin(), pending_context.begin(), pending_context.end());
+            pending_context.clear();
+            list.top_level.push_back(index);
+        }
+    }
+    // Context with nothing after it is shown as it is
+    list.top_level.insert(list.top_level.end(), pending_context.begin(), pending_context.end());
+    return list;
+}
+
+// --- Compile-Time Profiling ---
+
+/**
+ * @brief Aggregated compile-time profile across one or more translation units.
+ * Fed from clang -ftime-trace JSON files or GCC -ftime-report text.
+ */
+struct CompileTimeReport {
+    struct Entry {
+        std::string name;
+        double total_ms = 0.0;
+        unsigned count = 0;
+    };
+
+    std::vector<std::string> translation_units;
+    std::map<std::string, Entry> phases;
+    std::map<std::string, Entry> headers;   // Only available from clang traces
+    std::map<std::string, Entry> templates;
+    double total_ms = 0.0;
+
+    static void add(std::map<std::string, Entry>& bucket, const std::string& name, double ms) {
+        Entry& entry = bucket[name];
+        entry.name = name;
+        entry.total_ms += ms;
+        entry.count++;
+    }
+
+    /**
+     * @brief Adds the events of a clang -ftime-trace file.
+     * @param tu The translation unit the trace belongs to.
+     * @param trace The parsed Chrome trace-event document.
+     */
+    void add_clang_trace(const std::string& tu, const JsonValue& trace) {
+        translation_units.push_back(tu);
+        const JsonValue& events = trace["traceEvents"];
+        if (!events.is_array()) return;
+        for (const auto& event : events.array) {
+            if (event["ph"].as_string() != "X") continue;
+            std::string name = event["name"].as_string();
+            double ms = event["dur"].as_number() / 1000.0;
+            std::string detail = event["args"]["detail"].as_string();
+            if (name.rfind("Total ", 0) == 0) {
+                add(phases, name.substr(6), ms);
+                if (name == "Total ExecuteCompiler") total_ms += ms;
+            } else if (name == "Source") {
+                add(headers, detail, ms);
+            } else if (name == "InstantiateClass" || name == "InstantiateFunction") {
+                add(templates, detail, ms);
+            }
+        }
+    }
+
+    /**
+     * @brief Extracts a GCC -ftime-report table from compiler output.
+     * GCC reports timers per phase, not per header or template, so only the
+     * phases and the overall "template instantiation" timer are recorded.
+     * @param tu The translation unit the report belongs to.
+     * @param output Compiler output; the report lines are removed from it.
+     */
+    void add_gcc_time_report(const std::string& tu, std::string& output) {
+        static const std::regex timer_line(
+            R"(^ (\|?)(.+?)\s*:\s*([\d.]+)\s*\(\s*\d+%\)\s*([\d.]+)\s*\(\s*\d+%\)\s*([\d.]+)\s*\(\s*\d+%\).*$)");
+        static const std::regex total_line(R"(^ TOTAL\s*:\s*([\d.]+)\s+([\d.]+)\s+([\d.]+).*$)");
+        translation_units.push_back(tu);
+        std::string remaining;
+        bool in_report = false;
+        size_t start = 0;
+        while (start < output.size()) {
+            size_t end = output.find('\n', start);
+            if (end == std::string::npos) end = output.size();
+            std::string line = output.substr(start, end - start);
+            start = end + 1;
+            std::smatch match;
+            if (line.rfind("Time variable", 0) == 0) {
+                in_report = true;
+            } else if (in_report && std::regex_match(line, match, total_line)) {
+                total_ms += std::stod(match[3]) * 1000.0;
+                in_report = false;
+            } else if (in_report && std::regex_match(line, match, timer_line)) {
+                std::string name = match[2];
+                double wall_ms = std::stod(match[5]) * 1000.0;
+                if (name.rfind("phase ", 0) == 0) {
+                    add(phases, name.substr(6), wall_ms);
+                } else if (name == "template instantiation") {
+                    add(templates, "(all template instantiations)", wall_ms);
+                    add(phases, name, wall_ms);
+                } else if (match[1].length() == 0) {
+                    add(phases, name, wall_ms);
+                }
+            } else if (!in_report && !line.empty()) {
+                remaining += line + "\n";
+            }
+        }
+        output = remaining;
+    }
+
+    /**
+     * @brief Returns the most expensive entries of a bucket.
+     * @param bucket One of phases, headers or templates.
+     * @param limit Maximum number of entries, 0 for all.
+     */
+    static std::vector<Entry> top(const std::map<std::string, Entry>& bucket, size_t limit) {
+        std::vector<Entry> entries;
+        entries.reserve(bucket.size());
+        for (const auto& [name, entry] : bucket) entries.push_back(entry);
+        std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.total_ms > b.total_ms; });
+        if (limit && entries.size() > limit) entries.resize(limit);
+        return entries;
+    }
+
+    JsonValue to_json_value(size_t limit = 100) const {
+        auto bucket_json = [limit](const std::map<std::string, Entry>& bucket) {
+            JsonValue array = JsonValue::make_array();
+            for (const auto& entry : top(bucket, limit)) {
+                array.push(JsonValue::make_object().set("name", entry.name).set("total_ms", entry.total_ms).set("count", entry.count));
+            }
+            return array;
+        };
+        JsonValue tus = JsonValue::make_array();
+        for (const auto& tu : translation_units) tus.push(tu);
+        return JsonValue::make_object()
+            .set("translation_units", tus)
+            .set("total_ms", total_ms)
+            .set("phases", bucket_json(phases))
+            .set("headers", bucket_json(headers))
+            .set("templates", bucket_json(templates));
+    }
+};
+
+/**
+ * @brief Checks whether a compiler driver is clang (e.g. g++ on macOS).
+ * The answer is cached per driver name.
+ */
+bool compiler_is_clang(const std::string& compiler) {
+    static std::map<std::string, bool> cache;
+    auto it = cache.find(compiler);
+    if (it != cache.end()) return it->second;
+    bool clang = false;
+    try {
+        clang = run_command({compiler, "--version"}).find("clang") != std::string::npos;
+    } catch (const std::exception&) {
+    }
+    cache[compiler] = clang;
+    return clang;
+}
+
+/**
+ * @brief Writes text to a file.
+ * @return True on success.
+ */
+bool write_text_file(const std::filesystem::path& path, const std::string& content) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) return false;
+    out << content;
+    return static_cast<bool>(out);
+}
+
+/**
+ * @brief Reads a whole file into a string; returns an empty string on failure.
+ */
+std::string read_text_file(const std::filesystem::path& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return "";
+    return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+// --- Toolchains ---
+
+std::filesystem::path cache_directory(); // Under Heap Profiling
+
+/**
+ * @brief Per-user data directory of the launcher ($XDG_DATA_HOME/boredaf or
+ * ~/.local/share/boredaf), for what must outlive the cache. Created on first use.
+ */
+std::filesystem::path data_directory() {
+    const char* xdg = std::getenv("XDG_DATA_HOME");
+    const char* home = std::getenv("HOME");
+    std::filesystem::path dir = xdg && *xdg ? std::filesystem::path(xdg)
+                              : home && *home ? std::filesystem::path(home) / ".local" / "share"
+                              : std::filesystem::temp_directory_path();
+    dir /= "boredaf";
+    std::error_code ignored;
+    std::filesystem::create_directories(dir, ignored);
+    return dir;
+}
+
+/**
+ * @brief An installed C++ compiler.
+ */
+struct Toolchain {
+    std::string name;          // Driver as found in PATH and used in commands, e.g. "clang++-18"
+    std::filesystem::path path; // The driver with symlinks resolved
+    std::string family;        // "gcc" or "clang"
+    std::string version;       // e.g. "13.2.0"
+    std::string version_line;  // First line of `<driver> --version`
+
+    /** @brief Short description for menus and tables, e.g. "clang++-18 (clang 18.1.3)". */
+    std::string label() const { return name + " (" + family + " " + version + ")"; }
+};
+
+/**
+ * @brief Asks a compiler driver what it is.
+ * @return False if it does not run or is not GCC or clang.
+ */
+bool probe_toolchain(Toolchain& toolchain) {
+    std::string version;
+    try {
+        version = run_command({toolchain.name, "--version"});
+    } catch (const std::exception&) {
+        return false;
+    }
+    toolchain.version_line = version.substr(0, version.find('\n'));
+    std::smatch match;
+    if (version.find("clang") != std::string::npos) {
+        toolchain.family = "clang";
+        static const std::regex kVersion(R"(version (\d+(\.\d+)+))");
+        if (std::regex_search(toolchain.version_line, match, kVersion)) toolchain.version = match[1];
+    } else if (version.find("Free Software Foundation") != std::string::npos) {
+        toolchain.family = "gcc";
+        // The --version line has distribution details; -dumpfullversion (GCC 7+) is exact
+        try {
+            std::string full = run_command({toolchain.name, "-dumpfullversion", "-dumpversion"});
+            toolchain.version = full.substr(0, full.find_first_of("\r\n"));
+        } catch (const std::exception&) {
+        }
+    } else {
+        return false;
+    }
+    if (toolchain.version.empty()) toolchain.version = "unknown";
+    return true;
+}
+
+/**
+ * @brief The C++ compilers in PATH (g++, clang++ and their versioned names
+ * such as g++-13), each driver once however many names it has.
+ * The probe runs once per launcher. Its results are kept in
+ * toolchains.json in the cache directory and reused for drivers whose
+ * modification time and size have not changed, so only new or upgraded
+ * compilers are asked for their version.
+ */
+const std::vector<Toolchain>& installed_toolchains() {
+    static std::vector<Toolchain> toolchains;
+    static std::once_flag probed;
+    std::call_once(probed, []() {
+        std::filesystem::path cache_file = cache_directory() / "toolchains.json";
+        JsonValue cached;
+        try {
+            cached = parse_json(read_text_file(cache_file));
+        } catch (const std::exception&) {
+            // No cache yet, or a damaged one; it is rewritten below
+        }
+        auto stamp = [](const std::filesystem::path& path) {
+            struct stat info;
+            return stat(path.c_str(), &info) == 0 ? std::to_string(info.st_mtime) + ":" + std::to_string(info.st_size) : "";
+        };
+
+        static const std::regex kDriver(R"((g|clang)\+\+(-[0-9.]+)?)");
+        const char* path_env = std::getenv("PATH");
+        std::stringstream dirs(path_env ? path_env : "/usr/local/bin:/usr/bin:/bin");
+        std::string dir;
+        std::set<std::filesystem::path> seen;
+        JsonValue cache_json = JsonValue::make_array();
+        while (std::getline(dirs, dir, ':')) {
+            std::error_code ec;
+            std::vector<std::string> names;
+            for (const auto& entry : std::filesystem::directory_iterator(dir.empty() ? "." : dir, ec)) {
+                std::string name = entry.path().filename().string();
+                if (std::regex_match(name, kDriver) && access(entry.path().c_str(), X_OK) == 0) names.push_back(name);
+            }
+            std::sort(names.begin(), names.end()); // "g++" before "g++-13", so the plain name is kept
+            for (const auto& name : names) {
+                std::filesystem::path resolved = std::filesystem::canonical(std::filesystem::path(dir) / name, ec);
+                if (ec || !seen.insert(resolved).second) continue;
+                Toolchain toolchain;
+                toolchain.name = name;
+                toolchain.path = resolved;
+                std::string modified = stamp(resolved);
+                bool known = false;
+                for (const auto& entry : cached.array) {
+                    if (entry["path"].as_string() == resolved.string() && entry["modified"].as_string() == modified) {
+                        toolchain.family = entry["family"].as_string();
+                        toolchain.version = entry["version"].as_string();
+                        toolchain.version_line = entry["version_line"].as_string();
+                        known = true;
+                        break;
+                    }
+                }
+                if (!known && !probe_toolchain(toolchain)) continue;
+                cache_json.push(JsonValue::make_object()
+                    .set("path", resolved.string())
+                    .set("modified", modified)
+                    .set("family", toolchain.family)
+                    .set("version", toolchain.version)
+                    .set("version_line", toolchain.version_line));
+                toolchains.push_back(std::move(toolchain));
+            }
+        }
+        write_text_file(cache_file, to_json(cache_json) + "\n");
+    });
+    return toolchains;
+}
+
+/**
+ * @brief The compiler used when none is chosen: g++ if it is installed, else
+ * the first compiler found, else "g++" so that the failure names it.
+ */
+std::string default_compiler() {
+    const std::vector<Toolchain>& toolchains = installed_toolchains();
+    for (const auto& toolchain : toolchains) {
+        if (toolchain.name == "g++") return toolchain.name;
+    }
+    return toolchains.empty() ? "g++" : toolchains.front().name;
+}
+
+// --- Resource Accounting ---
+
+/**
+ * @brief Resources a finished run consumed.
+ * CPU, memory, fault and context-switch figures come from wait4()'s rusage
+ * (covering the run and every descendant it reaped); I/O figures from
+ * /proc/<pid>/io, read while the child is a zombie.
+ */
+struct RunUsage {
+    double wall_seconds = 0.0;
+    double user_seconds = 0.0;
+    double system_seconds = 0.0;
+    long max_rss_kb = 0;
+    long minor_faults = 0;
+    long major_faults = 0;
+    long voluntary_switches = 0;
+    long involuntary_switches = 0;
+    bool io_valid = false;
+    unsigned long long read_chars = 0;   // rchar: bytes passed to read()-like calls
+    unsigned long long write_chars = 0;  // wchar
+    unsigned long long read_bytes = 0;   // Bytes actually fetched from storage
+    unsigned long long write_bytes = 0;  // Bytes sent to storage
+    bool cgroup_valid = false;           // Ran in its own cgroup; the counters below are set
+    unsigned long long memory_max_events = 0;  // Times memory.max forced reclaim
+    unsigned long long oom_events = 0;
+    unsigned long long oom_kills = 0;
+    unsigned long long memory_peak_bytes = 0;
+    unsigned long long cpu_periods = 0;
+    unsigned long long cpu_throttled_periods = 0;
+    double cpu_throttled_seconds = 0.0;
+    bool counters_valid = false;         // Hardware counters were read (PerfCounters)
+    bool counters_scaled = false;        // Some were multiplexed and extrapolated
+    bool counters_user_only = false;     // Kernel-mode events excluded by perf_event_paranoid
+    bool task_clock_valid = false;
+    double task_clock_ns = 0.0;
+    double cycles = 0.0;
+    double instructions = 0.0;
+    double branches = 0.0;
+    double branch_misses = 0.0;
+    double cache_references = 0.0;
+    double cache_misses = 0.0;
+
+    /** @brief Instructions per cycle, or 0 if not counted. */
+    double ipc() const { return cycles > 0 ? instructions / cycles : 0.0; }
+
+    void set_rusage(const struct rusage& usage) {
+        user_seconds = usage.ru_utime.tv_sec + usage.ru_utime.tv_usec / 1e6;
+        system_seconds = usage.ru_stime.tv_sec + usage.ru_stime.tv_usec / 1e6;
+        max_rss_kb = usage.ru_maxrss;
+        minor_faults = usage.ru_minflt;
+        major_faults = usage.ru_majflt;
+        voluntary_switches = usage.ru_nvcsw;
+        involuntary_switches = usage.ru_nivcsw;
+    }
+
+    /**
+     * @brief Reads /proc/<pid>/io. Must be called before the child is reaped.
+     * @return True if the counters were available.
+     */
+    bool read_proc_io(pid_t pid) {
+        std::ifstream in("/proc/" + std::to_string(pid) + "/io");
+        std::string key;
+        unsigned long long value;
+        while (in >> key >> value) {
+            if (key == "rchar:") read_chars = value;
+            else if (key == "wchar:") write_chars = value;
+            else if (key == "read_bytes:") read_bytes = value;
+            else if (key == "write_bytes:") write_bytes = value;
+            io_valid = true;
+        }
+        return io_valid;
+    }
+
+    static std::string format_bytes(unsigned long long bytes) {
+        static const char* units[] = {"B", "KiB", "MiB", "GiB", "TiB"};
+        double value = static_cast<double>(bytes);
+        int unit = 0;
+        while (value >= 1024.0 && unit < 4) {
+            value /= 1024.0;
+            ++unit;
+        }
+        char text[32];
+        std::snprintf(text, sizeof(text), unit ? "%.1f %s" : "%.0f %s", value, units[unit]);
+        return text;
+    }
+
+    /** @brief One-line summary shown under a run's output. */
+    std::string summary() const {
+        char text[320];
+        std::snprintf(text, sizeof(text),
+                      "wall %.3f s | user %.3f s | sys %.3f s | max RSS %s | faults %ld minor / %ld major | "
+                      "ctx switches %ld vol / %ld invol",
+                      wall_seconds, user_seconds, system_seconds, format_bytes(max_rss_kb * 1024ull).c_str(),
+                      minor_faults, major_faults, voluntary_switches, involuntary_switches);
+        std::string line = text;
+        if (io_valid) {
+            line += " | I/O read " + format_bytes(read_bytes) + " (" + format_bytes(read_chars) + " requested), write "
+                  + format_bytes(write_bytes) + " (" + format_bytes(write_chars) + " requested)";
+        }
+        if (cgroup_valid) {
+            line += " | cgroup: memory.max hit " + std::to_string(memory_max_events) + "x, "
+                  + std::to_string(oom_kills) + " OOM kills, throttled " + std::to_string(cpu_throttled_periods)
+                  + "/" + std::to_string(cpu_periods) + " periods";
+            if (memory_peak_bytes) line += ", peak " + format_bytes(memory_peak_bytes);
+        }
+        if (counters_valid || task_clock_valid) line += "\n" + counters_summary();
+        return line;
+    }
+
+    /** @brief IPC and miss rates, e.g. "IPC 1.82 | branch misses 0.9% | cache misses 4.1% of refs". */
+    std::string counters_summary() const {
+        char text[320];
+        if (!counters_valid) {
+            std::snprintf(text, sizeof(text), "task-clock %.1f ms (hardware counters unavailable)", task_clock_ns / 1e6);
+            return text;
+        }
+        std::snprintf(text, sizeof(text),
+                      "IPC %.2f (%.3g instructions / %.3g cycles) | branch misses %.2f%% of %.3g branches | "
+                      "cache misses %.2f%% of %.3g refs | task-clock %.1f ms%s%s",
+                      ipc(), instructions, cycles, branches > 0 ? 100.0 * branch_misses / branches : 0.0, branches,
+                      cache_references > 0 ? 100.0 * cache_misses / cache_references : 0.0, cache_references,
+                      task_clock_ns / 1e6, counters_user_only ? " | user space only" : "",
+                      counters_scaled ? " | multiplexed, scaled" : "");
+        return text;
+    }
+
+    JsonValue to_json_value() const {
+        JsonValue json = JsonValue::make_object()
+            .set("wall_s", wall_seconds)
+            .set("user_s", user_seconds)
+            .set("sys_s", system_seconds)
+            .set("max_rss_kb", max_rss_kb)
+            .set("minor_faults", minor_faults)
+            .set("major_faults", major_faults)
+            .set("voluntary_switches", voluntary_switches)
+            .set("involuntary_switches", involuntary_switches);
+        if (io_valid) {
+            json.set("read_chars", read_chars).set("write_chars", write_chars)
+                .set("read_bytes", read_bytes).set("write_bytes", write_bytes);
+        }
+        if (cgroup_valid) {
+            json.set("cgroup", JsonValue::make_object()
+                .set("memory_max_events", memory_max_events)
+                .set("oom_events", oom_events)
+                .set("oom_kills", oom_kills)
+                .set("memory_peak_bytes", memory_peak_bytes)
+                .set("cpu_periods", cpu_periods)
+                .set("cpu_throttled_periods", cpu_throttled_periods)
+                .set("cpu_throttled_s", cpu_throttled_seconds));
+        }
+        if (counters_valid || task_clock_valid) {
+            JsonValue counters = JsonValue::make_object().set("task_clock_ns", task_clock_ns);
+            if (counters_valid) {
+                counters.set("cycles", cycles)
+                    .set("instructions", instructions)
+                    .set("branches", branches)
+                    .set("branch_misses", branch_misses)
+                    .set("cache_references", cache_references)
+                    .set("cache_misses", cache_misses)
+                    .set("ipc", ipc());
+            }
+            json.set("counters", counters.set("user_only", counters_user_only).set("scaled", counters_scaled));
+        }
+        return json;
+    }
+
+    /** @brief Reads back what to_json_value() wrote; absent members stay at their defaults. */
+    static RunUsage from_json(const JsonValue& json) {
+        RunUsage usage;
+        usage.wall_seconds = json["wall_s"].as_number();
+        usage.user_seconds = json["user_s"].as_number();
+        usage.system_seconds = json["sys_s"].as_number();
+        usage.max_rss_kb = static_cast<long>(json["max_rss_kb"].as_number());
+        usage.minor_faults = static_cast<long>(json["minor_faults"].as_number());
+        usage.major_faults = static_cast<long>(json["major_faults"].as_number());
+        usage.voluntary_switches = static_cast<long>(json["voluntary_switches"].as_number());
+        usage.involuntary_switches = static_cast<long>(json["involuntary_switches"].as_number());
+        auto count = [](const JsonValue& value) { return static_cast<unsigned long long>(value.as_number()); };
+        usage.io_valid = !json["read_chars"].is_null();
+        usage.read_chars = count(json["read_chars"]);
+        usage.write_chars = count(json["write_chars"]);
+        usage.read_bytes = count(json["read_bytes"]);
+        usage.write_bytes = count(json["write_bytes"]);
+        const JsonValue& cgroup = json["cgroup"];
+        usage.cgroup_valid = cgroup.is_object();
+        usage.memory_max_events = count(cgroup["memory_max_events"]);
+        usage.oom_events = count(cgroup["oom_events"]);
+        usage.oom_kills = count(cgroup["oom_kills"]);
+        usage.memory_peak_bytes = count(cgroup["memory_peak_bytes"]);
+        usage.cpu_periods = count(cgroup["cpu_periods"]);
+        usage.cpu_throttled_periods = count(cgroup["cpu_throttled_periods"]);
+        usage.cpu_throttled_seconds = cgroup["cpu_throttled_s"].as_number();
+        const JsonValue& counters = json["counters"];
+        usage.task_clock_valid = counters.is_object();
+        usage.counters_valid = !counters["cycles"].is_null();
+        usage.task_clock_ns = counters["task_clock_ns"].as_number();
+        usage.cycles = counters["cycles"].as_number();
+        usage.instructions = counters["instructions"].as_number();
+        usage.branches = counters["branches"].as_number();
+        usage.branch_misses = counters["branch_misses"].as_number();
+        usage.cache_references = counters["cache_references"].as_number();
+        usage.cache_misses = counters["cache_misses"].as_number();
+        usage.counters_user_only = counters["user_only"].as_bool();
+        usage.counters_scaled = counters["scaled"].as_bool();
+        return usage;
+    }
+};
+
+/**
+ * @brief Hardware performance counters of a run, via perf_event_open(2).
+ * The hardware events form one group led by cycles, so the PMU schedules
+ * them together: when they are multiplexed all are scaled by the same
+ * factor and IPC and the miss ratios compare counts of the same intervals.
+ * task-clock is a software event and is opened on its own. Counters follow
+ * the run's children (inherit). When attached while the child is held
+ * before exec they start with enable_on_exec, so only the project is
+ * counted, not the launcher's spawn path.
+ */
+class PerfCounters {
+public:
+    PerfCounters() = default;
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+    ~PerfCounters() {
+        for (auto& counter : m_counters) ChildProcess::close_fd(counter.fd);
+    }
+
+    /**
+     * @brief Opens the counters on a process.
+     * Hardware events that the machine lacks (e.g. in a VM without a PMU)
+     * are left out of the group; if cycles is among them, the first event
+     * that opens leads the group instead.
+     * @param before_exec Whether the process is held before exec.
+     * @return False if no counter could be opened; error() says why.
+     */
+    bool attach(pid_t pid, bool before_exec) {
+        int paranoid = 2;
+        std::ifstream("/proc/sys/kernel/perf_event_paranoid") >> paranoid;
+        m_leader = -1;
+        for (auto& counter : m_counters) {
+            bool grouped = counter.type == PERF_TYPE_HARDWARE;
+            bool leads = !grouped || m_leader < 0;
+            struct perf_event_attr attr = {};
+            attr.size = sizeof(attr);
+            attr.type = counter.type;
+            attr.config = counter.config;
+            attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING
+                               | (grouped ? PERF_FORMAT_GROUP : 0);
+            attr.inherit = 1;
+            // Members follow their leader: they are enabled and disabled with it
+            attr.disabled = leads && before_exec;
+            attr.enable_on_exec = leads && before_exec;
+            attr.exclude_kernel = paranoid >= 2; // Unprivileged users may only count user space then
+            attr.exclude_hv = 1;
+            int group_fd = grouped && m_leader >= 0 ? m_counters[static_cast<size_t>(m_leader)].fd : -1;
+            counter.fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, pid, -1, group_fd, PERF_FLAG_FD_CLOEXEC));
+            if (counter.fd < 0 && (errno == EACCES || errno == EPERM)) {
+                m_error = "perf_event_open not permitted (kernel.perf_event_paranoid = " + std::to_string(paranoid) + ")";
+                break;
+            }
+            if (grouped && leads && counter.fd >= 0) m_leader = static_cast<int>(&counter - m_counters.data());
+        }
+        bool any = false;
+        for (const auto& counter : m_counters) any |= counter.fd >= 0;
+        if (!any && m_error.empty()) m_error = std::string("perf_event_open failed: ") + std::strerror(errno);
+        m_user_only = paranoid >= 2;
+        return any;
+    }
+
+    const std::string& error() const { return m_error; }
+
+    /** @brief Adds the counts to a run's usage; call once the run has exited. */
+    void read_into(RunUsage& usage) const {
+        // Multiplexed with other events: extrapolate to the whole run
+        auto scaled = [&usage](uint64_t value, uint64_t enabled, uint64_t running) {
+            if (running >= enabled) return static_cast<double>(value);
+            usage.counters_scaled = true;
+            return static_cast<double>(value) * static_cast<double>(enabled) / static_cast<double>(running);
+        };
+        for (const auto& counter : m_counters) {
+            if (counter.type == PERF_TYPE_HARDWARE) continue;
+            uint64_t values[3] = {}; // value, time enabled, time running
+            if (counter.fd < 0 || ::read(counter.fd, values, sizeof(values)) != static_cast<ssize_t>(sizeof(values))) continue;
+            if (values[2] == 0) continue; // Never scheduled
+            usage.*counter.field = scaled(values[0], values[1], values[2]);
+            usage.task_clock_valid = true;
+        }
+        usage.counters_user_only = m_user_only;
+        if (m_leader < 0) return;
+
+        // nr, time enabled, time running, then one value per member in the order they were opened
+        std::vector<uint64_t> group(3 + m_counters.size());
+        ssize_t n = ::read(m_counters[static_cast<size_t>(m_leader)].fd, group.data(), group.size() * sizeof(uint64_t));
+        if (n < static_cast<ssize_t>(3 * sizeof(uint64_t)) || group[2] == 0) return; // Never scheduled onto the PMU
+        size_t read_values = std::min<size_t>(group[0], static_cast<size_t>(n) / sizeof(uint64_t) - 3);
+        size_t next = 0;
+        for (const auto& counter : m_counters) {
+            if (counter.type != PERF_TYPE_HARDWARE || counter.fd < 0) continue;
+            if (next == read_values) break;
+            usage.*counter.field = scaled(group[3 + next++], group[1], group[2]);
+            usage.counters_valid = true;
+        }
+    }
+
+private:
+    struct Counter {
+        uint32_t type;
+        uint64_t config;
+        double RunUsage::*field;
+        int fd = -1;
+    };
+
+    std::vector<Counter> m_counters = {
+        {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_TASK_CLOCK, &RunUsage::task_clock_ns},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES, &RunUsage::cycles},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS, &RunUsage::instructions},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_INSTRUCTIONS, &RunUsage::branches},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES, &RunUsage::branch_misses},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_REFERENCES, &RunUsage::cache_references},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES, &RunUsage::cache_misses},
+    };
+    int m_leader = -1; // Index of the hardware group's leader, -1 if no hardware event opened
+    std::string m_error;
+    bool m_user_only = false;
+};
+
+// --- Sampling Profiler ---
+
+/**
+ * @brief Sampled call stacks in the folded format of flamegraph.pl: one line
+ * per distinct stack, frames root first and separated by ';', then the number
+ * of samples that had it.
+ */
+struct FoldedStacks {
+    std::map<std::string, unsigned long long> stacks;
+    unsigned long long lost = 0; // Samples the kernel dropped because its buffer was full
+
+    /** @brief Counts a stack; frames are root first. */
+    void add(const std::vector<std::string>& frames, unsigned long long count = 1) {
+        if (frames.empty()) return;
+        std::string key;
+        for (const auto& frame : frames) {
+            if (!key.empty()) key += ';';
+            std::string name = frame;
+            std::replace(name.begin(), name.end(), ';', ':'); // ';' separates frames
+            key += name;
+        }
+        stacks[key] += count;
+    }
+
+    unsigned long long total() const {
+        unsigned long long sum = 0;
+        for (const auto& [stack, count] : stacks) sum += count;
+        return sum;
+    }
+
+    std::string to_text() const {
+        std::string text;
+        for (const auto& [stack, count] : stacks) text += stack + " " + std::to_string(count) + "\n";
+        return text;
+    }
+};
+
+/**
+ * @brief Function symbols of one ELF file, for naming sampled addresses.
+ * Names come from `nm -C` (the dynamic symbol table if the file is stripped).
+ * Sampled addresses arrive as file offsets and are mapped to link-time
+ * addresses through the PT_LOAD program headers, which covers PIE, non-PIE
+ * executables and shared libraries alike.
+ */
+class SymbolTable {
+public:
+    explicit SymbolTable(const std::filesystem::path& file) {
+        read_segments(file);
+        load_symbols({"nm", "-C", "-n", "-S", "--defined-only", file.string()});
+        if (m_symbols.empty()) load_symbols({"nm", "-C", "-n", "-S", "-D", "--defined-only", file.string()});
+    }
+
+    /** @brief The function containing a file offset, or "" if it is not in one. */
+    std::string lookup(uint64_t file_offset) const {
+        uint64_t address = file_offset;
+        for (const auto& segment : m_segments) {
+            if (file_offset >= segment.offset && file_offset < segment.offset + segment.size) {
+                address = file_offset - segment.offset + segment.address;
+                break;
+            }
+        }
+        return name_at(address);
+    }
+
+    /** @brief The function containing a link-time address, or "" if it is not in one. */
+    std::string name_at(uint64_t address) const {
+        auto it = std::upper_bound(m_symbols.begin(), m_symbols.end(), address,
+                                   [](uint64_t value, const Symbol& symbol) { return value < symbol.address; });
+        if (it == m_symbols.begin()) return "";
+        --it;
+        // Without a size (e.g. hand-written assembly) the nearest preceding symbol is the best guess
+        if (it->size && address >= it->address + it->size) return "";
+        return it->name;
+    }
+
+private:
+    struct Segment {
+        uint64_t offset;
+        uint64_t address;
+        uint64_t size;
+    };
+    struct Symbol {
+        uint64_t address;
+        uint64_t size;
+        std::string name;
+    };
+
+    std::vector<Segment> m_segments;
+    std::vector<Symbol> m_symbols; // Sorted by address
+
+    void read_segments(const std::filesystem::path& file) {
+        std::ifstream in(file, std::ios::binary);
+        Elf64_Ehdr header;
+        if (!in.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+            std::memcmp(header.e_ident, ELFMAG, SELFMAG) != 0 || header.e_ident[EI_CLASS] != ELFCLASS64) {
+            return;
+        }
+        for (unsigned i = 0; i < header.e_phnum; ++i) {
+            Elf64_Phdr program;
+            in.seekg(static_cast<std::streamoff>(header.e_phoff + i * header.e_phentsize));
+            if (!in.read(reinterpret_cast<char*>(&program), sizeof(program))) break;
+            if (program.p_type == PT_LOAD) m_segments.push_back({program.p_offset, program.p_vaddr, program.p_filesz});
+        }
+    }
+
+    void load_symbols(const std::vector<std::string>& nm_command) {
+        ProcessResult result;
+        try {
+            result = run_process(nm_command);
+        } catch (const std::exception&) {
+            return; // binutils missing: frames stay unnamed
+        }
+        // "<address> [<size>] <type> <name>"; the size is missing for some symbols
+        std::istringstream in(result.output);
+        std::string line;
+        while (std::getline(in, line)) {
+            std::istringstream fields(line);
+            std::string address, second, type;
+            if (!(fields >> address >> second)) continue;
+            std::string size;
+            if (second.size() == 1) {
+                type = second;
+            } else {
+                size = second;
+                if (!(fields >> type) || type.size() != 1) continue;
+            }
+            if (std::string("TtWwi").find(type[0]) == std::string::npos) continue; // Not code
+            std::string name;
+            std::getline(fields >> std::ws, name);
+            name = name.substr(0, name.find('@')); // Symbol version, e.g. "@@GLIBCXX_3.4"
+            char* end = nullptr;
+            uint64_t value = std::strtoull(address.c_str(), &end, 16);
+            if (*end || name.empty()) continue;
+            m_symbols.push_back({value, size.empty() ? 0 : std::strtoull(size.c_str(), nullptr, 16), name});
+        }
+    }
+};
+
+/**
+ * @brief Samples a run's user-space call stacks with perf_event_open(2).
+ * A cpu-clock software event (so it also works without a PMU, e.g. in VMs)
+ * fires about kFrequency times per CPU-second in the run and its children and
+ * records the frame-pointer call chain into ring buffers that drain() empties.
+ * The kernel cannot map one buffer for an inherited per-task event, so as
+ * perf record does there is one event and buffer per CPU.
+ * Chains are only complete through code built with -fno-omit-frame-pointer.
+ * Like PerfCounters, sampling starts at exec when attached before it.
+ */
+class StackSampler {
+public:
+    StackSampler() = default;
+    StackSampler(const StackSampler&) = delete;
+    StackSampler& operator=(const StackSampler&) = delete;
+    ~StackSampler() {
+        for (auto& buffer : m_buffers) {
+            if (buffer.ring) munmap(buffer.ring, m_ring_size);
+            ChildProcess::close_fd(buffer.fd);
+        }
+    }
+
+    /**
+     * @brief Opens the sampling events on a process and maps their ring buffers.
+     * @param before_exec Whether the process is held before exec.
+     * @return False on failure; error() says why.
+     */
+    bool attach(pid_t pid, bool before_exec) {
+        int paranoid = 2;
+        std::ifstream("/proc/sys/kernel/perf_event_paranoid") >> paranoid;
+        struct perf_event_attr attr = {};
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_SOFTWARE;
+        attr.config = PERF_COUNT_SW_CPU_CLOCK;
+        attr.freq = 1;
+        attr.sample_freq = kFrequency;
+        attr.sample_type = PERF_SAMPLE_IP | PERF_SAMPLE_TID | PERF_SAMPLE_CALLCHAIN;
+        attr.mmap = 1; // Report executable mappings, to symbolise against
+        attr.inherit = 1;
+        attr.disabled = before_exec;
+        attr.enable_on_exec = before_exec;
+        attr.exclude_kernel = paranoid >= 2;
+        attr.exclude_callchain_kernel = 1;
+        attr.exclude_hv = 1;
+        m_ring_size = (1 + kDataPages) * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        long cpus = sysconf(_SC_NPROCESSORS_CONF);
+        for (int cpu = 0; cpu < cpus; ++cpu) {
+            int fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, pid, cpu, -1, PERF_FLAG_FD_CLOEXEC));
+            if (fd < 0) {
+                if (errno == ENODEV) continue; // Offline CPU
+                m_error = (errno == EACCES || errno == EPERM)
+                    ? "perf_event_open not permitted (kernel.perf_event_paranoid = " + std::to_string(paranoid) + ")"
+                    : std::string("perf_event_open failed: ") + std::strerror(errno);
+                break;
+            }
+            void* ring = mmap(nullptr, m_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            if (ring == MAP_FAILED) {
+                m_error = std::string("Could not map a sample buffer: ") + std::strerror(errno);
+                ChildProcess::close_fd(fd);
+                break;
+            }
+            m_buffers.push_back({fd, ring});
+        }
+        if (!m_error.empty()) return false;
+        // Already running its program: those mappings were made before the events existed
+        if (!before_exec) read_proc_maps(pid);
+        return true;
+    }
+
+    const std::string& error() const { return m_error; }
+
+    /** @brief Moves records out of the ring buffers; call often enough that they do not fill up. */
+    void drain() {
+        size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        std::vector<char> record;
+        for (auto& buffer : m_buffers) {
+            auto* meta = static_cast<struct perf_event_mmap_page*>(buffer.ring);
+            const char* data = static_cast<const char*>(buffer.ring) + (meta->data_offset ? meta->data_offset : page);
+            uint64_t size = meta->data_size ? meta->data_size : kDataPages * page;
+            uint64_t head = __atomic_load_n(&meta->data_head, __ATOMIC_ACQUIRE);
+            uint64_t tail = meta->data_tail;
+            while (tail + sizeof(struct perf_event_header) <= head) {
+                struct perf_event_header header;
+                copy_out(data, size, tail, &header, sizeof(header));
+                if (header.size < sizeof(header) || tail + header.size > head) break;
+                record.resize(header.size);
+                copy_out(data, size, tail, record.data(), header.size);
+                handle_record(header.type, record);
+                tail += header.size;
+            }
+            __atomic_store_n(&meta->data_tail, tail, __ATOMIC_RELEASE);
+        }
+    }
+
+    /**
+     * @brief Symbolises the samples and folds them; call once the run has exited.
+     * Frames outside any known function are named after their file, e.g. "[libc.so.6]".
+     */
+    FoldedStacks fold() {
+        drain();
+        FoldedStacks folded;
+        folded.lost = m_lost;
+        std::map<std::string, std::unique_ptr<SymbolTable>> tables;
+        for (const auto& [sample, count] : m_samples) {
+            const auto& [pid, chain] = sample;
+            std::vector<std::string> frames;
+            for (size_t i = chain.size(); i-- > 0;) {
+                // Callers' entries are return addresses; step back into the call instruction
+                frames.push_back(symbolise(pid, i == 0 ? chain[i] : chain[i] - 1, tables));
+            }
+            folded.add(frames, count);
+        }
+        return folded;
+    }
+
+private:
+    // Prime, so sampling does not run in lockstep with periodic work
+    static constexpr unsigned kFrequency = 997;
+    static constexpr size_t kDataPages = 32; // Per CPU; a power of two, as the kernel requires
+
+    struct Mapping {
+        pid_t pid;
+        uint64_t start;
+        uint64_t end;
+        uint64_t offset;
+        std::string file;
+    };
+
+    struct Buffer {
+        int fd;
+        void* ring;
+    };
+
+    std::vector<Buffer> m_buffers;
+    size_t m_ring_size = 0;
+    std::vector<Mapping> m_mappings;
+    // (pid, call chain leaf first) -> samples
+    std::map<std::pair<pid_t, std::vector<uint64_t>>, unsigned long long> m_samples;
+    unsigned long long m_lost = 0;
+    std::string m_error;
+
+    static void copy_out(const char* data, uint64_t size, uint64_t position, void* out, size_t length) {
+        size_t start = static_cast<size_t>(position % size);
+        size_t first = std::min(length, static_cast<size_t>(size) - start);
+        std::memcpy(out, data + start, first);
+        std::memcpy(static_cast<char*>(out) + first, data, length - first);
+    }
+
+    void handle_record(uint32_t type, const std::vector<char>& record) {
+        const char* body = record.data() + sizeof(struct perf_event_header);
+        size_t length = record.size() - sizeof(struct perf_event_header);
+        if (type == PERF_RECORD_SAMPLE && length >= 24) {
+            uint64_t ip, count;
+            uint32_t pid;
+            std::memcpy(&ip, body, 8);
+            std::memcpy(&pid, body + 8, 4);
+            std::memcpy(&count, body + 16, 8);
+            count = std::min<uint64_t>(count, (length - 24) / 8);
+            std::vector<uint64_t> chain;
+            for (uint64_t i = 0; i < count; ++i) {
+                uint64_t address;
+                std::memcpy(&address, body + 24 + i * 8, 8);
+                if (address < PERF_CONTEXT_MAX) chain.push_back(address); // Skip the context markers
+            }
+            if (chain.empty()) chain.push_back(ip);
+            ++m_samples[{static_cast<pid_t>(pid), chain}];
+        } else if (type == PERF_RECORD_MMAP && length > 32) {
+            Mapping mapping;
+            uint32_t pid;
+            uint64_t size;
+            std::memcpy(&pid, body, 4);
+            std::memcpy(&mapping.start, body + 8, 8);
+            std::memcpy(&size, body + 16, 8);
+            std::memcpy(&mapping.offset, body + 24, 8);
+            mapping.pid = static_cast<pid_t>(pid);
+            mapping.end = mapping.start + size;
+            mapping.file.assign(body + 32, strnlen(body + 32, length - 32));
+            m_mappings.push_back(mapping);
+        } else if (type == PERF_RECORD_LOST && length >= 16) {
+            uint64_t lost;
+            std::memcpy(&lost, body + 8, 8);
+            m_lost += lost;
+        }
+    }
+
+    void read_proc_maps(pid_t pid) {
+        std::ifstream in("/proc/" + std::to_string(pid) + "/maps");
+        std::string line;
+        while (std::getline(in, line)) {
+            // start-end perms offset dev inode [file]
+            std::istringstream fields(line);
+            std::string range, perms, offset, device, inode, file;
+            if (!(fields >> range >> perms >> offset >> device >> inode) || perms.find('x') == std::string::npos) continue;
+            std::getline(fields >> std::ws, file);
+            Mapping mapping;
+            mapping.pid = pid;
+            mapping.start = std::strtoull(range.c_str(), nullptr, 16);
+            mapping.end = std::strtoull(range.c_str() + range.find('-') + 1, nullptr, 16);
+            mapping.offset = std::strtoull(offset.c_str(), nullptr, 16);
+            mapping.file = file;
+            m_mappings.push_back(mapping);
+        }
+    }
+
+    std::string symbolise(pid_t pid, uint64_t address,
+                          std::map<std::string, std::unique_ptr<SymbolTable>>& tables) const {
+        // Forked children report no mappings of their own, so fall back to any process's
+        const Mapping* found = nullptr;
+        for (auto it = m_mappings.rbegin(); it != m_mappings.rend(); ++it) {
+            if (address < it->start || address >= it->end) continue;
+            if (it->pid == pid) {
+                found = &*it;
+                break;
+            }
+            if (!found) found = &*it;
+        }
+        if (!found) return "[unknown]";
+        if (found->file.empty() || found->file[0] != '/') return found->file.empty() ? "[anon]" : found->file;
+        auto& table = tables[found->file];
+        if (!table) table = std::make_unique<SymbolTable>(found->file);
+        std::string name = table->lookup(address - found->start + found->offset);
+        return name.empty() ? "[" + std::filesystem::path(found->file).filename().string() + "]" : name;
+    }
+};
+
+/**
+ * @brief Folds the output of `perf script`: per sample a header line, then one
+ * indented "address symbol+offset (file)" line per frame, leaf first.
+ */
+FoldedStacks parse_perf_script(const std::string& text) {
+    FoldedStacks folded;
+    std::vector<std::string> frames;
+    auto flush = [&]() {
+        folded.add(std::vector<std::string>(frames.rbegin(), frames.rend()));
+        frames.clear();
+    };
+    std::istringstream in(text);
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.empty() || !std::isspace(static_cast<unsigned char>(line[0]))) {
+            flush(); // Blank separator or the next sample's header
+            continue;
+        }
+        std::istringstream fields(line);
+        std::string address, frame;
+        fields >> address;
+        std::getline(fields >> std::ws, frame);
+        std::string file;
+        size_t paren = frame.rfind(" (");
+        if (paren != std::string::npos && frame.back() == ')') {
+            file = frame.substr(paren + 2, frame.size() - paren - 3);
+            frame.erase(paren);
+        }
+        size_t offset = frame.rfind("+0x");
+        if (offset != std::string::npos) frame.erase(offset);
+        if (frame.empty() || frame == "[unknown]") frame = "[" + std::filesystem::path(file).filename().string() + "]";
+        frames.push_back(frame);
+    }
+    flush();
+    return folded;
+}
+
+/**
+ * @brief `perf record` attached to a run by pid, so that the run itself, not
+ * perf, is the process the supervisor starts, limits and accounts.
+ * perf starts with its events disabled (-D -1) and is enabled through its
+ * control descriptors (perf 5.11+); start() returns once perf acknowledged,
+ * so a run held before exec is sampled from its first instruction.
+ */
+class PerfRecorder {
+public:
+    explicit PerfRecorder(std::filesystem::path output) : m_output(std::move(output)) {}
+
+    /**
+     * @brief Attaches perf to a process. Called from a before_exec hook, so it
+     * cannot go through the spawn helper, which is holding that process.
+     * @return False if perf could not attach within kStartTimeoutMs (e.g. not permitted).
+     */
+    bool start(pid_t pid) {
+        SpawnOptions options;
+        options.argv = {"perf", "record", "-F", "999", "-g", "-q", "-D", "-1", "--control", "fd:0,1",
+                        "-o", m_output.string(), "-p", std::to_string(pid)};
+        options.stdin_mode = StdioMode::Pipe;  // Control commands
+        options.stdout_mode = StdioMode::Pipe; // Their acknowledgements
+        options.stderr_mode = StdioMode::Null;
+        options.use_helper = false;
+        try {
+            m_perf = spawn_process(options);
+        } catch (const std::exception&) {
+            return false;
+        }
+        std::string ack;
+        if (write_fully(m_perf.stdin_fd, "enable\n", 7)) {
+            auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(kStartTimeoutMs);
+            struct pollfd ready = {m_perf.stdout_fd, POLLIN, 0};
+            while (ack.find('\n') == std::string::npos) {
+                auto left = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+                if (left.count() <= 0 || poll(&ready, 1, static_cast<int>(left.count())) <= 0) break;
+                char buffer[64];
+                ssize_t n = ::read(m_perf.stdout_fd, buffer, sizeof(buffer));
+                if (n < 0 && errno == EINTR) continue;
+                if (n <= 0) break; // perf exited
+                ack.append(buffer, static_cast<size_t>(n));
+            }
+        }
+        if (ack.rfind("ack\n", 0) != 0) {
+            m_perf = ChildProcess(); // Kills and reaps it
+            return false;
+        }
+        m_started = true;
+        return true;
+    }
+
+    bool started() const { return m_started; }
+
+    /**
+     * @brief Waits for perf to write out its samples and folds them with `perf script`.
+     * Call from a worker thread once the run has exited. Throws std::runtime_error.
+     */
+    FoldedStacks fold() {
+        // perf stops by itself when the process it follows exits; SIGINT covers its children outliving it
+        ::kill(m_perf.pid, SIGINT);
+        m_perf.wait();
+        ProcessResult result = run_process({"perf", "script", "-i", m_output.string()});
+        std::error_code ignored;
+        std::filesystem::remove(m_output, ignored);
+        if (!result.ok()) throw std::runtime_error("perf script: " + result.output);
+        return parse_perf_script(result.output);
+    }
+
+private:
+    static constexpr int kStartTimeoutMs = 3000;
+
+    std::filesystem::path m_output;
+    ChildProcess m_perf;
+    bool m_started = false;
+};
+
+/**
+ * @brief Folded stacks merged into a tree. A frame's width in a flame graph is
+ * its total; self counts samples where it was the leaf.
+ */
+struct FlameNode {
+    std::string name;
+    unsigned long long total = 0;
+    unsigned long long self = 0;
+    std::vector<FlameNode> children; // Sorted by name, as flame graphs order siblings
+
+    static FlameNode build(const FoldedStacks& folded) {
+        FlameNode root;
+        root.name = "all";
+        for (const auto& [stack, count] : folded.stacks) {
+            FlameNode* node = &root;
+            node->total += count;
+            for (size_t begin = 0; begin <= stack.size();) {
+                size_t end = std::min(stack.find(';', begin), stack.size());
+                node = &node->child(stack.substr(begin, end - begin));
+                node->total += count;
+                begin = end + 1;
+            }
+            node->self += count;
+        }
+        return root;
+    }
+
+    /** @brief Number of frame rows, this one included. */
+    size_t depth() const {
+        size_t deepest = 0;
+        for (const auto& child : children) deepest = std::max(deepest, child.depth());
+        return deepest + 1;
+    }
+
+private:
+    FlameNode& child(const std::string& frame) {
+        auto it = std::lower_bound(children.begin(), children.end(), frame,
+                                   [](const FlameNode& node, const std::string& name) { return node.name < name; });
+        if (it == children.end() || it->name != frame) {
+            it = children.insert(it, FlameNode());
+            it->name = frame;
+        }
+        return *it;
+    }
+};
+
+/** @brief 32-bit FNV-1a hash: cheap and stable across runs and builds, unlike std::hash. */
+uint32_t fnv1a(const std::string& text) {
+    uint32_t hash = 2166136261u;
+    for (unsigned char c : text) hash = (hash ^ c) * 16777619u;
+    return hash;
+}
+
+/** @brief Warm colour of a frame, derived from its name so it is the same in every graph. */
+void flame_color(const std::string& name, double& red, double& green, double& blue) {
+    uint32_t hash = fnv1a(name);
+    red = (205 + hash % 51) / 255.0;
+    green = ((hash >> 8) % 231) / 255.0;
+    blue = ((hash >> 16) % 56) / 255.0;
+}
+
+std::string xml_escape(const std::string& text) {
+    std::string out;
+    for (char c : text) {
+        switch (c) {
+            case '&': out += "&amp;"; break;
+            case '<': out += "&lt;"; break;
+            case '>': out += "&gt;"; break;
+            case '"': out += "&quot;"; break;
+            default: out += c;
+        }
+    }
+    return out;
+}
+
+/**
+ * @brief Renders folded stacks as a standalone SVG flame graph: root at the
+ * bottom, frame widths proportional to samples, details in hover titles.
+ */
+std::string flame_graph_svg(const FoldedStacks& folded, const std::string& title) {
+    constexpr double kWidth = 1200.0;
+    constexpr double kFrameHeight = 16.0;
+    constexpr double kTop = 36.0;
+    constexpr double kCharWidth = 7.0; // 12px monospace
+    FlameNode root = FlameNode::build(folded);
+    double height = kTop + root.depth() * kFrameHeight + 10.0;
+    char buffer[512];
+    std::snprintf(buffer, sizeof(buffer),
+                  "<?xml version=\"1.0\" standalone=\"no\"?>\n"
+                  "<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"%.0f\" height=\"%.0f\" viewBox=\"0 0 %.0f %.0f\" "
+                  "font-family=\"monospace\" font-size=\"12\">\n"
+                  "<rect width=\"100%%\" height=\"100%%\" fill=\"#f8f8f8\"/>\n"
+                  "<text x=\"%.0f\" y=\"22\" text-anchor=\"middle\" font-size=\"16\">",
+                  kWidth, height, kWidth, height, kWidth / 2);
+    std::string svg = buffer;
+    svg += xml_escape(title) + " (" + std::to_string(root.total) + " samples)</text>\n";
+    if (root.total == 0) return svg + "</svg>\n";
+
+    std::function<void(const FlameNode&, double, size_t)> emit = [&](const FlameNode& node, double x, size_t level) {
+        double width = kWidth * static_cast<double>(node.total) / static_cast<double>(root.total);
+        if (width < 0.1) return; // Too narrow to see; so are its children
+        double y = height - 10.0 - (level + 1) * kFrameHeight;
+        double red, green, blue;
+        flame_color(node.name, red, green, blue);
+        std::snprintf(buffer, sizeof(buffer), " (%llu samples, %.2f%%)", node.total,
+                      100.0 * static_cast<double>(node.total) / static_cast<double>(root.total));
+        svg += "<g><title>" + xml_escape(node.name) + buffer + "</title>";
+        std::snprintf(buffer, sizeof(buffer),
+                      "<rect x=\"%.1f\" y=\"%.1f\" width=\"%.1f\" height=\"%.1f\" fill=\"rgb(%d,%d,%d)\" rx=\"2\"/>",
+                      x, y, width, kFrameHeight - 1, static_cast<int>(red * 255), static_cast<int>(green * 255),
+                      static_cast<int>(blue * 255));
+        svg += buffer;
+        size_t fits = width > 6 ? static_cast<size_t>((width - 6) / kCharWidth) : 0;
+        if (fits >= 3) {
+            std::string label = node.name.size() <= fits ? node.name : node.name.substr(0, fits - 2) + "..";
+            std::snprintf(buffer, sizeof(buffer), "<text x=\"%.1f\" y=\"%.1f\">", x + 3, y + kFrameHeight - 4);
+            svg += buffer + xml_escape(label) + "</text>";
+        }
+        svg += "</g>\n";
+        for (const auto& child : node.children) {
+            emit(child, x, level + 1);
+            x += kWidth * static_cast<double>(child.total) / static_cast<double>(root.total);
+        }
+    };
+    emit(root, 0.0, 0);
+    return svg + "</svg>\n";
+}
+
+// --- Heap Profiling ---
+
+/**
+ * @brief Per-user cache directory of the launcher ($XDG_CACHE_HOME/boredaf or
+ * ~/.cache/boredaf), created on first use.
+ */
+std::filesystem::path cache_directory() {
+    const char* xdg = std::getenv("XDG_CACHE_HOME");
+    const char* home = std::getenv("HOME");
+    std::filesystem::path dir = xdg && *xdg ? std::filesystem::path(xdg)
+                              : home && *home ? std::filesystem::path(home) / ".cache"
+                              : std::filesystem::temp_directory_path();
+    dir /= "boredaf";
+    std::error_code ignored;
+    std::filesystem::create_directories(dir, ignored);
+    return dir;
+}
+
+/**
+ * @brief Source of the allocation interposer preloaded into heap-profiled runs.
+ * It wraps the malloc family around glibc's __libc_* entry points, so there
+ * is no dlsym() bootstrapping; operator new and delete reach it through
+ * libstdc++. Every allocation is counted; about one per BOREDAF_HEAP_SAMPLE
+ * bytes allocated records a backtrace. Lines go to the pipe named by
+ * BOREDAF_HEAP_PIPE (see HeapProfiler for the format) and are dropped,
+ * not waited for, when it is full.
+ */
+const char* const kHeapInterposerSource = R"heap(
+#include <dlfcn.h>
+#include <execinfo.h>
+#include <fcntl.h>
+#include <link.h>
+#include <malloc.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+extern "C" {
+void* __libc_malloc(size_t);
+void* __libc_calloc(size_t, size_t);
+void* __libc_realloc(void*, size_t);
+void* __libc_memalign(size_t, size_t);
+void __libc_free(void*);
+}
+
+namespace {
+const int kMaxFrames = 48;
+const int kMaxObjects = 256;
+
+int g_fd = -1;
+unsigned long long g_interval = 512 * 1024;
+unsigned long long g_allocations, g_frees, g_bytes, g_dropped;
+long long g_live, g_peak;
+char g_executable[1024];
+struct link_map* g_self;
+struct link_map* g_objects[kMaxObjects]; // Announced with an "O" line; the index is the id
+int g_object_count;
+bool g_lock;
+__thread int t_busy;
+__thread unsigned long long t_bytes; // Allocated since this thread's last sample
+
+bool emit(const char* line, int length) {
+    if (length <= 0 || write(g_fd, line, static_cast<size_t>(length)) != length) {
+        __atomic_add_fetch(&g_dropped, 1, __ATOMIC_RELAXED);
+        return false;
+    }
+    return true;
+}
+
+void report_totals() {
+    if (g_fd < 0) return;
+    char line[256];
+    emit(line, snprintf(line, sizeof(line), "T %d %llu %llu %llu %lld %lld %llu\n", getpid(),
+                        __atomic_load_n(&g_allocations, __ATOMIC_RELAXED), __atomic_load_n(&g_frees, __ATOMIC_RELAXED),
+                        __atomic_load_n(&g_bytes, __ATOMIC_RELAXED), __atomic_load_n(&g_live, __ATOMIC_RELAXED),
+                        __atomic_load_n(&g_peak, __ATOMIC_RELAXED), __atomic_load_n(&g_dropped, __ATOMIC_RELAXED)));
+}
+
+// Id of a loaded object, announcing it first. -1 if the table is full, -2 if the
+// announcement was dropped: it is retried with the next sample that needs it.
+int object_id(struct link_map* map) {
+    for (int i = 0; i < g_object_count; ++i) {
+        if (g_objects[i] == map) return i;
+    }
+    if (g_object_count == kMaxObjects) return -1;
+    char line[1200];
+    const char* path = map->l_name && map->l_name[0] ? map->l_name : g_executable;
+    if (!emit(line, snprintf(line, sizeof(line), "O %d %d %s\n", getpid(), g_object_count, path))) return -2;
+    g_objects[g_object_count] = map;
+    return g_object_count++;
+}
+
+void sample(size_t size, unsigned long long weight) {
+    t_busy = 1; // backtrace() may allocate, e.g. when it loads libgcc_s
+    void* frames[kMaxFrames];
+    int count = backtrace(frames, kMaxFrames);
+    // Resolved before taking g_lock: dladdr1() takes the loader lock, whose holder may be
+    // allocating (dlopen) and so waiting for g_lock
+    struct link_map* maps[kMaxFrames];
+    for (int i = 0; i < count; ++i) {
+        Dl_info info;
+        maps[i] = nullptr;
+        if (!dladdr1(frames[i], &info, reinterpret_cast<void**>(&maps[i]), RTLD_DL_LINKMAP) || maps[i] == g_self) {
+            maps[i] = nullptr;
+        }
+    }
+    // Never wait for another thread's sample, e.g. one interrupted by a signal handler that allocates
+    if (__atomic_test_and_set(&g_lock, __ATOMIC_ACQUIRE)) {
+        __atomic_add_fetch(&g_dropped, 1, __ATOMIC_RELAXED);
+        t_busy = 0;
+        return;
+    }
+    char line[4000];
+    int length = snprintf(line, sizeof(line), "S %d %zu %llu", getpid(), size, weight);
+    bool complete = true;
+    for (int i = 0; i < count && length < static_cast<int>(sizeof(line)) - 48; ++i) {
+        if (!maps[i]) continue;
+        int id = object_id(maps[i]);
+        if (id == -2) {
+            complete = false; // Its frames would refer to an object the launcher never heard of
+            break;
+        }
+        if (id < 0) continue;
+        // Link-time address: the load bias is 0 for non-PIE executables
+        length += snprintf(line + length, sizeof(line) - length, " %d:%lx", id,
+                           static_cast<unsigned long>(reinterpret_cast<uintptr_t>(frames[i]) - maps[i]->l_addr));
+    }
+    line[length++] = '\n';
+    if (complete) emit(line, length);
+    __atomic_clear(&g_lock, __ATOMIC_RELEASE);
+    report_totals();
+    t_busy = 0;
+}
+
+void on_alloc(void* pointer, size_t size) {
+    if (!pointer) return;
+    __atomic_add_fetch(&g_allocations, 1, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&g_bytes, size, __ATOMIC_RELAXED);
+    long long live = __atomic_add_fetch(&g_live, static_cast<long long>(malloc_usable_size(pointer)), __ATOMIC_RELAXED);
+    long long peak = __atomic_load_n(&g_peak, __ATOMIC_RELAXED);
+    while (live > peak && !__atomic_compare_exchange_n(&g_peak, &peak, live, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {}
+    if (g_fd < 0 || t_busy) return;
+    t_bytes += size;
+    if (t_bytes < g_interval) return;
+    unsigned long long weight = t_bytes / g_interval; // Intervals this sample stands for
+    t_bytes %= g_interval;
+    sample(size, weight);
+}
+
+void on_free(void* pointer) {
+    if (!pointer) return;
+    __atomic_add_fetch(&g_frees, 1, __ATOMIC_RELAXED);
+    __atomic_sub_fetch(&g_live, static_cast<long long>(malloc_usable_size(pointer)), __ATOMIC_RELAXED);
+}
+
+void after_fork() {
+    // The child reports under its own pid, from scratch
+    g_object_count = 0;
+    g_allocations = g_frees = g_bytes = g_dropped = 0;
+    g_live = g_peak = 0;
+    g_lock = false;
+}
+
+__attribute__((constructor)) void start() {
+    t_busy = 1;
+    Dl_info info;
+    dladdr1(reinterpret_cast<void*>(&start), &info, reinterpret_cast<void**>(&g_self), RTLD_DL_LINKMAP);
+    ssize_t length = readlink("/proc/self/exe", g_executable, sizeof(g_executable) - 1);
+    g_executable[length > 0 ? length : 0] = '\0';
+    if (const char* interval = getenv("BOREDAF_HEAP_SAMPLE")) {
+        unsigned long long value = strtoull(interval, nullptr, 10);
+        if (value) g_interval = value;
+    }
+    void* frames[2];
+    backtrace(frames, 2); // Loads the unwinder now rather than inside the first sample
+    pthread_atfork(nullptr, nullptr, after_fork);
+    if (const char* path = getenv("BOREDAF_HEAP_PIPE")) g_fd = open(path, O_WRONLY | O_NONBLOCK | O_CLOEXEC);
+    t_busy = 0;
+}
+
+__attribute__((destructor)) void finish() {
+    report_totals();
+}
+}
+
+extern "C" {
+void* malloc(size_t size) {
+    void* pointer = __libc_malloc(size);
+    on_alloc(pointer, size);
+    return pointer;
+}
+
+void free(void* pointer) {
+    on_free(pointer);
+    __libc_free(pointer);
+}
+
+void* calloc(size_t count, size_t size) {
+    void* pointer = __libc_calloc(count, size);
+    on_alloc(pointer, count * size);
+    return pointer;
+}
+
+void* realloc(void* old, size_t size) {
+    size_t old_size = old ? malloc_usable_size(old) : 0;
+    void* pointer = __libc_realloc(old, size);
+    if (old && (pointer || size == 0)) {
+        __atomic_add_fetch(&g_frees, 1, __ATOMIC_RELAXED);
+        __atomic_sub_fetch(&g_live, static_cast<long long>(old_size), __ATOMIC_RELAXED);
+    }
+    on_alloc(pointer, size);
+    return pointer;
+}
+
+void* memalign(size_t alignment, size_t size) {
+    void* pointer = __libc_memalign(alignment, size);
+    on_alloc(pointer, size);
+    return pointer;
+}
+
+void* aligned_alloc(size_t alignment, size_t size) {
+    return memalign(alignment, size);
+}
+
+int posix_memalign(void** result, size_t alignment, size_t size) {
+    if (alignment % sizeof(void*) || (alignment & (alignment - 1))) return 22; // EINVAL
+    void* pointer = memalign(alignment, size);
+    if (!pointer) return 12; // ENOMEM
+    *result = pointer;
+    return 0;
+}
+
+void* valloc(size_t size) {
+    return memalign(static_cast<size_t>(sysconf(_SC_PAGESIZE)), size);
+}
+}
+)heap";
+
+/**
+ * @brief Builds the heap interposer, or reuses an earlier build of the same source.
+ * @return The shared library; throws std::runtime_error if it does not compile.
+ */
+std::filesystem::path heap_interposer_library() {
+    char name[64]; // Named after the source, so an edited source gets a new file
+    std::snprintf(name, sizeof(name), "heap-interposer-%08x", fnv1a(kHeapInterposerSource));
+    std::filesystem::path library = cache_directory() / (std::string(name) + ".so");
+    if (std::filesystem::exists(library)) return library;
+
+    std::filesystem::path source = cache_directory() / (std::string(name) + ".cpp");
+    std::filesystem::path partial = library.string() + "." + std::to_string(getpid());
+    if (!write_text_file(source, kHeapInterposerSource)) throw std::runtime_error("Could not write " + source.string());
+    ProcessResult result = run_process({default_compiler(), "-shared", "-fPIC", "-O2", "-fno-exceptions", "-o", partial.string(),
+                                        source.string(), "-ldl", "-pthread"});
+    if (!result.ok()) throw std::runtime_error("Could not build the heap interposer:\n" + result.output);
+    std::filesystem::rename(partial, library); // Atomic, in case two launchers build at once
+    return library;
+}
+
+/**
+ * @brief The heap interposer build, run once on its own thread. main() starts
+ * it at startup, so compiling never holds up the GTK thread.
+ */
+std::shared_future<std::filesystem::path> heap_interposer_build() {
+    static std::shared_future<std::filesystem::path> build = std::async(std::launch::async, heap_interposer_library).share();
+    return build;
+}
+
+/**
+ * @brief The heap interposer, if its background build has finished.
+ * @return The shared library; throws std::runtime_error if it is still being built or does not compile.
+ */
+std::filesystem::path ready_heap_interposer() {
+    std::shared_future<std::filesystem::path> build = heap_interposer_build();
+    if (build.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+        throw std::runtime_error("the allocation interposer is still being compiled; try again in a moment");
+    }
+    return build.get();
+}
+
+/**
+ * @brief Allocation profile of one run.
+ */
+struct HeapReport {
+    struct Site {
+        std::vector<std::string> stack;  // Leaf first; the allocator's own frames included
+        std::string call_site;           // Innermost frame outside shared libraries
+        unsigned long long samples = 0;
+        unsigned long long estimated_bytes = 0; // Sample weight x interval
+    };
+
+    unsigned long long allocations = 0;
+    unsigned long long frees = 0;
+    unsigned long long bytes = 0;        // Requested, over the whole run
+    long long peak_live_bytes = 0;       // Summed over processes, so an upper bound when there were several
+    long long live_bytes = 0;            // Still allocated at the last report (at exit, unless killed)
+    unsigned long long dropped = 0;      // Reports lost to a full pipe
+    unsigned long long sample_interval = 0;
+    size_t processes = 0;
+    std::vector<Site> sites;             // Largest estimated bytes first
+
+    std::string summary() const {
+        std::string text = std::to_string(allocations) + " allocations (" + RunUsage::format_bytes(bytes)
+                         + "), " + std::to_string(frees) + " frees, peak live heap "
+                         + RunUsage::format_bytes(static_cast<unsigned long long>(std::max(peak_live_bytes, 0LL)))
+                         + ", " + RunUsage::format_bytes(static_cast<unsigned long long>(std::max(live_bytes, 0LL)))
+                         + " live at exit";
+        if (processes > 1) text += ", " + std::to_string(processes) + " processes";
+        if (dropped) text += ", " + std::to_string(dropped) + " reports dropped";
+        return text;
+    }
+
+    JsonValue to_json_value() const {
+        JsonValue json_sites = JsonValue::make_array();
+        for (const auto& site : sites) {
+            JsonValue stack = JsonValue::make_array();
+            for (const auto& frame : site.stack) stack.push(frame);
+            json_sites.push(JsonValue::make_object()
+                .set("call_site", site.call_site)
+                .set("samples", site.samples)
+                .set("estimated_bytes", site.estimated_bytes)
+                .set("stack", stack));
+        }
+        return JsonValue::make_object()
+            .set("allocations", allocations)
+            .set("frees", frees)
+            .set("bytes", bytes)
+            .set("peak_live_bytes", peak_live_bytes)
+            .set("live_bytes", live_bytes)
+            .set("dropped_reports", dropped)
+            .set("sample_interval", sample_interval)
+            .set("processes", processes)
+            .set("sites", json_sites);
+    }
+};
+
+/**
+ * @brief Profiles a run's heap with the preloaded interposer.
+ * The interposer writes text lines to a FIFO that this object reads:
+ *   O <pid> <id> <path>                  a loaded object, announced before its first use
+ *   S <pid> <size> <weight> <id>:<addr>...  a sampled allocation, leaf frame first
+ *   T <pid> <allocs> <frees> <bytes> <live> <peak> <dropped>  running totals
+ * A FIFO rather than an inherited descriptor reaches every process of the
+ * run, including ones it execs. The launcher keeps a write end open, so the
+ * read end never reports EOF between writers.
+ */
+class HeapProfiler {
+public:
+    static constexpr unsigned long long kSampleInterval = 512 * 1024;
+
+    /** @brief Takes the interposer built at startup and creates the FIFO; throws std::runtime_error. */
+    HeapProfiler() : m_library(ready_heap_interposer()) {
+        static int serial = 0;
+        m_fifo = std::filesystem::temp_directory_path()
+               / ("boredaf-heap-" + std::to_string(getpid()) + "-" + std::to_string(++serial));
+        if (mkfifo(m_fifo.c_str(), 0600) != 0) {
+            throw std::runtime_error("Could not create " + m_fifo.string() + ": " + std::strerror(errno));
+        }
+        m_read_fd = open(m_fifo.c_str(), O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+        m_write_fd = open(m_fifo.c_str(), O_WRONLY | O_NONBLOCK | O_CLOEXEC);
+        if (m_read_fd < 0 || m_write_fd < 0) {
+            std::string error = std::strerror(errno);
+            release();
+            throw std::runtime_error("Could not open " + m_fifo.string() + ": " + error);
+        }
+        fcntl(m_read_fd, F_SETPIPE_SZ, 1 << 20); // Best effort: fewer drops between reads
+    }
+    HeapProfiler(const HeapProfiler&) = delete;
+    HeapProfiler& operator=(const HeapProfiler&) = delete;
+    ~HeapProfiler() { release(); }
+
+    /** @brief Preloads the interposer into the run. */
+    void prepare(SpawnOptions& options) const {
+        std::string preload = m_library.string();
+        if (const char* existing = std::getenv("LD_PRELOAD")) {
+            if (*existing) preload += std::string(":") + existing;
+        }
+        options.env.push_back("LD_PRELOAD=" + preload);
+        options.env.push_back("BOREDAF_HEAP_PIPE=" + m_fifo.string());
+        options.env.push_back("BOREDAF_HEAP_SAMPLE=" + std::to_string(kSampleInterval));
+    }
+
+    /** @brief The FIFO's read end, to watch for input. */
+    int fd() const { return m_read_fd; }
+
+    /** @brief Reads and parses whatever the run has reported so far. */
+    void drain() {
+        char buffer[65536];
+        ssize_t n;
+        while ((n = ::read(m_read_fd, buffer, sizeof(buffer))) > 0 || (n < 0 && errno == EINTR)) {
+            if (n < 0) continue;
+            m_pending.append(buffer, static_cast<size_t>(n));
+            size_t start = 0;
+            for (size_t end; (end = m_pending.find('\n', start)) != std::string::npos; start = end + 1) {
+                parse_line(m_pending.substr(start, end - start));
+            }
+            m_pending.erase(0, start);
+        }
+    }
+
+    /**
+     * @brief Symbolises the sampled stacks; call once the run has exited.
+     * @param max_sites How many call sites to keep, largest first.
+     */
+    HeapReport report(size_t max_sites = 200) {
+        drain();
+        HeapReport report;
+        report.sample_interval = kSampleInterval;
+        report.processes = m_totals.size();
+        for (const auto& [pid, totals] : m_totals) {
+            report.allocations += totals.allocations;
+            report.frees += totals.frees;
+            report.bytes += totals.bytes;
+            report.live_bytes += std::max(totals.live, 0LL); // Negative in a child that freed its parent's memory
+            report.peak_live_bytes += totals.peak;
+            report.dropped += totals.dropped;
+        }
+        std::map<std::string, std::unique_ptr<SymbolTable>> tables;
+        std::map<std::vector<std::string>, HeapReport::Site> merged; // Different addresses, same functions
+        for (const auto& [frames, counts] : m_samples) {
+            std::vector<std::string> stack;
+            std::string call_site;
+            for (const auto& [file, address] : frames) {
+                auto& table = tables[file];
+                if (!table) table = std::make_unique<SymbolTable>(file);
+                // Return addresses: step back into the call instruction
+                std::string name = table->name_at(address - 1);
+                std::string base = std::filesystem::path(file).filename().string();
+                if (name.empty()) name = "[" + base + "]";
+                if (call_site.empty() && base.find(".so") == std::string::npos) call_site = name;
+                stack.push_back(name);
+            }
+            HeapReport::Site& site = merged[stack];
+            site.stack = stack;
+            site.call_site = call_site.empty() ? (stack.empty() ? "[unknown]" : stack.front()) : call_site;
+            site.samples += counts.first;
+            site.estimated_bytes += counts.second * kSampleInterval;
+        }
+        for (auto& [stack, site] : merged) report.sites.push_back(std::move(site));
+        std::sort(report.sites.begin(), report.sites.end(), [](const HeapReport::Site& a, const HeapReport::Site& b) {
+            return a.estimated_bytes > b.estimated_bytes;
+        });
+        if (report.sites.size() > max_sites) report.sites.resize(max_sites);
+        return report;
+    }
+
+private:
+    struct Totals {
+        unsigned long long allocations = 0;
+        unsigned long long frees = 0;
+        unsigned long long bytes = 0;
+        long long live = 0;
+        long long peak = 0;
+        unsigned long long dropped = 0;
+    };
+
+    std::filesystem::path m_library;
+    std::filesystem::path m_fifo;
+    int m_read_fd = -1;
+    int m_write_fd = -1;
+    std::string m_pending; // Incomplete last line
+    std::map<std::pair<long, int>, std::string> m_objects; // (pid, id) -> path
+    // Stack of (file, link-time address), leaf first -> (samples, summed weight)
+    std::map<std::vector<std::pair<std::string, uint64_t>>, std::pair<unsigned long long, unsigned long long>> m_samples;
+    std::map<long, Totals> m_totals; // Latest "T" line per pid
+
+    void release() {
+        ChildProcess::close_fd(m_read_fd);
+        ChildProcess::close_fd(m_write_fd);
+        std::error_code ignored;
+        std::filesystem::remove(m_fifo, ignored);
+    }
+
+    void parse_line(const std::string& line) {
+        std::istringstream fields(line);
+        char kind;
+        long pid;
+        if (!(fields >> kind >> pid)) return;
+        if (kind == 'O') {
+            int id;
+            std::string path;
+            if (fields >> id && std::getline(fields >> std::ws, path)) m_objects[{pid, id}] = path;
+        } else if (kind == 'S') {
+            unsigned long long size, weight;
+            if (!(fields >> size >> weight)) return;
+            std::vector<std::pair<std::string, uint64_t>> frames;
+            std::string frame;
+            while (fields >> frame) {
+                size_t colon = frame.find(':');
+                if (colon == std::string::npos) continue;
+                auto object = m_objects.find({pid, std::atoi(frame.c_str())});
+                if (object == m_objects.end()) continue;
+                frames.push_back({object->second, std::strtoull(frame.c_str() + colon + 1, nullptr, 16)});
+            }
+            auto& counts = m_samples[frames];
+            counts.first += 1;
+            counts.second += weight;
+        } else if (kind == 'T') {
+            Totals totals;
+            if (fields >> totals.allocations >> totals.frees >> totals.bytes >> totals.live >> totals.peak >> totals.dropped) {
+                m_totals[pid] = totals;
+            }
+        }
+    }
+};
+
+// --- cgroup v2 Envelopes ---
+
+/**
+ * @brief Finds the cgroup v2 directory that per-run cgroups are created under.
+ * BOREDAF_CGROUP_ROOT overrides; otherwise the launcher's own cgroup is used,
+ * which is writable when it was started with e.g.
+ * `systemd-run --user --scope -p Delegate=yes`. The cpu and memory controllers
+ * are enabled for its children. cgroup v2 does not allow that while the cgroup
+ * itself holds processes, so the launcher's processes would have to move into a
+ * "launcher" leaf first; that changes where the launcher itself is accounted and
+ * is only done when BOREDAF_CGROUP_MOVE_LAUNCHER=1 is set.
+ * @return The directory, or an empty path if no delegated subtree is available. Cached.
+ */
+const std::filesystem::path& cgroup_delegation_root() {
+    static bool probed = false;
+    static std::filesystem::path root;
+    if (probed) return root;
+    probed = true;
+
+    std::filesystem::path candidate;
+    bool own_cgroup = false;
+    if (const char* env = std::getenv("BOREDAF_CGROUP_ROOT"); env && *env) {
+        candidate = env;
+    } else {
+        std::ifstream in("/proc/self/cgroup");
+        std::string line;
+        while (std::getline(in, line)) {
+            if (line.rfind("0::", 0) == 0) candidate = "/sys/fs/cgroup" + line.substr(3);
+        }
+        own_cgroup = true;
+    }
+    if (candidate.empty() || access((candidate / "cgroup.subtree_control").c_str(), W_OK) != 0) return root;
+
+    auto controllers_enabled = [&candidate]() {
+        std::istringstream enabled(read_text_file(candidate / "cgroup.subtree_control"));
+        bool cpu = false, memory = false;
+        std::string name;
+        while (enabled >> name) {
+            cpu |= name == "cpu";
+            memory |= name == "memory";
+        }
+        return cpu && memory;
+    };
+    if (!controllers_enabled()) {
+        if (own_cgroup) {
+            const char* move = std::getenv("BOREDAF_CGROUP_MOVE_LAUNCHER");
+            if (!move || std::string(move) != "1") return root;
+            std::filesystem::path leaf = candidate / "launcher";
+            std::cerr << "Moving the launcher's processes into " << leaf << " to enable cgroup controllers for runs"
+                      << std::endl;
+            std::error_code ec;
+            std::filesystem::create_directory(leaf, ec);
+            std::istringstream pids(read_text_file(candidate / "cgroup.procs"));
+            std::string pid;
+            while (pids >> pid) write_cgroup_file(leaf / "cgroup.procs", pid);
+        }
+        write_cgroup_file(candidate / "cgroup.subtree_control", "+cpu +memory");
+        if (!controllers_enabled()) return root;
+    }
+    root = candidate;
+    return root;
+}
+
+/**
+ * @brief A cgroup for one run, capped through cpu.max and memory.max.
+ * Anything still inside it is killed, and the directory removed, on destruction.
+ */
+class RunCgroup {
+public:
+    /**
+     * @brief Creates a cgroup under the delegation root.
+     * @param cpus CPU bandwidth in CPUs (0 = unlimited).
+     * @param memory_mb memory.max in MiB (0 = unlimited); swap is disabled alongside it.
+     * Throws std::runtime_error if the cgroup cannot be created or configured.
+     */
+    RunCgroup(const std::filesystem::path& root, double cpus, unsigned memory_mb) {
+        static unsigned counter = 0;
+        m_path = root / ("run-" + std::to_string(getpid()) + "-" + std::to_string(++counter));
+        if (mkdir(m_path.c_str(), 0755) != 0) {
+            throw std::runtime_error("Could not create cgroup " + m_path.string() + ": " + std::strerror(errno));
+        }
+        try {
+            if (cpus > 0) {
+                long long quota = std::max(1000LL, std::llround(cpus * kCpuPeriodUs));
+                set("cpu.max", std::to_string(quota) + " " + std::to_string(kCpuPeriodUs));
+            }
+            if (memory_mb) {
+                set("memory.max", std::to_string(static_cast<unsigned long long>(memory_mb) << 20));
+                write_cgroup_file(m_path / "memory.swap.max", "0"); // Absent without swap accounting
+            }
+        } catch (...) {
+            rmdir(m_path.c_str());
+            throw;
+        }
+    }
+    RunCgroup(const RunCgroup&) = delete;
+    RunCgroup& operator=(const RunCgroup&) = delete;
+    ~RunCgroup() {
+        write_cgroup_file(m_path / "cgroup.kill", "1");
+        if (rmdir(m_path.c_str()) == 0 || errno != EBUSY) return;
+        // Killed members take a moment to leave; rmdir fails with EBUSY until they have.
+        // Retry from the main loop rather than sleeping in the destructor.
+        auto attempts = std::make_shared<int>(0);
+        Glib::signal_timeout().connect([path = m_path, attempts]() {
+            return rmdir(path.c_str()) != 0 && errno == EBUSY && ++*attempts < kRemoveAttempts;
+        }, kRemoveRetryMs);
+    }
+
+    const std::filesystem::path& path() const { return m_path; }
+
+    /** @brief Adds the memory.events and cpu.stat counters to a run's usage. */
+    void read_events(RunUsage& usage) const {
+        std::istringstream memory_events(read_text_file(m_path / "memory.events"));
+        std::istringstream cpu_stat(read_text_file(m_path / "cpu.stat"));
+        std::string key;
+        unsigned long long value;
+        while (memory_events >> key >> value) {
+            if (key == "max") usage.memory_max_events = value;
+            else if (key == "oom") usage.oom_events = value;
+            else if (key == "oom_kill") usage.oom_kills = value;
+            usage.cgroup_valid = true;
+        }
+        while (cpu_stat >> key >> value) {
+            if (key == "nr_periods") usage.cpu_periods = value;
+            else if (key == "nr_throttled") usage.cpu_throttled_periods = value;
+            else if (key == "throttled_usec") usage.cpu_throttled_seconds = value / 1e6;
+        }
+        std::string peak = read_text_file(m_path / "memory.peak"); // Linux 5.19+
+        if (!peak.empty()) usage.memory_peak_bytes = std::strtoull(peak.c_str(), nullptr, 10);
+    }
+
+private:
+    static constexpr long long kCpuPeriodUs = 100000;
+    static constexpr unsigned kRemoveRetryMs = 10;
+    static constexpr int kRemoveAttempts = 100;
+
+    std::filesystem::path m_path;
+
+    void set(const std::string& file, const std::string& value) {
+        if (!write_cgroup_file(m_path / file, value)) {
+            throw std::runtime_error("Could not set " + file + " to " + value + ": " + std::strerror(errno));
+        }
+    }
+};
+
+/**
+ * @brief One finished run, as kept in the run history.
+ */
+struct RunHistoryEntry {
+    std::string project;
+    std::chrono::system_clock::time_point started;
+    int exit_code = -1;
+    std::string reason;   // Why the supervisor ended it, if it did
+    std::string envelope; // The limits it ran under, as applied
+    RunUsage usage;
+    std::string commit;        // HEAD of the project's checkout, if it is one
+    std::string configuration; // Compiler, flags and arguments; only runs with the same one are compared
+    bool instrumented = false; // Sampled or heap-profiled, so its timings are not comparable
+
+    JsonValue to_json_value() const {
+        return JsonValue::make_object()
+            .set("type", "run")
+            .set("project", project)
+            .set("started", static_cast<long long>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                                started.time_since_epoch()).count()))
+            .set("commit", commit)
+            .set("configuration", configuration)
+            .set("instrumented", instrumented)
+            .set("exit_code", exit_code)
+            .set("reason", reason)
+            .set("envelope", envelope)
+            .set("usage", usage.to_json_value());
+    }
+
+    static RunHistoryEntry from_json(const JsonValue& json) {
+        RunHistoryEntry entry;
+        entry.project = json["project"].as_string();
+        entry.started = std::chrono::system_clock::time_point(
+            std::chrono::milliseconds(static_cast<long long>(json["started"].as_number())));
+        entry.commit = json["commit"].as_string();
+        entry.configuration = json["configuration"].as_string();
+        entry.instrumented = json["instrumented"].as_bool();
+        entry.exit_code = static_cast<int>(json["exit_code"].as_number(-1));
+        entry.reason = json["reason"].as_string();
+        entry.envelope = json["envelope"].as_string();
+        entry.usage = RunUsage::from_json(json["usage"]);
+        return entry;
+    }
+};
+
+// --- Benchmarking ---
+
+/** @brief A set of compile flags benchmark builds can use. */
+struct BuildProfile {
+    std::string name;
+    std::vector<std::string> flags;
+};
+
+/** @brief The profiles offered for benchmark builds. */
+const std::vector<BuildProfile>& build_profiles() {
+    static const std::vector<BuildProfile> profiles = {
+        {"Debug", {"-O0", "-g"}},
+        {"Release", {"-O2", "-DNDEBUG"}},
+        {"Native", {"-O3", "-march=native", "-DNDEBUG"}},
+    };
+    return profiles;
+}
+
+/**
+ * @brief The command that builds a C++ project with a profile.
+ */
+std::vector<std::string> profile_compile_command(const std::string& compiler, const std::filesystem::path& source,
+                                                 const std::filesystem::path& executable, const BuildProfile& profile) {
+    std::vector<std::string> command = {compiler, source.string(), "-o", executable.string(), "-std=c++17"};
+    command.insert(command.end(), profile.flags.begin(), profile.flags.end());
+    return command;
+}
+
+/**
+ * @brief A project built for benchmarking.
+ */
+struct BenchmarkBuild {
+    std::filesystem::path executable;
+    std::vector<std::string> command;
+    double seconds = 0.0;        // Wall time of the compile (a single measurement)
+    uintmax_t binary_bytes = 0;  // Size of the executable
+};
+
+/**
+ * @brief Builds a project with a profile, next to its source as <stem>-bench-<profile>.
+ * @param tag Added to the executable's name (<stem>-bench-<tag>-<profile>) when
+ *            several compilers build the same project.
+ * @return The executable and how it was built; throws std::runtime_error if the build fails.
+ */
+BenchmarkBuild build_benchmark_executable(const std::string& compiler, const std::filesystem::path& source,
+                                          const BuildProfile& profile, const std::string& tag = "") {
+    std::string suffix = (tag.empty() ? "" : tag + "-") + profile.name;
+    std::transform(suffix.begin(), suffix.end(), suffix.begin(), [](unsigned char c) { return std::tolower(c); });
+    BenchmarkBuild build;
+    build.executable = source.parent_path() / (source.stem().string() + "-bench-" + suffix);
+    build.command = profile_compile_command(compiler, source, build.executable, profile);
+    auto started = std::chrono::steady_clock::now();
+    ProcessResult built = run_process(build.command);
+    build.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+    if (!built.ok()) {
+        throw std::runtime_error("build failed with exit code " + std::to_string(exit_code_of(built.status)) + ":\n"
+                                 + built.output.substr(0, 4000));
+    }
+    std::error_code ec;
+    build.binary_bytes = std::filesystem::file_size(build.executable, ec);
+    return build;
+}
+
+/**
+ * @brief Value at a fraction (0..1) of sorted data, interpolating between neighbours.
+ */
+double percentile(const std::vector<double>& sorted, double fraction) {
+    if (sorted.empty()) return 0.0;
+    double position = fraction * static_cast<double>(sorted.size() - 1);
+    size_t below = static_cast<size_t>(position);
+    if (below + 1 >= sorted.size()) return sorted.back();
+    return sorted[below] + (position - static_cast<double>(below)) * (sorted[below + 1] - sorted[below]);
+}
+
+/**
+ * @brief Two-sided 95% critical value of Student's t distribution.
+ */
+double student_t_975(size_t degrees_of_freedom) {
+    static const double table[] = {12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+                                   2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+                                   2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042};
+    if (degrees_of_freedom == 0) return 0.0;
+    if (degrees_of_freedom <= 30) return table[degrees_of_freedom - 1];
+    return 1.96 + 2.4 / static_cast<double>(degrees_of_freedom); // Within 0.002 of the exact value above 30
+}
+
+/**
+ * @brief Summary statistics of one metric over a benchmark's measured runs.
+ */
+struct SampleStats {
+    size_t count = 0;
+    double mean = 0.0;
+    double median = 0.0;
+    double stddev = 0.0;   // Sample standard deviation
+    double min = 0.0;
+    double max = 0.0;
+    double p90 = 0.0;
+    double p99 = 0.0;
+    double ci_low = 0.0;   // 95% confidence interval of the mean
+    double ci_high = 0.0;
+
+    /** @brief Coefficient of variation (stddev / mean): the run-to-run noise, independent of scale. */
+    double cv() const { return mean > 0.0 ? stddev / mean : 0.0; }
+
+    static SampleStats of(std::vector<double> values) {
+        SampleStats stats;
+        stats.count = values.size();
+        if (values.empty()) return stats;
+        std::sort(values.begin(), values.end());
+        double sum = 0.0;
+        for (double value : values) sum += value;
+        stats.mean = sum / static_cast<double>(values.size());
+        double squares = 0.0;
+        for (double value : values) squares += (value - stats.mean) * (value - stats.mean);
+        stats.stddev = values.size() > 1 ? std::sqrt(squares / static_cast<double>(values.size() - 1)) : 0.0;
+        stats.median = percentile(values, 0.5);
+        stats.min = values.front();
+        stats.max = values.back();
+        stats.p90 = percentile(values, 0.90);
+        stats.p99 = percentile(values, 0.99);
+        double margin = student_t_975(values.size() - 1) * stats.stddev / std::sqrt(static_cast<double>(values.size()));
+        stats.ci_low = stats.mean - margin;
+        stats.ci_high = stats.mean + margin;
+        return stats;
+    }
+
+    JsonValue to_json_value() const {
+        return JsonValue::make_object()
+            .set("count", count)
+            .set("mean", mean)
+            .set("median", median)
+            .set("stddev", stddev)
+            .set("min", min)
+            .set("max", max)
+            .set("p90", p90)
+            .set("p99", p99)
+            .set("cv", cv())
+            .set("ci95", JsonValue::make_array().push(ci_low).push(ci_high));
+    }
+};
+
+/**
+ * @brief Standard normal cumulative distribution function.
+ */
+double normal_cdf(double z) {
+    return 0.5 * std::erfc(-z / std::sqrt(2.0));
+}
+
+/**
+ * @brief A/B comparison of one metric between two sets of measurements.
+ * Significance comes from a two-sided Mann-Whitney U test (normal
+ * approximation with tie and continuity corrections), which makes no
+ * assumption about the shape of the timing distribution. The size of the
+ * effect is the relative change of the median of B against A, with a 95%
+ * bootstrap percentile interval.
+ */
+struct ABComparison {
+    SampleStats a;
+    SampleStats b;
+    double u = 0.0;                // Mann-Whitney U of A
+    double p_value = 1.0;
+    double relative_change = 0.0;  // median(B) / median(A) - 1
+    double ci_low = 0.0;           // 95% bootstrap interval of relative_change
+    double ci_high = 0.0;
+    bool significant = false;      // p < 0.05 and the interval excludes 0
+
+    static constexpr double kAlpha = 0.05;
+    static constexpr int kBootstrapResamples = 2000;
+
+    static ABComparison of(const std::vector<double>& a, const std::vector<double>& b) {
+        ABComparison result;
+        result.a = SampleStats::of(a);
+        result.b = SampleStats::of(b);
+        if (a.size() < 2 || b.size() < 2 || result.a.median <= 0.0) return result;
+
+        // Ranks over the pooled samples, ties sharing their average rank
+        std::vector<std::pair<double, int>> pooled;
+        for (double value : a) pooled.push_back({value, 0});
+        for (double value : b) pooled.push_back({value, 1});
+        std::sort(pooled.begin(), pooled.end());
+        double rank_sum_a = 0.0;
+        double tie_term = 0.0;
+        for (size_t i = 0; i < pooled.size();) {
+            size_t j = i;
+            while (j < pooled.size() && pooled[j].first == pooled[i].first) ++j;
+            double average_rank = (static_cast<double>(i + 1) + static_cast<double>(j)) / 2.0;
+            for (size_t k = i; k < j; ++k) {
+                if (pooled[k].second == 0) rank_sum_a += average_rank;
+            }
+            double ties = static_cast<double>(j - i);
+            tie_term += ties * ties * ties - ties;
+            i = j;
+        }
+        double n1 = static_cast<double>(a.size());
+        double n2 = static_cast<double>(b.size());
+        double n = n1 + n2;
+        result.u = rank_sum_a - n1 * (n1 + 1) / 2.0;
+        double mean_u = n1 * n2 / 2.0;
+        double variance = n1 * n2 / 12.0 * ((n + 1) - tie_term / (n * (n - 1)));
+        if (variance > 0.0) {
+            double z = (std::fabs(result.u - mean_u) - 0.5) / std::sqrt(variance);
+            result.p_value = std::min(1.0, 2.0 * (1.0 - normal_cdf(std::max(0.0, z))));
+        }
+
+        result.relative_change = result.b.median / result.a.median - 1.0;
+        std::mt19937 random(12345); // Fixed seed: the same data always gives the same interval
+        std::vector<double> changes, resample_a(a.size()), resample_b(b.size());
+        changes.reserve(kBootstrapResamples);
+        std::uniform_int_distribution<size_t> pick_a(0, a.size() - 1), pick_b(0, b.size() - 1);
+        for (int i = 0; i < kBootstrapResamples; ++i) {
+            for (double& value : resample_a) value = a[pick_a(random)];
+            for (double& value : resample_b) value = b[pick_b(random)];
+            std::sort(resample_a.begin(), resample_a.end());
+            std::sort(resample_b.begin(), resample_b.end());
+            double median_a = percentile(resample_a, 0.5);
+            if (median_a > 0.0) changes.push_back(percentile(resample_b, 0.5) / median_a - 1.0);
+        }
+        std::sort(changes.begin(), changes.end());
+        result.ci_low = percentile(changes, 0.025);
+        result.ci_high = percentile(changes, 0.975);
+        result.significant = result.p_value < kAlpha && (result.ci_low > 0.0 || result.ci_high < 0.0);
+        return result;
+    }
+
+    /** @brief One-line conclusion, e.g. "B is 12.3% faster (95% CI 10.1% to 14.2%, p = 0.0003)". */
+    std::string verdict() const {
+        char text[160];
+        if (!significant) {
+            std::snprintf(text, sizeof(text), "No significant change (B %+.1f%%, 95%% CI %+.1f%% to %+.1f%%, p = %.3g)",
+                          relative_change * 100, ci_low * 100, ci_high * 100, p_value);
+        } else {
+            std::snprintf(text, sizeof(text), "B is %.1f%% %s (95%% CI %+.1f%% to %+.1f%%, p = %.3g)",
+                          std::fabs(relative_change) * 100, relative_change < 0 ? "faster" : "slower",
+                          ci_low * 100, ci_high * 100, p_value);
+        }
+        return text;
+    }
+
+    JsonValue to_json_value() const {
+        return JsonValue::make_object()
+            .set("test", "mann-whitney-u")
+            .set("u", u)
+            .set("p_value", p_value)
+            .set("relative_change_of_median", relative_change)
+            .set("bootstrap_ci95", JsonValue::make_array().push(ci_low).push(ci_high))
+            .set("significant", significant)
+            .set("verdict", verdict());
+    }
+};
+
+/**
+ * @brief Lets another thread kill the benchmark child being measured.
+ * The child is forgotten only after it has exited and before it is reaped,
+ * so a recycled pid is never signalled.
+ */
+class BenchmarkCanceller {
+public:
+    void cancel() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_cancelled = true;
+        if (m_pid > 0) ::kill(m_pid, SIGKILL);
+    }
+    bool cancelled() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_cancelled;
+    }
+    /** @brief Clears a previous cancellation before the next benchmark. */
+    void reset() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_cancelled = false;
+    }
+    void attach(pid_t pid) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_pid = pid;
+        if (m_cancelled) ::kill(pid, SIGKILL);
+    }
+    void detach() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_pid = -1;
+    }
+
+private:
+    mutable std::mutex m_mutex;
+    pid_t m_pid = -1;
+    bool m_cancelled = false;
+};
+
+/** @brief One measured execution. */
+struct BenchmarkSample {
+    RunUsage usage;
+    int exit_code = -1;
+};
+
+/**
+ * @brief Runs a command once, with its output discarded, and measures it.
+ * Wall time spans spawn to exit; CPU time, peak RSS and faults come from wait4().
+ * Safe to call from a worker thread.
+ * @param options The command and its environment; stdio is replaced, except
+ *                stdin given as a descriptor (e.g. an input file).
+ * @param canceller Optional; lets another thread kill the run.
+ */
+BenchmarkSample measure_run(SpawnOptions options, BenchmarkCanceller* canceller = nullptr) {
+    if (options.stdin_mode != StdioMode::Fd) options.stdin_mode = StdioMode::Null;
+    options.stdout_mode = StdioMode::Null;
+    options.stderr_mode = StdioMode::Null;
+    auto start = std::chrono::steady_clock::now();
+    ChildProcess child = spawn_process(options);
+    if (canceller) canceller->attach(child.pid);
+    siginfo_t info = {};
+    while (waitid(P_PID, static_cast<id_t>(child.pid), &info, WEXITED | WNOWAIT) != 0 && errno == EINTR) {
+    }
+    auto end = std::chrono::steady_clock::now();
+    if (canceller) canceller->detach();
+    struct rusage usage = {};
+    BenchmarkSample sample;
+    sample.exit_code = exit_code_of(child.wait(&usage));
+    sample.usage.set_rusage(usage);
+    sample.usage.wall_seconds = std::chrono::duration<double>(end - start).count();
+    return sample;
+}
+
+BenchmarkSample measure_run(const std::vector<std::string>& argv, BenchmarkCanceller* canceller = nullptr) {
+    SpawnOptions options;
+    options.argv = argv;
+    return measure_run(std::move(options), canceller);
+}
+
+/**
+ * @brief Where a benchmark ran: toolchain, flags and machine.
+ */
+struct BenchmarkEnvironment {
+    std::string compiler;
+    std::string compiler_version;  // First line of `<compiler> --version`
+    std::string build_command;
+    std::string cpu_model;
+    unsigned cpu_count = 0;
+    std::string kernel;
+
+    static BenchmarkEnvironment capture(const std::string& compiler, const std::vector<std::string>& build_command) {
+        BenchmarkEnvironment environment;
+        environment.compiler = compiler;
+        try {
+            std::string version = run_command({compiler, "--version"});
+            environment.compiler_version = version.substr(0, version.find('\n'));
+        } catch (const std::exception&) {
+        }
+        environment.build_command = format_command(build_command);
+        std::ifstream cpuinfo("/proc/cpuinfo");
+        std::string line;
+        while (std::getline(cpuinfo, line)) {
+            if (line.rfind("model name", 0) == 0 && environment.cpu_model.empty()) {
+                size_t colon = line.find(':');
+                if (colon != std::string::npos) environment.cpu_model = line.substr(line.find_first_not_of(" \t", colon + 1));
+            }
+        }
+        environment.cpu_count = std::thread::hardware_concurrency();
+        struct utsname name;
+        if (uname(&name) == 0) {
+            environment.kernel = std::string(name.sysname) + " " + name.release + " " + name.machine;
+        }
+        return environment;
+    }
+
+    JsonValue to_json_value() const {
+        return JsonValue::make_object()
+            .set("compiler", compiler)
+            .set("compiler_version", compiler_version)
+            .set("build_command", build_command)
+            .set("cpu_model", cpu_model)
+            .set("cpu_count", cpu_count)
+            .set("kernel", kernel);
+    }
+};
+
+/**
+ * @brief Quotes a CSV field if it needs it (RFC 4180).
+ */
+std::string csv_field(const std::string& value) {
+    if (value.find_first_of(",\"\r\n") == std::string::npos) return value;
+    std::string quoted = "\"";
+    for (char c : value) {
+        if (c == '"') quoted += '"';
+        quoted += c;
+    }
+    return quoted + "\"";
+}
+
+/**
+ * @brief Measurements of one project built with one profile.
+ */
+struct BenchmarkReport {
+    std::string project;
+    std::string profile;
+    std::string revision;   // Commit the project was built from
+    std::string variant;    // How it was run, in a matrix benchmark (e.g. "jemalloc, THP off"); else ""
+    std::vector<std::string> command;
+    std::vector<std::string> env;  // Environment overrides of the runs
+    std::string controls;          // RunControls::describe() of the runs
+    unsigned warmup_runs = 0;
+    BenchmarkEnvironment environment;
+    double build_seconds = 0.0;
+    uintmax_t binary_bytes = 0;
+    std::vector<BenchmarkSample> samples;
+
+    /** @brief Statistics of one metric over the samples. */
+    SampleStats stats(const std::function<double(const RunUsage&)>& metric) const {
+        std::vector<double> values;
+        values.reserve(samples.size());
+        for (const auto& sample : samples) values.push_back(metric(sample.usage));
+        return SampleStats::of(std::move(values));
+    }
+    SampleStats wall() const { return stats([](const RunUsage& u) { return u.wall_seconds; }); }
+    SampleStats user() const { return stats([](const RunUsage& u) { return u.user_seconds; }); }
+    SampleStats system() const { return stats([](const RunUsage& u) { return u.system_seconds; }); }
+    SampleStats max_rss_kb() const { return stats([](const RunUsage& u) { return static_cast<double>(u.max_rss_kb); }); }
+    SampleStats minor_faults() const { return stats([](const RunUsage& u) { return static_cast<double>(u.minor_faults); }); }
+    SampleStats major_faults() const { return stats([](const RunUsage& u) { return static_cast<double>(u.major_faults); }); }
+
+    JsonValue to_json_value() const {
+        JsonValue command_json = JsonValue::make_array();
+        for (const auto& arg : command) command_json.push(arg);
+        JsonValue env_json = JsonValue::make_array();
+        for (const auto& entry : env) env_json.push(entry);
+        JsonValue samples_json = JsonValue::make_array();
+        for (const auto& sample : samples) samples_json.push(sample.usage.to_json_value().set("exit_code", sample.exit_code));
+        return JsonValue::make_object()
+            .set("project", project)
+            .set("profile", profile)
+            .set("revision", revision)
+            .set("variant", variant)
+            .set("command", command_json)
+            .set("env", env_json)
+            .set("controls", controls)
+            .set("warmup_runs", warmup_runs)
+            .set("environment", environment.to_json_value())
+            .set("build", JsonValue::make_object()
+                .set("seconds", build_seconds)
+                .set("binary_bytes", static_cast<unsigned long long>(binary_bytes)))
+            .set("stats", JsonValue::make_object()
+                .set("wall_s", wall().to_json_value())
+                .set("user_s", user().to_json_value())
+                .set("sys_s", system().to_json_value())
+                .set("max_rss_kb", max_rss_kb().to_json_value()))
+            .set("samples", samples_json);
+    }
+
+    /**
+     * @brief One row per measured run, each carrying the build and machine details.
+     * @param header Whether to start with the column names (false to append to another report's CSV).
+     */
+    std::string to_csv(bool header = true) const {
+        std::string csv = header ? "project,profile,variant,revision,compiler_version,build_command,build_s,binary_bytes,"
+                                   "cpu_model,kernel,run,wall_s,user_s,sys_s,max_rss_kb,minor_faults,major_faults,exit_code\n" : "";
+        char build[64];
+        std::snprintf(build, sizeof(build), "%.3f,%ju,", build_seconds, binary_bytes);
+        std::string prefix = csv_field(project) + "," + csv_field(profile) + "," + csv_field(variant) + "," + csv_field(revision) + ","
+                           + csv_field(environment.compiler_version) + "," + csv_field(environment.build_command) + "," + build + csv_field(environment.cpu_model) + ","
+                           + csv_field(environment.kernel) + ",";
+        for (size_t i = 0; i < samples.size(); ++i) {
+            const RunUsage& usage = samples[i].usage;
+            char row[256];
+            std::snprintf(row, sizeof(row), "%zu,%.9f,%.6f,%.6f,%ld,%ld,%ld,%d\n", i + 1, usage.wall_seconds,
+                          usage.user_seconds, usage.system_seconds, usage.max_rss_kb, usage.minor_faults,
+                          usage.major_faults, samples[i].exit_code);
+            csv += prefix + row;
+        }
+        return csv;
+    }
+};
+
+// --- Run History Store ---
+
+/**
+ * @brief Append-only record of launcher builds and runs, kept as JSON Lines
+ * (history.jsonl in the data directory) so that it survives the session.
+ * Each record is written with a single O_APPEND write, so launchers running
+ * at once do not interleave lines; a torn last line is skipped when loading.
+ * Once the file reaches kMaxBytes it becomes history.1.jsonl, replacing the
+ * previous one, so only the two most recent files are kept and loaded.
+ */
+class HistoryStore {
+public:
+    static constexpr off_t kMaxBytes = 4 << 20;
+
+    explicit HistoryStore(std::filesystem::path file = data_directory() / "history.jsonl") : m_file(std::move(file)) {}
+
+    const std::filesystem::path& path() const { return m_file; }
+
+    /** @brief Where the file goes when it is full, e.g. history.1.jsonl. */
+    std::filesystem::path rotated_path() const {
+        return m_file.parent_path() / (m_file.stem().string() + ".1" + m_file.extension().string());
+    }
+
+    /** @brief Appends one record. @return False if it could not be written. */
+    bool append(const JsonValue& record) const {
+        std::string line = to_json(record, 0) + "\n";
+        int fd = open(m_file.c_str(), O_WRONLY | O_APPEND | O_CREAT | O_CLOEXEC, 0644);
+        if (fd < 0) return false;
+        // The lock keeps two launchers from rotating at once; one that opened the file before
+        // it was rotated sees that the path has moved on and adds its line to the rotated file
+        flock(fd, LOCK_EX);
+        struct stat opened, current;
+        if (fstat(fd, &opened) == 0 && opened.st_size >= kMaxBytes && stat(m_file.c_str(), &current) == 0
+            && current.st_ino == opened.st_ino && current.st_dev == opened.st_dev) {
+            std::rename(m_file.c_str(), rotated_path().c_str());
+        }
+        bool written = write_fully(fd, line.data(), line.size());
+        close(fd);
+        return written;
+    }
+
+    /** @brief Every record kept, oldest first. */
+    std::vector<JsonValue> load() const {
+        std::vector<JsonValue> records;
+        for (const auto& file : {rotated_path(), m_file}) {
+            std::ifstream in(file);
+            std::string line;
+            while (std::getline(in, line)) {
+                if (line.empty()) continue;
+                try {
+                    records.push_back(parse_json(line));
+                } catch (const std::exception&) {
+                    // A line torn by a crash; the rest of the history is still good
+                }
+            }
+        }
+        return records;
+    }
+
+private:
+    std::filesystem::path m_file;
+};
+
+/**
+ * @brief A lasting slow-down found in a project's run history.
+ */
+struct Regression {
+    std::string since_commit;     // First commit of the slower runs
+    std::string previous_commit;  // The last commit before it
+    ABComparison wall;            // Wall times before against since
+
+    std::string describe() const {
+        char text[160];
+        std::snprintf(text, sizeof(text), "%+.1f%% wall time (95%% CI %+.1f%% to %+.1f%%, p = %.2g, %zu runs before, %zu since)",
+                      wall.relative_change * 100, wall.ci_low * 100, wall.ci_high * 100, wall.p_value, wall.a.count,
+                      wall.b.count);
+        return "since commit " + since_commit.substr(0, 12) + " (after " + previous_commit.substr(0, 12) + "): " + text;
+    }
+};
+
+/**
+ * @brief Looks for a change point in the wall times of the runs like latest
+ * (same project and configuration, successful, not instrumented), with the
+ * commits in the order they were first run.
+ * Every boundary between two commits where the newer side is slower by at
+ * least min_change is tried as the split, with all the runs on each side
+ * pooled, and the one with the lowest Mann-Whitney p-value wins; an earlier
+ * speed-up cannot hide a later slow-down. It is reported only when latest's
+ * commit is the newest, the split has p < 0.01 (stricter than usual, as
+ * several splits are tried), and each side has at least three runs.
+ * @return True, with the regression, if one was found.
+ */
+bool detect_regression(const std::vector<RunHistoryEntry>& history, const RunHistoryEntry& latest, Regression& found,
+                       double min_change = 0.05) {
+    static constexpr size_t kMinRuns = 3;
+    static constexpr size_t kMaxRuns = 500; // Only recent history counts
+    std::vector<const RunHistoryEntry*> runs; // The most recent comparable runs, newest first
+    for (auto it = history.rbegin(); it != history.rend() && runs.size() < kMaxRuns; ++it) {
+        const RunHistoryEntry& entry = *it;
+        if (entry.project != latest.project || entry.configuration != latest.configuration || entry.commit.empty()
+            || entry.exit_code != 0 || entry.instrumented || !entry.reason.empty()) {
+            continue;
+        }
+        runs.push_back(&entry);
+    }
+    // Oldest first, so that re-running an old commit does not make it the newest
+    std::vector<std::string> commits;
+    std::vector<std::vector<double>> walls; // Per commit, in commit order
+    for (auto it = runs.rbegin(); it != runs.rend(); ++it) {
+        auto at = std::find(commits.begin(), commits.end(), (*it)->commit);
+        if (at == commits.end()) {
+            commits.push_back((*it)->commit);
+            walls.emplace_back();
+            at = commits.end() - 1;
+        }
+        walls[static_cast<size_t>(at - commits.begin())].push_back((*it)->usage.wall_seconds);
+    }
+    if (commits.size() < 2 || commits.back() != latest.commit) return false;
+
+    bool have = false;
+    for (size_t split = 1; split < commits.size(); ++split) {
+        std::vector<double> before, since;
+        for (size_t c = 0; c < commits.size(); ++c) {
+            std::vector<double>& side = c < split ? before : since;
+            side.insert(side.end(), walls[c].begin(), walls[c].end());
+        }
+        if (before.size() < kMinRuns || since.size() < kMinRuns) continue;
+        ABComparison comparison = ABComparison::of(before, since);
+        if (comparison.relative_change < min_change) continue; // A speed-up, or too small to matter
+        if (!have || comparison.p_value < found.wall.p_value) {
+            found = {commits[split], commits[split - 1], comparison};
+            have = true;
+        }
+    }
+    return have && found.wall.p_value < 0.01 && found.wall.significant;
+}
+
+// --- Allocator Matrix ---
+
+/**
+ * @brief ELF machine type of a file (e_machine), or -1 if it is not a readable ELF file.
+ */
+int elf_machine(const std::filesystem::path& file) {
+    std::ifstream in(file, std::ios::binary);
+    Elf64_Ehdr header; // e_machine sits at the same offset in 32-bit files
+    if (!in.read(reinterpret_cast<char*>(&header), sizeof(header)) || std::memcmp(header.e_ident, ELFMAG, SELFMAG) != 0) {
+        return -1;
+    }
+    return header.e_machine;
+}
+
+/**
+ * @brief A malloc implementation that runs can be given through LD_PRELOAD.
+ */
+struct MemoryAllocator {
+    std::string name;               // "glibc", "jemalloc", ...
+    std::filesystem::path library;  // Empty for glibc, which needs no preload
+};
+
+/**
+ * @brief The allocators installed on this machine, glibc first.
+ * Looks in the dynamic linker cache (`ldconfig -p`), then in the usual
+ * library directories for ones installed without refreshing it. Libraries
+ * for another architecture (e.g. i386 multilib) are skipped.
+ */
+std::vector<MemoryAllocator> find_allocators() {
+    static const std::pair<const char*, const char*> kKnown[] = {
+        {"jemalloc", "libjemalloc.so"},
+        {"mimalloc", "libmimalloc.so"},
+        {"tcmalloc", "libtcmalloc_minimal.so"}, // Without the heap profiler's dependencies
+        {"tcmalloc", "libtcmalloc.so"},
+    };
+    std::vector<std::filesystem::path> candidates;
+    for (const char* ldconfig : {"ldconfig", "/sbin/ldconfig"}) {
+        try {
+            // "\tlibjemalloc.so.2 (libc6,x86-64) => /usr/lib/x86_64-linux-gnu/libjemalloc.so.2"
+            ProcessResult result = run_process({ldconfig, "-p"});
+            if (!result.ok()) continue;
+            std::istringstream in(result.output);
+            std::string line;
+            while (std::getline(in, line)) {
+                size_t arrow = line.find(" => ");
+                if (arrow != std::string::npos) candidates.push_back(line.substr(arrow + 4));
+            }
+            break;
+        } catch (const std::exception&) {
+        }
+    }
+    for (const char* dir : {"/usr/local/lib", "/usr/local/lib64", "/usr/lib", "/usr/lib64", "/usr/lib/x86_64-linux-gnu",
+                            "/usr/lib/aarch64-linux-gnu"}) {
+        std::error_code error;
+        for (const auto& entry : std::filesystem::directory_iterator(dir, error)) candidates.push_back(entry.path());
+    }
+
+    int machine = elf_machine("/proc/self/exe");
+    std::vector<MemoryAllocator> found = {{"glibc", {}}};
+    for (const auto& [name, prefix] : kKnown) {
+        bool have = false;
+        for (const auto& allocator : found) have |= allocator.name == name;
+        if (have) continue;
+        for (const auto& candidate : candidates) {
+            if (candidate.filename().string().rfind(prefix, 0) == 0 && elf_machine(candidate) == machine) {
+                found.push_back({name, candidate});
+                break;
+            }
+        }
+    }
+    return found;
+}
+
+/**
+ * @brief The system's transparent hugepage mode: "always", "madvise" or "never"; "" if unknown.
+ */
+std::string transparent_hugepage_mode() {
+    // e.g. "always [madvise] never"
+    std::string modes = read_text_file("/sys/kernel/mm/transparent_hugepage/enabled");
+    size_t open = modes.find('[');
+    size_t close = modes.find(']', open);
+    if (open == std::string::npos || close == std::string::npos) return "";
+    return modes.substr(open + 1, close - open - 1);
+}
+
+// --- Core Scaling ---
+
+/**
+ * @brief The CPUs the launcher may run on, ordered for a scaling sweep:
+ * one CPU of each physical core first (spread over sockets), then the SMT
+ * siblings. A sweep that takes the first n of them therefore adds whole
+ * cores before it starts sharing them.
+ */
+std::vector<int> scaling_cpu_order() {
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) return {};
+    struct Cpu {
+        int id;
+        int package;
+        int core;
+        int sibling = 0; // 0 for the first CPU of its core, 1 for the next...
+        int rank = 0;    // Of the core within its package
+    };
+    auto read_id = [](int cpu, const char* name) {
+        std::ifstream in("/sys/devices/system/cpu/cpu" + std::to_string(cpu) + "/topology/" + name);
+        int id = -1;
+        return in >> id ? id : cpu; // Unknown topology: every CPU is its own core
+    };
+    std::vector<Cpu> cpus;
+    std::map<std::pair<int, int>, int> seen_cores;
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+        if (!CPU_ISSET(cpu, &allowed)) continue;
+        Cpu entry{cpu, read_id(cpu, "physical_package_id"), read_id(cpu, "core_id")};
+        entry.sibling = seen_cores[{entry.package, entry.core}]++;
+        cpus.push_back(entry);
+    }
+    // Round-robin over the packages, so that two cores are on two sockets where there are two
+    std::map<int, int> package_rank;
+    for (auto& cpu : cpus) {
+        if (cpu.sibling == 0) cpu.rank = package_rank[cpu.package]++;
+    }
+    std::stable_sort(cpus.begin(), cpus.end(), [](const Cpu& a, const Cpu& b) {
+        return a.sibling != b.sibling ? a.sibling < b.sibling : a.rank < b.rank;
+    });
+    std::vector<int> order;
+    for (const auto& cpu : cpus) order.push_back(cpu.id);
+    return order;
+}
+
+/**
+ * @brief The core counts of a sweep up to max: 1, 2, 4, 8 ... and max itself.
+ */
+std::vector<int> scaling_core_counts(int max) {
+    std::vector<int> counts;
+    for (int n = 1; n < max; n *= 2) counts.push_back(n);
+    if (max >= 1) counts.push_back(max);
+    return counts;
+}
+
+// --- Input Scaling ---
+
+/**
+ * @brief A growth model for empirical complexity fitting, cheapest first.
+ */
+struct ComplexityModel {
+    const char* name;
+    double (*growth)(double n);
+};
+
+const std::vector<ComplexityModel>& complexity_models() {
+    static const std::vector<ComplexityModel> models = {
+        {"O(1)", [](double) { return 1.0; }},
+        {"O(log n)", [](double n) { return std::log2(std::max(n, 2.0)); }},
+        {"O(n)", [](double n) { return n; }},
+        {"O(n log n)", [](double n) { return n * std::log2(std::max(n, 2.0)); }},
+        {"O(n^2)", [](double n) { return n * n; }},
+        {"O(n^3)", [](double n) { return n * n * n; }},
+    };
+    return models;
+}
+
+/**
+ * @brief How well y = a + b * growth(n) describes measurements, for one model.
+ * The fit minimises relative rather than absolute error, so the small
+ * sizes (where a, e.g. process start-up, dominates) count as much as the
+ * large ones. b is kept non-negative.
+ */
+struct ComplexityFit {
+    size_t model = 0;     // Index into complexity_models()
+    double a = 0.0;
+    double b = 0.0;
+    double error = 0.0;   // Root-mean-square relative error
+
+    static ComplexityFit of(size_t model, const std::vector<double>& n, const std::vector<double>& y) {
+        ComplexityFit fit;
+        fit.model = model;
+        // Weighted least squares, weight 1 / y^2
+        double sw = 0, sx = 0, sy = 0, sxx = 0, sxy = 0;
+        for (size_t i = 0; i < n.size(); ++i) {
+            if (y[i] <= 0) continue;
+            double w = 1.0 / (y[i] * y[i]);
+            double x = complexity_models()[model].growth(n[i]);
+            sw += w; sx += w * x; sy += w * y[i]; sxx += w * x * x; sxy += w * x * y[i];
+        }
+        double det = sw * sxx - sx * sx;
+        if (model > 0 && det > 0) fit.b = (sw * sxy - sx * sy) / det;
+        if (fit.b < 0) fit.b = 0;
+        fit.a = sw > 0 ? (sy - fit.b * sx) / sw : 0.0;
+        double squares = 0;
+        size_t count = 0;
+        for (size_t i = 0; i < n.size(); ++i) {
+            if (y[i] <= 0) continue;
+            double relative = (fit.a + fit.b * complexity_models()[model].growth(n[i]) - y[i]) / y[i];
+            squares += relative * relative;
+            ++count;
+        }
+        fit.error = count > 0 ? std::sqrt(squares / static_cast<double>(count)) : 0.0;
+        return fit;
+    }
+};
+
+/**
+ * @brief Empirical complexity of one metric over an input-size sweep.
+ */
+struct ComplexityReport {
+    std::vector<ComplexityFit> fits;  // One per model, in complexity_models() order
+    size_t best = 0;                  // Index into fits
+    double exponent = 0.0;            // Slope of log y over log n, between the two largest sizes
+
+    /**
+     * @param n Input sizes, increasing.
+     * @param y The metric's median at each size.
+     */
+    static ComplexityReport of(const std::vector<double>& n, const std::vector<double>& y) {
+        ComplexityReport report;
+        for (size_t m = 0; m < complexity_models().size(); ++m) {
+            report.fits.push_back(ComplexityFit::of(m, n, y));
+            // A costlier model has to fit clearly better, or noise picks the most flexible curve
+            if (report.fits[m].error < report.fits[report.best].error * 0.8) report.best = m;
+        }
+        size_t last = n.size() - 1;
+        if (n.size() >= 2 && y[last] > 0 && y[last - 1] > 0 && n[last] > n[last - 1]) {
+            report.exponent = std::log(y[last] / y[last - 1]) / std::log(n[last] / n[last - 1]);
+        }
+        return report;
+    }
+
+    const char* best_name() const { return complexity_models()[fits[best].model].name; }
+
+    /** @brief Whether the best model grows faster than expected, and fits clearly better than it. */
+    bool worse_than(size_t expected) const {
+        return best > expected && fits[best].error < fits[expected].error * 0.8;
+    }
+
+    JsonValue to_json_value() const {
+        JsonValue fits_json = JsonValue::make_array();
+        for (const auto& fit : fits) {
+            fits_json.push(JsonValue::make_object()
+                .set("model", complexity_models()[fit.model].name)
+                .set("a", fit.a)
+                .set("b", fit.b)
+                .set("rms_relative_error", fit.error));
+        }
+        return JsonValue::make_object().set("best", best_name()).set("exponent", exponent).set("fits", fits_json);
+    }
+};
+
+/**
+ * @brief Generators for the stdin of input-size sweeps.
+ * Inputs are deterministic (fixed seed), so they are written once into the
+ * cache directory and reused by later sweeps.
+ */
+enum class InputGenerator { Integers, CountedIntegers, Words };
+
+/** @brief Largest input generated_input() writes, so a typo in a sweep cannot fill the disk. */
+constexpr unsigned long long kMaxGeneratedInputBytes = 1ULL << 30;
+
+/**
+ * @brief Upper bound on the size of a generated input of size n, in bytes:
+ * at most 12 letters per word, or a sign and 10 digits per integer, plus a separator.
+ */
+unsigned long long generated_input_bytes(InputGenerator generator, long long n) {
+    unsigned long long per_item = generator == InputGenerator::Words ? 13 : 12;
+    unsigned long long count = static_cast<unsigned long long>(std::max(0LL, n));
+    if (count > kMaxGeneratedInputBytes) return count; // Over the cap anyway; avoids overflow
+    return count * per_item + (generator == InputGenerator::CountedIntegers ? 21 : 0);
+}
+
+/**
+ * @brief The generated input of size n, written on first use.
+ * @return The file; throws std::runtime_error if it would be larger than
+ * kMaxGeneratedInputBytes or the cache has no room for it, or if it cannot be written.
+ */
+std::filesystem::path generated_input(InputGenerator generator, long long n) {
+    static const char* const kNames[] = {"integers", "counted-integers", "words"};
+    std::filesystem::path dir = cache_directory() / "inputs";
+    std::filesystem::create_directories(dir);
+    std::filesystem::path file = dir / (std::string(kNames[static_cast<int>(generator)]) + "-" + std::to_string(n) + ".txt");
+    if (std::filesystem::exists(file)) return file;
+
+    unsigned long long bytes = generated_input_bytes(generator, n);
+    if (bytes > kMaxGeneratedInputBytes) {
+        throw std::runtime_error("The generated input for n = " + std::to_string(n) + " would exceed "
+                                 + std::to_string(kMaxGeneratedInputBytes >> 20) + " MiB");
+    }
+    std::error_code ec;
+    std::filesystem::space_info space = std::filesystem::space(dir, ec);
+    if (!ec && space.available < bytes) {
+        throw std::runtime_error("Not enough space in " + dir.string() + " for the input for n = " + std::to_string(n));
+    }
+
+    std::filesystem::path partial = file.string() + "." + std::to_string(getpid());
+    {
+        std::ofstream out(partial, std::ios::binary | std::ios::trunc);
+        std::mt19937_64 random(42);
+        std::uniform_int_distribution<long long> value(-1000000000, 1000000000);
+        std::uniform_int_distribution<int> letter('a', 'z'), length(1, 12);
+        if (generator == InputGenerator::CountedIntegers) out << n << '\n';
+        for (long long i = 0; i < n; ++i) {
+            if (generator == InputGenerator::Words) {
+                std::string word(static_cast<size_t>(length(random)), ' ');
+                for (char& c : word) c = static_cast<char>(letter(random));
+                out << word << '\n';
+            } else {
+                out << value(random) << (generator == InputGenerator::CountedIntegers && i + 1 < n ? ' ' : '\n');
+            }
+        }
+        if (!out) {
+            out.close();
+            std::filesystem::remove(partial, ec);
+            throw std::runtime_error("Could not write " + partial.string());
+        }
+    }
+    std::filesystem::rename(partial, file);
+    return file;
+}
+
+/**
+ * @brief Replaces every "{n}" in a template with the input size.
+ */
+std::string substitute_size(std::string text, long long n) {
+    for (size_t at = text.find("{n}"); at != std::string::npos; at = text.find("{n}", at)) {
+        text.replace(at, 3, std::to_string(n));
+    }
+    return text;
+}
+
+// --- Run Controls ---
+
+/**
+ * @brief Parses a CPU list in the kernel's format, e.g. "2-3,6".
+ * @return The CPUs in increasing order; throws std::runtime_error if the text is not a CPU list.
+ */
+std::vector<int> parse_cpu_list(const std::string& text) {
+    std::set<int> cpus;
+    std::stringstream ranges(text);
+    std::string range;
+    while (std::getline(ranges, range, ',')) {
+        range.erase(std::remove_if(range.begin(), range.end(), [](unsigned char c) { return std::isspace(c); }), range.end());
+        if (range.empty()) continue;
+        int first = 0, last = 0;
+        char tail = 0;
+        int fields = std::sscanf(range.c_str(), "%d-%d%c", &first, &last, &tail);
+        if (fields == 1) last = first;
+        if (fields < 1 || fields > 2 || first < 0 || last < first || last >= CPU_SETSIZE
+            || range.find_first_not_of("0123456789-") != std::string::npos || (fields == 1 && range.find('-') != std::string::npos)) {
+            throw std::runtime_error("Not a CPU list: " + text + " (expected e.g. 2-3,6)");
+        }
+        for (int cpu = first; cpu <= last; ++cpu) cpus.insert(cpu);
+    }
+    return std::vector<int>(cpus.begin(), cpus.end());
+}
+
+/**
+ * @brief The CPUs kept free of other tasks with the isolcpus= boot option, as a CPU list ("" if none).
+ */
+std::string isolated_cpus() {
+    std::string text = read_text_file("/sys/devices/system/cpu/isolated");
+    text.erase(std::remove_if(text.begin(), text.end(), [](unsigned char c) { return std::isspace(c); }), text.end());
+    return text;
+}
+
+/**
+ * @brief Settings that make benchmark runs repeat more exactly, applied to every run.
+ */
+struct RunControls {
+    enum class PageCache { Leave, Warm, Drop };
+
+    std::vector<int> cpus;        // Pin to these CPUs; empty to leave the affinity alone
+    int nice = 0;
+    int fifo_priority = 0;        // SCHED_FIFO at this priority; 0 for the default policy
+    bool no_aslr = false;
+    PageCache page_cache = PageCache::Leave;
+
+    /** @brief Adds the settings to a run; CPUs the run already has (e.g. from a scaling sweep) are kept. */
+    void apply(SpawnOptions& options) const {
+        if (options.cpus.empty()) options.cpus = cpus;
+        options.nice = nice;
+        options.fifo_priority = fifo_priority;
+        options.no_aslr = no_aslr;
+    }
+
+    /**
+     * @brief Puts the files a run reads (its executable, input) into the page
+     * cache or takes them out of it, as set; called before every run.
+     * Dropping only works for pages that are clean, so the file is written
+     * back first; pages mapped by other processes stay.
+     */
+    void prepare(const std::vector<std::filesystem::path>& files) const {
+        if (page_cache == PageCache::Leave) return;
+        for (const auto& file : files) {
+            int fd = open(file.c_str(), O_RDONLY | O_CLOEXEC);
+            if (fd < 0) continue;
+            if (page_cache == PageCache::Drop) {
+                fdatasync(fd);
+                posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+            } else {
+                posix_fadvise(fd, 0, 0, POSIX_FADV_WILLNEED);
+                char buffer[64 * 1024];
+                while (read(fd, buffer, sizeof(buffer)) > 0) {
+                }
+            }
+            close(fd);
+        }
+    }
+
+    /** @brief The settings in words, e.g. "CPUs 2-3, SCHED_FIFO 1, ASLR off", or "" for none. */
+    std::string describe() const {
+        std::vector<std::string> parts;
+        if (!cpus.empty()) {
+            std::string list;
+            for (int cpu : cpus) list += (list.empty() ? "" : ",") + std::to_string(cpu);
+            parts.push_back("CPUs " + list);
+        }
+        if (nice != 0) parts.push_back("nice " + std::to_string(nice));
+        if (fifo_priority > 0) parts.push_back("SCHED_FIFO " + std::to_string(fifo_priority));
+        if (no_aslr) parts.push_back("ASLR off");
+        if (page_cache == PageCache::Warm) parts.push_back("warm page cache");
+        if (page_cache == PageCache::Drop) parts.push_back("cold page cache");
+        std::string text;
+        for (const auto& part : parts) text += (text.empty() ? "" : ", ") + part;
+        return text;
+    }
+};
+
+// --- Watch Mode ---
+
+/**
+ * @brief Fetches a clone's upstream branch and lists the commits it gained
+ * after since, oldest first. Only first parents are followed, so a merged
+ * branch is a single step, its merge. Throws std::runtime_error if git fails.
+ */
+std::vector<std::string> fetch_new_commits(const std::filesystem::path& repo, const std::string& since) {
+    git_output(repo, {"fetch", "--quiet", "origin"});
+    std::istringstream listed(git_output(repo, {"rev-list", "--first-parent", "--reverse", since + "..@{upstream}"}));
+    std::vector<std::string> commits;
+    for (std::string sha; std::getline(listed, sha);) {
+        if (!sha.empty()) commits.push_back(sha);
+    }
+    return commits;
+}
+
+/**
+ * @brief Checks a commit out into the repository's watch worktree. There is
+ * one per repository, moved from commit to commit, so a checkout only
+ * rewrites the files the commits differ in.
+ * @return The worktree's root directory.
+ */
+std::filesystem::path checkout_watch_worktree(const std::filesystem::path& repo, const std::string& sha) {
+    std::filesystem::path worktree = repo.parent_path() / ".worktrees" / (repo.filename().string() + "-watch");
+    if (std::filesystem::exists(worktree)) {
+        git_output(worktree, {"checkout", "--detach", "--quiet", "--force", sha});
+    } else {
+        std::filesystem::create_directories(worktree.parent_path());
+        git_output(repo, {"worktree", "add", "--detach", "--quiet", worktree.string(), sha});
+    }
+    return worktree;
+}
+
+/**
+ * @brief Builds a project as of a commit, or reuses the build of an earlier
+ * commit that left the project's directory as it was. Builds are cached in
+ * cache_directory()/watch by the git tree of that directory and an fnv1a
+ * hash of the compiler (with its `--version` output, so an upgrade rebuilds)
+ * and the profile's flags, so a commit that only touches other files costs
+ * no build, and a rebuilt launcher still finds the builds. This assumes that a
+ * project only includes files from its own directory: a change to a header
+ * elsewhere in the repository reuses the earlier build.
+ * @param relative_source The source file's path within the repository.
+ * @param reused Set to whether a cached build was used (its seconds are then 0).
+ * @return The build; throws std::runtime_error if it fails.
+ */
+BenchmarkBuild build_commit(const std::string& compiler, const std::filesystem::path& repo,
+                            const std::filesystem::path& relative_source, const std::string& sha,
+                            const BuildProfile& profile, bool& reused) {
+    std::string tree = git_output(repo, {"rev-parse", sha + ":" + relative_source.parent_path().generic_string()});
+    std::string version = run_command({compiler, "--version"});
+    // The key outlives this launcher's binary, so it is built from stable hashes only
+    char toolchain[9];
+    std::snprintf(toolchain, sizeof(toolchain), "%08x",
+                  fnv1a(compiler + "\n" + version + "\n" + format_command(profile.flags)));
+    std::filesystem::path cached = cache_directory() / "watch"
+                                 / (relative_source.stem().string() + "-" + tree + "-" + toolchain);
+    BenchmarkBuild build;
+    reused = std::filesystem::exists(cached);
+    if (reused) {
+        std::error_code ec;
+        build.executable = cached;
+        build.command = profile_compile_command(compiler, relative_source, cached, profile);
+        build.binary_bytes = std::filesystem::file_size(cached, ec);
+        return build;
+    }
+    std::filesystem::path worktree = checkout_watch_worktree(repo, sha);
+    build = build_benchmark_executable(compiler, worktree / relative_source, profile, "watch");
+    // Copied under a temporary name, so an interrupted copy is never taken for a build
+    std::filesystem::create_directories(cached.parent_path());
+    std::filesystem::path partial = cached;
+    partial += ".part";
+    std::filesystem::copy_file(build.executable, partial, std::filesystem::copy_options::overwrite_existing);
+    std::filesystem::rename(partial, cached);
+    build.executable = cached;
+    return build;
+}
+
+/**
+ * @brief How commits are benchmarked in watch mode and when bisecting.
+ */
+struct CommitBenchmarkSettings {
+    std::string compiler;           // Empty for default_compiler()
+    BuildProfile profile;
+    RunControls controls;
+    std::vector<std::string> args;  // Passed to every run
+    unsigned warmup = 0;
+    unsigned runs = 0;
+};
+
+/**
+ * @brief Builds a commit with build_commit() and times its warm-up and
+ * measured runs. Safe to call from a worker thread.
+ * @param progress Told what is happening, e.g. "measured run 3 of 10".
+ * @param reused Set to whether a cached build was used.
+ * @return The measurements, fewer than asked for if cancelled; throws
+ * std::runtime_error if the build fails or a run exits with an error.
+ */
+BenchmarkReport benchmark_commit(const std::string& project_name, const std::filesystem::path& repo,
+                                 const std::filesystem::path& relative_source, const std::string& sha,
+                                 const CommitBenchmarkSettings& settings, BenchmarkCanceller& canceller,
+                                 const std::function<void(const std::string&)>& progress, bool& reused) {
+    progress("building");
+    std::string compiler = settings.compiler.empty() ? default_compiler() : settings.compiler;
+    BenchmarkBuild build = build_commit(compiler, repo, relative_source, sha, settings.profile, reused);
+    BenchmarkReport report;
+    report.project = project_name;
+    report.profile = settings.profile.name;
+    report.revision = sha;
+    report.controls = settings.controls.describe();
+    report.warmup_runs = settings.warmup;
+    report.environment = BenchmarkEnvironment::capture(compiler, build.command);
+    report.build_seconds = build.seconds;
+    report.binary_bytes = build.binary_bytes;
+    report.command = {build.executable.string()};
+    report.command.insert(report.command.end(), settings.args.begin(), settings.args.end());
+    unsigned warmup = settings.warmup, runs = settings.runs;
+    for (unsigned i = 0; i < warmup + runs && !canceller.cancelled(); ++i) {
+        bool warming_up = i < warmup;
+        progress(warming_up ? "warm-up run " + std::to_string(i + 1) + " of " + std::to_string(warmup)
+                            : "measured run " + std::to_string(i - warmup + 1) + " of " + std::to_string(runs));
+        settings.controls.prepare({build.executable});
+        SpawnOptions options;
+        options.argv = report.command;
+        settings.controls.apply(options);
+        BenchmarkSample sample = measure_run(std::move(options), &canceller);
+        if (canceller.cancelled()) break;
+        if (sample.exit_code != 0) {
+            throw std::runtime_error("run " + std::to_string(i + 1) + " exited with code " + std::to_string(sample.exit_code));
+        }
+        if (!warming_up) report.samples.push_back(sample);
+    }
+    return report;
+}
+
+// --- Performance Bisect ---
+
+/**
+ * @brief The first-parent commits from good to bad, both included, oldest
+ * first, keeping only descendants of good. A shallow clone is deepened until
+ * good is an ancestor of bad and none of the range is cut off at the shallow
+ * boundary. Throws std::runtime_error if good is not an ancestor of bad.
+ */
+std::vector<std::string> first_parent_range(const std::filesystem::path& repo, const std::string& good,
+                                            const std::string& bad) {
+    auto complete = [&]() {
+        if (!run_process({"git", "-C", repo.string(), "merge-base", "--is-ancestor", good, bad}).ok()) return false;
+        // Commits at the boundary have parents that were never fetched
+        std::ifstream shallow(repo / git_output(repo, {"rev-parse", "--git-path", "shallow"}));
+        std::set<std::string> boundary;
+        for (std::string sha; std::getline(shallow, sha);) boundary.insert(sha);
+        if (boundary.empty()) return true;
+        std::istringstream range(git_output(repo, {"rev-list", good + ".." + bad}));
+        for (std::string sha; std::getline(range, sha);) {
+            if (boundary.count(sha)) return false;
+        }
+        return true;
+    };
+    if (!git_deepen_until(repo, complete)) {
+        throw std::runtime_error(good.substr(0, 12) + " is not an ancestor of " + bad.substr(0, 12));
+    }
+    std::vector<std::string> commits = {good};
+    std::istringstream listed(git_output(repo, {"rev-list", "--first-parent", "--ancestry-path", "--reverse",
+                                                good + ".." + bad}));
+    for (std::string sha; std::getline(listed, sha);) {
+        if (!sha.empty()) commits.push_back(sha);
+    }
+    return commits;
+}
+
+/**
+ * @brief Binary search for the first slow commit of a range whose first
+ * commit is fast (good) and whose last is slow (bad). Commits that cannot be
+ * measured, e.g. because they do not build, or that classify() cannot tell
+ * apart from either end, are skipped as with `git bisect skip`, which can
+ * leave the answer a range of commits.
+ */
+class PerformanceBisector {
+public:
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
+    enum class Verdict { Fast, Slow, Unclear };
+
+    explicit PerformanceBisector(size_t count) : m_skipped(count, false), m_high(count - 1) {}
+
+    /**
+     * @brief Classifies a commit's wall times with ABComparison against good's
+     * and bad's. It is slow if it is significantly slower than good and not
+     * significantly faster than bad, and fast the other way round. Between
+     * both (a gradual slow-down) the nearer median decides; like both, noise
+     * leaves it Unclear.
+     */
+    static Verdict classify(const std::vector<double>& good, const std::vector<double>& bad,
+                            const std::vector<double>& walls) {
+        ABComparison from_good = ABComparison::of(good, walls);
+        ABComparison from_bad = ABComparison::of(bad, walls);
+        bool slower_than_good = from_good.significant && from_good.relative_change > 0;
+        bool faster_than_bad = from_bad.significant && from_bad.relative_change < 0;
+        if (slower_than_good != faster_than_bad) return slower_than_good ? Verdict::Slow : Verdict::Fast;
+        if (!slower_than_good) return Verdict::Unclear;
+        double median = from_good.b.median;
+        return std::abs(median - from_bad.a.median) < std::abs(median - from_good.a.median) ? Verdict::Slow : Verdict::Fast;
+    }
+
+    /** @brief The commit to measure next, nearest the middle of what is left; npos when done. */
+    size_t next() const {
+        size_t middle = m_low + (m_high - m_low) / 2;
+        for (size_t distance = 0; distance <= (m_high - m_low) / 2; ++distance) {
+            for (size_t index : {middle - distance, middle + distance}) {
+                if (index > m_low && index < m_high && !m_skipped[index]) return index;
+            }
+        }
+        return npos;
+    }
+
+    /** @brief Records whether a commit is slow. */
+    void mark(size_t index, bool slow) { (slow ? m_high : m_low) = index; }
+    void skip(size_t index) { m_skipped[index] = true; }
+
+    size_t last_fast() const { return m_low; }
+    size_t first_slow() const { return m_high; }
+    /** @brief Whether the first slow commit is known, not just a range of skipped ones ending in it. */
+    bool exact() const { return m_high == m_low + 1; }
+
+private:
+    std::vector<bool> m_skipped;
+    size_t m_low = 0;  // Newest commit known to be fast
+    size_t m_high;     // Oldest commit known to be slow
+};
+
+/**
+ * @brief One commit measured while bisecting.
+ */
+struct BisectStep {
+    size_t index = 0;         // In the range, 0 being the good commit
+    std::string commit;
+    std::string subject;
+    std::vector<double> walls;  // Wall time of each measured run, in seconds
+    SampleStats wall;
+    ABComparison against_good;
+    bool slow = false;
+    bool rebuilt = false;     // False when a cached build was reused
+    std::string error;        // Why it was skipped, if it was
+};
+
+// --- Cache Simulation ---
+
+/**
+ * @brief Self cost of one function in a Cachegrind or Callgrind profile.
+ */
+struct CacheSimFunction {
+    std::string name;
+    std::string file;
+    std::vector<unsigned long long> counts;  // One per CacheSimReport::events
+};
+
+/**
+ * @brief A Cachegrind or Callgrind profile: event counts per function and
+ * in total, from which the simulated L1 and last-level (LL) miss rates
+ * follow. Unlike hardware counters these are exact and repeat from run to
+ * run, so one run per commit is enough to compare commits.
+ */
+struct CacheSimReport {
+    std::string command;              // As Valgrind ran it
+    std::vector<std::string> events;  // E.g. Ir I1mr ILmr Dr D1mr DLmr Dw D1mw DLmw
+    std::vector<unsigned long long> totals;
+    std::vector<CacheSimFunction> functions;
+    int exit_code = 0;                // Of the program
+
+    /** @brief A count of an event ("Ir", "D1mr", ...) in counts; 0 if it was not collected. */
+    unsigned long long count(const std::vector<unsigned long long>& counts, const std::string& event) const {
+        // Valgrind before 3.6 called the last level L2
+        std::string old_name = event.size() == 4 && event[1] == 'L' ? event.substr(0, 1) + "2" + event.substr(2) : event;
+        for (size_t i = 0; i < events.size() && i < counts.size(); ++i) {
+            if (events[i] == event || events[i] == old_name) return counts[i];
+        }
+        return 0;
+    }
+    bool simulated_cache() const { return std::find(events.begin(), events.end(), "D1mr") != events.end(); }
+
+    /**
+     * @brief The functions with the counts of same-named ones summed, in
+     * order of first appearance. Inline and template functions are listed
+     * under every file they were expanded in; file is the first of those,
+     * with ", +N" when there were more.
+     */
+    std::vector<CacheSimFunction> functions_by_name() const {
+        std::vector<CacheSimFunction> merged;
+        std::map<std::string, size_t> index;
+        std::vector<size_t> files;  // Per merged function
+        for (const auto& function : functions) {
+            auto [at, added] = index.emplace(function.name, merged.size());
+            if (added) {
+                merged.push_back({function.name, function.file, std::vector<unsigned long long>(events.size())});
+                files.push_back(0);
+            }
+            CacheSimFunction& into = merged[at->second];
+            for (size_t i = 0; i < into.counts.size() && i < function.counts.size(); ++i) into.counts[i] += function.counts[i];
+            ++files[at->second];
+        }
+        for (size_t i = 0; i < merged.size(); ++i) {
+            if (files[i] > 1) merged[i].file += ", +" + std::to_string(files[i] - 1);
+        }
+        return merged;
+    }
+
+    /** @brief Memory accesses: instruction fetches plus data reads and writes. */
+    unsigned long long accesses(const std::vector<unsigned long long>& counts) const {
+        return count(counts, "Ir") + count(counts, "Dr") + count(counts, "Dw");
+    }
+    double l1_miss_rate(const std::vector<unsigned long long>& counts) const {
+        unsigned long long total = accesses(counts);
+        return total ? static_cast<double>(count(counts, "I1mr") + count(counts, "D1mr") + count(counts, "D1mw")) / total : 0.0;
+    }
+    double ll_miss_rate(const std::vector<unsigned long long>& counts) const {
+        unsigned long long total = accesses(counts);
+        return total ? static_cast<double>(count(counts, "ILmr") + count(counts, "DLmr") + count(counts, "DLmw")) / total : 0.0;
+    }
+
+    /** @brief E.g. "1234567 instructions, L1 miss rate 0.52%, LL miss rate 0.01%". */
+    std::string summary() const {
+        std::string text = std::to_string(count(totals, "Ir")) + " instructions";
+        if (!simulated_cache()) return text + " (no cache simulation)";
+        char rates[96];
+        std::snprintf(rates, sizeof(rates), ", L1 miss rate %.2f%%, LL miss rate %.3f%%", l1_miss_rate(totals) * 100,
+                      ll_miss_rate(totals) * 100);
+        return text + rates;
+    }
+};
+
+/**
+ * @brief Parses a cachegrind.out or callgrind.out file into self costs per
+ * function. Handles Callgrind's name compression ("fn=(12) name", later
+ * "fn=(12)") and leaves out the inclusive cost lines that follow "calls=",
+ * so every instruction is counted once, in the function that executed it.
+ * Throws std::runtime_error if there is no "events:" line.
+ */
+CacheSimReport parse_cachegrind_output(const std::string& text) {
+    CacheSimReport report;
+    std::map<std::string, std::string> file_names, function_names;  // Compressed names by "(id)"
+    auto expand = [](std::map<std::string, std::string>& names, const std::string& value) {
+        if (value.empty() || value[0] != '(') return value;
+        size_t close = value.find(')');
+        if (close == std::string::npos) return value;
+        std::string id = value.substr(0, close + 1);
+        size_t start = value.find_first_not_of(' ', close + 1);
+        if (start == std::string::npos) return names[id];
+        return names[id] = value.substr(start);
+    };
+    std::map<std::string, size_t> index;  // Of functions, by file and name
+    std::string file;
+    size_t current = static_cast<size_t>(-1);
+    size_t positions = 1;  // Leading columns of a cost line that give the position, not costs
+    bool call_cost = false;
+    std::istringstream lines(text);
+    for (std::string line; std::getline(lines, line);) {
+        if (line.empty() || line[0] == '#') continue;
+        char first = line[0];
+        if (std::isdigit(static_cast<unsigned char>(first)) || first == '+' || first == '-' || first == '*') {
+            if (std::exchange(call_cost, false) || current == static_cast<size_t>(-1)) continue;
+            std::vector<unsigned long long>& counts = report.functions[current].counts;
+            const char* cursor = line.c_str();
+            for (size_t column = 0; *cursor; ++column) {
+                while (*cursor == ' ') ++cursor;
+                if (!*cursor) break;
+                char* end = nullptr;
+                unsigned long long value = std::strtoull(cursor, &end, 0);
+                if (end == cursor) ++end;  // "*" or a lone sign
+                cursor = end;
+                if (column < positions) continue;
+                size_t event = column - positions;
+                if (event < counts.size()) counts[event] += value;
+            }
+            continue;
+        }
+        size_t equals = line.find('=');
+        size_t colon = line.find(':');
+        if (equals != std::string::npos && (colon == std::string::npos || equals < colon)) {
+            std::string key = line.substr(0, equals), value = line.substr(equals + 1);
+            if (key == "fl") {
+                file = expand(file_names, value);
+            } else if (key == "fi" || key == "fe" || key == "cfi" || key == "cfl") {
+                expand(file_names, value);  // Only to learn compressed names; costs stay with the function
+            } else if (key == "fn") {
+                std::string name = expand(function_names, value);
+                auto [at, added] = index.emplace(file + "\n" + name, report.functions.size());
+                if (added) report.functions.push_back({name, file, std::vector<unsigned long long>(report.events.size())});
+                current = at->second;
+            } else if (key == "cfn") {
+                expand(function_names, value);
+            } else if (key == "calls") {
+                call_cost = true;
+            }
+            continue;
+        }
+        if (colon == std::string::npos) continue;
+        std::string key = line.substr(0, colon);
+        std::istringstream values(line.substr(colon + 1));
+        if (key == "events") {
+            report.events.clear();
+            for (std::string event; values >> event;) report.events.push_back(event);
+        } else if (key == "positions") {
+            positions = 0;
+            for (std::string position; values >> position;) ++positions;
+        } else if (key == "cmd") {
+            report.command = line.substr(line.find_first_not_of(' ', colon + 1));
+        } else if (key == "summary" || key == "totals") {
+            report.totals.clear();
+            for (unsigned long long value; values >> value;) report.totals.push_back(value);
+        }
+    }
+    if (report.events.empty()) throw std::runtime_error("not a Cachegrind or Callgrind profile (no events: line)");
+    if (report.totals.empty()) {
+        report.totals.assign(report.events.size(), 0);
+        for (const auto& function : report.functions) {
+            for (size_t i = 0; i < function.counts.size(); ++i) report.totals[i] += function.counts[i];
+        }
+    }
+    return report;
+}
+
+/**
+ * @brief Runs a command under Valgrind's Cachegrind or Callgrind with the
+ * cache simulation on and parses the profile it writes to out_file. The
+ * program's output is discarded. Safe to call from a worker thread.
+ * @param tool "cachegrind" or "callgrind".
+ * @param canceller Optional; lets another thread kill the run.
+ * @return The profile; throws std::runtime_error if Valgrind is missing or
+ * writes no profile.
+ */
+CacheSimReport run_cache_simulation(const std::string& tool, const std::vector<std::string>& command,
+                                    const std::filesystem::path& out_file, BenchmarkCanceller* canceller = nullptr) {
+    if (find_in_path("valgrind").empty()) throw std::runtime_error("valgrind is not installed");
+    std::error_code ignored;
+    std::filesystem::remove(out_file, ignored);
+    SpawnOptions options;
+    options.argv = {"valgrind", "-q", "--tool=" + tool, "--cache-sim=yes", "--" + tool + "-out-file=" + out_file.string()};
+    options.argv.insert(options.argv.end(), command.begin(), command.end());
+    options.stdin_mode = StdioMode::Null;
+    options.stdout_mode = StdioMode::Null;
+    options.stderr_mode = StdioMode::Pipe;
+    ChildProcess child = spawn_process(options);
+    if (canceller) canceller->attach(child.pid);
+    std::string messages = read_all(child.stderr_fd);
+    // Forgotten by the canceller while still a zombie, so a Cancel cannot signal a reused pid
+    siginfo_t info = {};
+    while (waitid(P_PID, static_cast<id_t>(child.pid), &info, WEXITED | WNOWAIT) != 0 && errno == EINTR) {
+    }
+    if (canceller) canceller->detach();
+    int status = child.wait();
+    if (!std::filesystem::exists(out_file)) {
+        throw std::runtime_error(format_command(options.argv) + " wrote no profile (exit code "
+                                 + std::to_string(exit_code_of(status)) + "):\n" + messages.substr(0, 2000));
+    }
+    CacheSimReport report = parse_cachegrind_output(read_text_file(out_file));
+    report.exit_code = exit_code_of(status);
+    return report;
+}
+
+// --- Live Process Output ---
+
+/**
+ * @brief Splits a byte stream into valid UTF-8 for Gtk::TextBuffer.
+ * A multibyte sequence cut by a read boundary is held back until the next
+ * chunk; invalid bytes are replaced with U+FFFD.
+ */
+class Utf8Decoder {
+public:
+    std::string feed(const char* data, size_t size) {
+        pending_.append(data, size);
+        std::string out;
+        out.reserve(pending_.size());
+        size_t i = 0;
+        while (i < pending_.size()) {
+            unsigned char c = static_cast<unsigned char>(pending_[i]);
+            size_t len = c < 0x80 ? 1 : (c >> 5) == 0x6 ? 2 : (c >> 4) == 0xE ? 3 : (c >> 3) == 0x1E ? 4 : 0;
+            if (len == 0) {
+                out += "\xEF\xBF\xBD";
+                ++i;
+                continue;
+            }
+            if (i + len > pending_.size()) break; // Incomplete; wait for more bytes
+            bool valid = true;
+            for (size_t k = 1; k < len; ++k) {
+                if ((static_cast<unsigned char>(pending_[i + k]) & 0xC0) != 0x80) { valid = false; break; }
+            }
+            if (valid && !(len == 1 && c == 0)) {
+                out.append(pending_, i, len);
+                i += len;
+            } else {
+                out += "\xEF\xBF\xBD";
+                ++i;
+            }
+        }
+        pending_.erase(0, i);
+        return out;
+    }
+    /** @brief Flushes a trailing incomplete sequence at end of stream. */
+    std::string finish() {
+        std::string out = pending_.empty() ? "" : "\xEF\xBF\xBD";
+        pending_.clear();
+        return out;
+    }
+
+private:
+    std::string pending_;
+};
+
+/**
+ * @brief Append-only, timestamped record of a run's stdout and stderr.
+ * Bytes of both streams share one contiguous buffer and each read adds a
+ * 24-byte index entry, so the record stays compact and can be replayed in
+ * order. Past kMaxBytes only the index (timing and length) is kept.
+ */
+class OutputRecord {
+public:
+    enum class Stream : unsigned char { Stdout, Stderr };
+
+    struct Chunk {
+        uint64_t t_ns;    // Monotonic time since the run started
+        uint64_t offset;  // Into the byte buffer; kDropped when not retained
+        uint32_t length;
+        Stream stream;
+    };
+
+    static constexpr uint64_t kDropped = ~0ull;
+    static constexpr size_t kMaxBytes = 16u << 20;
+
+    void start(std::chrono::steady_clock::time_point t0) { m_t0 = t0; }
+    std::chrono::steady_clock::time_point started() const { return m_t0; }
+
+    void append(Stream stream, const char* data, size_t size, std::chrono::steady_clock::time_point when) {
+        Chunk chunk;
+        chunk.t_ns = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(when - m_t0).count());
+        chunk.length = static_cast<uint32_t>(size);
+        chunk.stream = stream;
+        if (m_bytes.size() + size <= kMaxBytes) {
+            chunk.offset = m_bytes.size();
+            m_bytes.append(data, size);
+        } else {
+            chunk.offset = kDropped;
+        }
+        m_chunks.push_back(chunk);
+        m_stream_bytes[static_cast<int>(stream)] += size;
+    }
+
+    const std::vector<Chunk>& chunks() const { return m_chunks; }
+    std::string text(const Chunk& chunk) const {
+        return chunk.offset == kDropped ? std::string() : m_bytes.substr(chunk.offset, chunk.length);
+    }
+    uint64_t bytes(Stream stream) const { return m_stream_bytes[static_cast<int>(stream)]; }
+
+    /** @brief Milliseconds from start to the first output on either stream, or -1. */
+    double time_to_first_output_ms() const {
+        return m_chunks.empty() ? -1.0 : m_chunks.front().t_ns / 1e6;
+    }
+
+    /**
+     * @brief Longest silence between output events (including before the first).
+     * @param at_ms Receives when the stall ended, relative to the start.
+     */
+    double longest_stall_ms(double* at_ms = nullptr) const {
+        uint64_t previous = 0, longest = 0, at = 0;
+        for (const auto& chunk : m_chunks) {
+            if (chunk.t_ns - previous > longest) {
+                longest = chunk.t_ns - previous;
+                at = chunk.t_ns;
+            }
+            previous = chunk.t_ns;
+        }
+        if (at_ms) *at_ms = at / 1e6;
+        return longest / 1e6;
+    }
+
+    /** @brief One-line latency summary for the output pane. */
+    std::string summary() const {
+        char line[256];
+        if (m_chunks.empty()) return "No output.";
+        double stall_at = 0.0;
+        double stall = longest_stall_ms(&stall_at);
+        std::snprintf(line, sizeof(line),
+                      "First output after %.1f ms; longest stall %.1f ms (ended at %.1f ms); "
+                      "%zu chunks, %llu B stdout, %llu B stderr.",
+                      time_to_first_output_ms(), stall, stall_at, m_chunks.size(),
+                      static_cast<unsigned long long>(bytes(Stream::Stdout)),
+                      static_cast<unsigned long long>(bytes(Stream::Stderr)));
+        return line;
+    }
+
+private:
+    std::chrono::steady_clock::time_point m_t0 = std::chrono::steady_clock::now();
+    std::string m_bytes;
+    std::vector<Chunk> m_chunks;
+    uint64_t m_stream_bytes[2] = {0, 0};
+};
+
+/**
+ * @brief Supervises a launched run from the GLib main loop.
+ * Both output pipes are made non-blocking and watched with Glib::signal_io, so
+ * output is delivered as soon as it is written, and every read is timestamped
+ * into an OutputRecord. The child is reaped when its pidfd becomes readable
+ * (or by polling where pidfds are unavailable), so no thread ever blocks on
+ * it. Runs get their own process group so stop/kill and limits reach every
+ * process they started. on_exit runs once both streams have reached EOF and
+ * the child has been reaped.
+ */
+class ProcessSupervisor {
+public:
+    /** @brief A run's resource envelope; 0 means unlimited. */
+    struct Limits {
+        unsigned wall_seconds = 0;
+        unsigned cpu_seconds = 0;       // Enforced by the kernel through RLIMIT_CPU
+        unsigned address_space_mb = 0;  // RLIMIT_AS
+        double cgroup_cpus = 0.0;       // cgroup v2 cpu.max, in CPUs
+        unsigned cgroup_memory_mb = 0;  // cgroup v2 memory.max
+
+        std::string describe() const {
+            std::vector<std::string> parts;
+            if (wall_seconds) parts.push_back("wall " + std::to_string(wall_seconds) + " s");
+            if (cpu_seconds) parts.push_back("CPU time " + std::to_string(cpu_seconds) + " s");
+            if (address_space_mb) parts.push_back("address space " + std::to_string(address_space_mb) + " MiB");
+            if (cgroup_cpus > 0) {
+                char cpus[32];
+                std::snprintf(cpus, sizeof(cpus), "%.2f CPUs", cgroup_cpus);
+                parts.push_back(cpus);
+            }
+            if (cgroup_memory_mb) parts.push_back("memory " + std::to_string(cgroup_memory_mb) + " MiB");
+            if (parts.empty()) return "unlimited";
+            std::string text;
+            for (const auto& part : parts) text += (text.empty() ? "" : ", ") + part;
+            return text;
+        }
+
+        JsonValue to_json_value() const {
+            return JsonValue::make_object()
+                .set("wall_s", wall_seconds)
+                .set("cpu_s", cpu_seconds)
+                .set("address_space_mb", address_space_mb)
+                .set("cgroup_cpus", cgroup_cpus)
+                .set("cgroup_memory_mb", cgroup_memory_mb);
+        }
+    };
+
+    std::function<void(OutputRecord::Stream, const std::string&)> on_output;
+    std::function<void(int status)> on_exit;
+    // Called with the time from send_input() to the first stdout output after the input was written, once shown
+    std::function<void(double ms)> on_response;
+
+    ProcessSupervisor() = default;
+    ProcessSupervisor(const ProcessSupervisor&) = delete;
+    ProcessSupervisor& operator=(const ProcessSupervisor&) = delete;
+    ~ProcessSupervisor() {
+        for (auto& stream : m_streams) stream.connection.disconnect();
+        m_exit_connection.disconnect();
+        m_limit_connection.disconnect();
+        m_drain_connection.disconnect();
+        m_heap_connection.disconnect();
+        m_input_connection.disconnect();
+        if (!m_reaped && m_child.pid > 0) {
+            // The launcher is going away; do not leave the run behind.
+            signal_run(SIGKILL);
+            m_child.wait();
+        }
+    }
+
+    /**
+     * @brief Sets up a run's envelope before it is spawned.
+     * Puts the child in its own process group and sets RLIMIT_CPU (the kernel
+     * sends SIGXCPU at the limit and SIGKILL one second later) and RLIMIT_AS.
+     * CPU and memory caps need a delegated cgroup v2 subtree; without one they
+     * are dropped from the envelope.
+     * @return A warning about parts of the envelope that could not be applied, or "".
+     */
+    std::string prepare(SpawnOptions& options, const Limits& limits) {
+        m_limits = limits;
+        options.new_process_group = true;
+        if (limits.cpu_seconds) {
+            options.rlimits.push_back({RLIMIT_CPU, limits.cpu_seconds, limits.cpu_seconds + 1});
+        }
+        if (limits.address_space_mb) {
+            rlim_t bytes = static_cast<rlim_t>(limits.address_space_mb) << 20;
+            options.rlimits.push_back({RLIMIT_AS, bytes, bytes});
+        }
+        if (limits.cgroup_cpus <= 0 && !limits.cgroup_memory_mb) return "";
+        std::string warning;
+        const std::filesystem::path& root = cgroup_delegation_root();
+        if (root.empty()) {
+            warning = "no delegated cgroup v2 subtree (set BOREDAF_CGROUP_ROOT, or start the launcher with "
+                      "systemd-run --user --scope -p Delegate=yes and BOREDAF_CGROUP_MOVE_LAUNCHER=1); "
+                      "CPU and memory caps not applied";
+        } else {
+            try {
+                m_cgroup = std::make_unique<RunCgroup>(root, limits.cgroup_cpus, limits.cgroup_memory_mb);
+                options.cgroup = m_cgroup->path();
+            } catch (const std::exception& e) {
+                warning = std::string(e.what()) + "; CPU and memory caps not applied";
+            }
+        }
+        if (!m_cgroup) {
+            m_limits.cgroup_cpus = 0.0;
+            m_limits.cgroup_memory_mb = 0;
+        }
+        return warning;
+    }
+
+    /**
+     * @brief Counts hardware events of the run (see PerfCounters).
+     * Call before spawning with the same options; check counters_error() afterwards.
+     */
+    void enable_counters(SpawnOptions& options) {
+        m_counters = std::make_unique<PerfCounters>();
+        add_before_exec(options, [counters = m_counters.get()](pid_t pid, bool held) { counters->attach(pid, held); });
+    }
+
+    /** @brief Why counters requested with enable_counters() are missing, or "". */
+    std::string counters_error() const { return m_counters ? m_counters->error() : ""; }
+
+    /**
+     * @brief Samples the run's call stacks: with `perf record -p` (see PerfRecorder) if perf
+     * is installed and can attach, else with the built-in StackSampler. Either way the
+     * run itself stays the supervised process.
+     * Call before spawning with the same options; check sampler_error() afterwards.
+     * @param perf_output Where perf writes its samples; empty to use only the built-in sampler.
+     */
+    void enable_sampler(SpawnOptions& options, const std::filesystem::path& perf_output = {}) {
+        m_sampler = std::make_unique<StackSampler>();
+        if (!perf_output.empty() && !find_in_path("perf").empty()) m_perf = std::make_unique<PerfRecorder>(perf_output);
+        add_before_exec(options, [sampler = m_sampler.get(), perf = m_perf.get()](pid_t pid, bool held) {
+            if (!perf || !perf->start(pid)) sampler->attach(pid, held);
+        });
+    }
+
+    /** @brief Why sampling requested with enable_sampler() is not happening, or "". */
+    std::string sampler_error() const {
+        if (m_perf && m_perf->started()) return "";
+        return m_sampler ? m_sampler->error() : "";
+    }
+
+    /** @brief What sampled the run: "perf record" or "perf_event_open". */
+    std::string stack_source() const { return m_perf && m_perf->started() ? "perf record" : "perf_event_open"; }
+
+    /**
+     * @brief Hands over the run's samples, once on_exit has run, if enable_sampler() was used.
+     * Folding symbolises with nm or runs perf script, so call the result on a worker thread.
+     */
+    std::function<FoldedStacks()> take_stack_folder() {
+        if (m_perf && m_perf->started()) {
+            return [perf = std::shared_ptr<PerfRecorder>(std::move(m_perf))]() { return perf->fold(); };
+        }
+        if (m_sampler) return [sampler = std::shared_ptr<StackSampler>(std::move(m_sampler))]() { return sampler->fold(); };
+        return {};
+    }
+
+    /**
+     * @brief Hands over the run's heap profile, once on_exit has run, if enable_heap_profile() was used.
+     * Reporting symbolises the sampled stacks with nm, so call the result on a worker thread.
+     */
+    std::function<HeapReport()> take_heap_reporter() {
+        if (!m_heap) return {};
+        return [heap = std::shared_ptr<HeapProfiler>(std::move(m_heap))]() { return heap->report(); };
+    }
+
+    /**
+     * @brief Profiles the run's heap allocations (see HeapProfiler).
+     * Call before spawning with the same options; throws std::runtime_error
+     * if the interposer cannot be built.
+     */
+    void enable_heap_profile(SpawnOptions& options) {
+        auto heap = std::make_unique<HeapProfiler>();
+        heap->prepare(options);
+        m_heap = std::move(heap);
+    }
+
+    /**
+     * @brief Takes ownership of a child whose stdout/stderr are pipes and starts supervising it.
+     * @param child The spawned child, set up by prepare().
+     * @param started When the child was spawned; chunk timestamps are relative to it.
+     */
+    void start(ChildProcess child, std::chrono::steady_clock::time_point started) {
+        m_child = std::move(child);
+        m_pid_for_display = m_child.pid;
+        m_group = getpgid(m_child.pid) == m_child.pid;
+        m_record.start(started);
+        m_running = true;
+        if (m_limits.wall_seconds) {
+            m_limit_connection = Glib::signal_timeout().connect([this]() {
+                m_reason = "wall-clock limit";
+                stop();
+                return false;
+            }, m_limits.wall_seconds * 1000);
+        }
+        if (m_sampler) {
+            m_drain_connection = Glib::signal_timeout().connect([this]() {
+                m_sampler->drain();
+                return true;
+            }, kSampleDrainMs);
+        }
+        if (m_heap) {
+            m_heap_connection = Glib::signal_io().connect([this](Glib::IOCondition) {
+                m_heap->drain();
+                return true;
+            }, m_heap->fd(), Glib::IO_IN);
+        }
+        m_streams[0].fd = std::exchange(m_child.stdout_fd, -1);
+        m_streams[1].fd = std::exchange(m_child.stderr_fd, -1);
+        if (m_child.stdin_fd >= 0) fcntl(m_child.stdin_fd, F_SETFL, fcntl(m_child.stdin_fd, F_GETFL) | O_NONBLOCK);
+        for (int i = 0; i < 2; ++i) {
+            StreamState& stream = m_streams[i];
+            stream.id = static_cast<OutputRecord::Stream>(i);
+            if (stream.fd < 0) {
+                stream.done = true;
+                continue;
+            }
+            fcntl(stream.fd, F_SETFL, fcntl(stream.fd, F_GETFL) | O_NONBLOCK);
+            stream.connection = Glib::signal_io().connect(
+                [this, i](Glib::IOCondition) { return on_readable(m_streams[i]); }, stream.fd,
+                Glib::IO_IN | Glib::IO_HUP | Glib::IO_ERR);
+        }
+        if (m_child.pidfd >= 0) {
+            m_exit_connection = Glib::signal_io().connect(
+                sigc::mem_fun(*this, &ProcessSupervisor::on_pidfd), m_child.pidfd, Glib::IO_IN);
+        } else {
+            m_exit_connection = Glib::signal_timeout().connect(
+                sigc::mem_fun(*this, &ProcessSupervisor::poll_exit), kExitPollMs);
+        }
+    }
+
+    bool running() const { return m_running; }
+    pid_t pid() const { return m_pid_for_display; }
+    const OutputRecord& record() const { return m_record; }
+    /** @brief Resources used; valid once on_exit has run. */
+    const RunUsage& usage() const { return m_usage; }
+    /** @brief The envelope the run was started in, as actually applied. */
+    const Limits& envelope() const { return m_limits; }
+    /** @brief Input-to-response latencies so far, in milliseconds. */
+    const std::vector<double>& response_latencies() const { return m_response_latencies; }
+
+    /**
+     * @brief Writes to the run's stdin (its terminal for pty runs).
+     * What the pipe cannot take now is queued and written as the run reads.
+     * @param typed When the user entered the input; the response latency is measured from
+     * here to the first stdout (or terminal) output read after the last byte was written.
+     * Output that was already waiting when the input was sent is shown first and not counted.
+     * @return False if the run takes no more input or too much is already queued.
+     */
+    bool send_input(const std::string& text, std::chrono::steady_clock::time_point typed) {
+        if (m_child.stdin_fd < 0 || m_close_after_input) return false;
+        if (m_pending_input.size() + text.size() > kMaxPendingInput) return false;
+        if (m_pending_input.empty() && !m_streams[0].done && !on_readable(m_streams[0])) {
+            m_streams[0].connection.disconnect();
+        }
+        m_pending_input += text;
+        m_input_typed = typed;
+        m_awaiting_response = false;
+        write_pending_input();
+        return m_child.stdin_fd >= 0;
+    }
+
+    /**
+     * @brief Signals end of input: closes the stdin pipe, or sends the EOF character to a terminal.
+     * Input still queued is written first.
+     * @return False if the run takes no more input.
+     */
+    bool close_input() {
+        if (m_child.stdin_fd < 0 || m_close_after_input) return false;
+        if (m_child.pty) {
+            struct termios attributes;
+            m_pending_input += tcgetattr(m_child.stdin_fd, &attributes) == 0 ? static_cast<char>(attributes.c_cc[VEOF])
+                                                                             : '\x04';
+        } else {
+            m_close_after_input = true;
+        }
+        write_pending_input();
+        return true;
+    }
+
+    /**
+     * @brief Asks the run to exit: SIGTERM to its process group, then SIGKILL
+     * if it is still alive after a grace period.
+     */
+    void stop() {
+        if (m_reaped) return;
+        if (m_reason.empty()) m_reason = "stopped";
+        signal_run(SIGTERM);
+        m_limit_connection.disconnect();
+        m_limit_connection = Glib::signal_timeout().connect([this]() {
+            kill();
+            return false;
+        }, kStopGraceMs);
+    }
+
+    /** @brief Sends SIGKILL to the run's process group. */
+    void kill() {
+        if (m_reaped) return;
+        if (m_reason.empty()) m_reason = "killed";
+        signal_run(SIGKILL);
+    }
+
+    /**
+     * @brief Why the run ended, if not on its own ("wall-clock limit",
+     * "CPU-time limit", "memory limit (OOM)", "stopped", "killed"); empty otherwise.
+     */
+    const std::string& termination_reason() const { return m_reason; }
+
+private:
+    // Bytes read per main-loop dispatch, so a chatty child cannot starve the UI
+    static constexpr size_t kReadBudget = 256 * 1024;
+    static constexpr unsigned kExitPollMs = 50;
+    static constexpr unsigned kOrphanedOutputGraceMs = 1000;
+    static constexpr unsigned kStopGraceMs = 3000;
+    static constexpr unsigned kSampleDrainMs = 100;
+    static constexpr size_t kMaxPendingInput = 1 << 20;
+
+    struct StreamState {
+        int fd = -1;
+        OutputRecord::Stream id = OutputRecord::Stream::Stdout;
+        Utf8Decoder decoder;
+        sigc::connection connection;
+        bool done = false;
+    };
+
+    ChildProcess m_child;
+    pid_t m_pid_for_display = -1;
+    StreamState m_streams[2];
+    OutputRecord m_record;
+    sigc::connection m_exit_connection;
+    sigc::connection m_limit_connection;
+    sigc::connection m_drain_connection;
+    sigc::connection m_heap_connection;
+    Limits m_limits;
+    std::unique_ptr<RunCgroup> m_cgroup;
+    std::unique_ptr<PerfCounters> m_counters;
+    std::unique_ptr<StackSampler> m_sampler;
+    std::unique_ptr<PerfRecorder> m_perf;
+    std::unique_ptr<HeapProfiler> m_heap;
+    RunUsage m_usage;
+    std::string m_reason;
+    std::chrono::steady_clock::time_point m_input_typed;
+    std::string m_pending_input;      // Input the pipe has not taken yet
+    sigc::connection m_input_connection;
+    bool m_close_after_input = false; // close_input() was called while input was queued
+    bool m_awaiting_response = false;
+    std::vector<double> m_response_latencies;
+    bool m_group = false;
+    bool m_running = false;
+    bool m_reaped = false;
+    int m_status = -1;
+
+    /** @brief Runs a hook in addition to any already set, as spawning takes only one. */
+    static void add_before_exec(SpawnOptions& options, std::function<void(pid_t, bool)> hook) {
+        options.before_exec = [previous = std::move(options.before_exec), hook](pid_t pid, bool held) {
+            if (previous) previous(pid, held);
+            hook(pid, held);
+        };
+    }
+
+    void signal_run(int sig) {
+        if (m_group) {
+            ::kill(-m_pid_for_display, sig);
+            return;
+        }
+#ifdef SYS_pidfd_send_signal
+        if (m_child.pidfd >= 0 && syscall(SYS_pidfd_send_signal, m_child.pidfd, sig, nullptr, 0) == 0) return;
+#endif
+        ::kill(m_child.pid, sig);
+    }
+
+    /** @brief Writes queued input; watches for the pipe to drain while some is left. */
+    bool write_pending_input() {
+        while (!m_pending_input.empty()) {
+            ssize_t n = ::write(m_child.stdin_fd, m_pending_input.data(), m_pending_input.size());
+            if (n > 0) {
+                m_pending_input.erase(0, static_cast<size_t>(n));
+            } else if (n < 0 && errno == EINTR) {
+                continue;
+            } else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                if (!m_input_connection.connected()) {
+                    m_input_connection = Glib::signal_io().connect(
+                        [this](Glib::IOCondition) { return write_pending_input(); }, m_child.stdin_fd,
+                        Glib::IO_OUT | Glib::IO_ERR | Glib::IO_HUP);
+                }
+                return true;
+            } else {
+                // EPIPE: the run closed its input
+                m_pending_input.clear();
+                m_input_connection.disconnect();
+                ChildProcess::close_fd(m_child.stdin_fd);
+                return false;
+            }
+        }
+        m_input_connection.disconnect();
+        m_awaiting_response = true;
+        if (m_close_after_input) ChildProcess::close_fd(m_child.stdin_fd);
+        return false;
+    }
+
+    bool on_readable(StreamState& stream) {
+        char buffer[16384];
+        size_t total = 0;
+        while (total < kReadBudget) {
+            ssize_t n = ::read(stream.fd, buffer, sizeof(buffer));
+            if (n > 0) {
+                total += static_cast<size_t>(n);
+                m_record.append(stream.id, buffer, static_cast<size_t>(n), std::chrono::steady_clock::now());
+                std::string text = stream.decoder.feed(buffer, static_cast<size_t>(n));
+                if (!text.empty() && on_output) on_output(stream.id, text);
+                if (m_awaiting_response && stream.id == OutputRecord::Stream::Stdout) {
+                    // Measured after on_output, so the time to display the response is included
+                    m_awaiting_response = false;
+                    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - m_input_typed).count();
+                    m_response_latencies.push_back(ms);
+                    if (on_response) on_response(ms);
+                }
+                continue;
+            }
+            if (n < 0 && errno == EINTR) continue;
+            if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return true;
+            // EOF or error: the child closed its end
+            close_stream(stream);
+            maybe_finish();
+            return false;
+        }
+        return true;
+    }
+
+    void close_stream(StreamState& stream) {
+        std::string tail = stream.decoder.finish();
+        if (!tail.empty() && on_output) on_output(stream.id, tail);
+        ChildProcess::close_fd(stream.fd);
+        stream.done = true;
+    }
+
+    bool on_pidfd(Glib::IOCondition) {
+        reap();
+        return false;
+    }
+
+    bool poll_exit() {
+        // WNOWAIT leaves the zombie in place so /proc/<pid>/io can still be read
+        siginfo_t info = {};
+        if (waitid(P_PID, static_cast<id_t>(m_child.pid), &info, WEXITED | WNOHANG | WNOWAIT) != 0 || info.si_pid == 0) {
+            return true;
+        }
+        reap();
+        return false;
+    }
+
+    void reap() {
+        m_usage.read_proc_io(m_child.pid);
+        // Whatever the run left behind in its process group goes with it. Done while the
+        // leader is still an unreaped zombie, which keeps its pid and so the group id from being reused.
+        if (m_group) ::kill(-m_pid_for_display, SIGTERM);
+        struct rusage usage = {};
+        m_status = m_child.wait(&usage);
+        m_usage.set_rusage(usage);
+        if (m_cgroup) m_cgroup->read_events(m_usage);
+        if (m_counters) m_counters->read_into(m_usage);
+        // Samples are folded and heap stacks symbolised by whoever takes them
+        // (take_stack_folder(), take_heap_reporter()), off the GTK thread
+        m_drain_connection.disconnect();
+        if (m_heap) {
+            m_heap_connection.disconnect();
+            m_heap->drain();
+        }
+        m_usage.wall_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - m_record.started()).count();
+        mark_reaped();
+    }
+
+    void mark_reaped() {
+        m_reaped = true;
+        m_limit_connection.disconnect();
+        if (m_reason.empty() && m_usage.oom_kills && WIFSIGNALED(m_status) && WTERMSIG(m_status) == SIGKILL) {
+            m_reason = "memory limit (OOM)";
+        }
+        if (m_reason.empty() && m_limits.cpu_seconds && WIFSIGNALED(m_status)) {
+            // SIGXCPU comes only from the soft limit. SIGKILL is the hard limit (soft + 1 s) only if
+            // the run really used that much CPU; otherwise someone else killed it. The tolerance
+            // covers the microsecond rounding of rusage.
+            double cpu = m_usage.user_seconds + m_usage.system_seconds;
+            if (WTERMSIG(m_status) == SIGXCPU ||
+                (WTERMSIG(m_status) == SIGKILL && cpu + 0.01 >= m_limits.cpu_seconds + 1.0)) {
+                m_reason = "CPU-time limit";
+            }
+        }
+        if (!m_streams[0].done || !m_streams[1].done) {
+            // A background grandchild may hold a pipe open; stop waiting for
+            // EOF shortly after the child itself is gone.
+            m_exit_connection = Glib::signal_timeout().connect([this]() {
+                for (auto& stream : m_streams) {
+                    if (stream.done) continue;
+                    stream.connection.disconnect();
+                    if (on_readable(stream)) close_stream(stream);
+                }
+                maybe_finish();
+                return false;
+            }, kOrphanedOutputGraceMs);
+        }
+        maybe_finish();
+    }
+
+    void maybe_finish() {
+        if (!m_streams[0].done || !m_streams[1].done || !m_reaped || !m_running) return;
+        m_running = false;
+        m_input_connection.disconnect();
+        m_child.close_fds();
+        if (on_exit) on_exit(m_status);
+    }
+};
+
+// Structure to hold project details
+struct Project {
+    std::string name;    // Display name in the launcher
+    std::string type;    // "C++", "HTML"
+    std::string path;    // Path to the project's main executable/HTML file after extraction
+};
+
+// Global variable to store the extraction target directory
+std::filesystem::path g_extraction_target_dir;
+
+// --- Background Work ---
+
+/**
+ * @brief Runs one-off jobs on worker threads and their results on the main loop.
+ * A job returns the completion to run on the GTK thread, which it hands back
+ * through a Glib::Dispatcher; jobs must catch their own exceptions. Create and
+ * destroy on the GTK thread; destruction waits for jobs still running.
+ */
+class BackgroundTasks {
+public:
+    BackgroundTasks() { m_dispatcher.connect(sigc::mem_fun(*this, &BackgroundTasks::on_finished)); }
+    BackgroundTasks(const BackgroundTasks&) = delete;
+    BackgroundTasks& operator=(const BackgroundTasks&) = delete;
+    ~BackgroundTasks() {
+        for (auto& task : m_tasks) task.thread.join();
+    }
+
+    void run(std::function<std::function<void()>()> job) {
+        m_tasks.emplace_back();
+        Task& task = m_tasks.back();
+        task.thread = std::thread([this, &task, job = std::move(job)]() {
+            std::function<void()> done = job();
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                task.done = std::move(done);
+                task.finished = true;
+            }
+            m_dispatcher.emit();
+        });
+    }
+
+private:
+    struct Task {
+        std::thread thread;
+        std::function<void()> done;
+        bool finished = false;
+    };
+
+    std::list<Task> m_tasks;  // Nodes stay put while their thread fills them in
+    std::mutex m_mutex;       // Guards done and finished
+    Glib::Dispatcher m_dispatcher;
+
+    void on_finished() {
+        std::list<Task> finished;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            for (auto it = m_tasks.begin(); it != m_tasks.end();) {
+                auto next = std::next(it);
+                if (it->finished) finished.splice(finished.end(), m_tasks, it);
+                it = next;
+            }
+        }
+        for (auto& task : finished) {
+            task.thread.join();
+            if (task.done) task.done();
+        }
+    }
+};
+
+/**
+ * @brief The one long-running job a window runs at a time: its worker thread,
+ * cancellation, progress and the updates it hands back, all delivered on the
+ * main loop through a Glib::Dispatcher. Updates posted by the worker run in
+ * order, and all of them before the done callback. Declare it after every
+ * member its callbacks use, so that it is destroyed (cancelling and joining
+ * the worker) first.
+ */
+class BackgroundJob {
+public:
+    // Called on the main loop with the worker's latest progress report
+    std::function<void(const std::string& text, double fraction)> on_progress;
+
+    BackgroundJob() { m_dispatcher.connect(sigc::mem_fun(*this, &BackgroundJob::on_update)); }
+    BackgroundJob(const BackgroundJob&) = delete;
+    BackgroundJob& operator=(const BackgroundJob&) = delete;
+    ~BackgroundJob() {
+        m_canceller.cancel();
+        if (m_worker.joinable()) m_worker.join();
+    }
+
+    bool busy() const { return m_worker.joinable(); }
+
+    /**
+     * @brief Runs work on a new worker thread; ignored while a job is running.
+     * @param done Called on the main loop afterwards, with the message of the
+     * std::exception work threw, or "" if it returned.
+     */
+    void start(std::function<void()> work, std::function<void(const std::string& error)> done) {
+        if (busy()) return;
+        m_canceller.reset();
+        m_done = std::move(done);
+        m_worker = std::thread([this, work = std::move(work)]() {
+            std::string error;
+            try {
+                work();
+            } catch (const std::exception& e) {
+                error = e.what();
+            }
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_finished = true;
+                m_error = error;
+            }
+            m_dispatcher.emit();
+        });
+    }
+
+    void cancel() { m_canceller.cancel(); }
+    bool cancelled() const { return m_canceller.cancelled(); }
+    /** @brief For measure_run() and the like, so cancel() also kills the current run. */
+    BenchmarkCanceller& canceller() { return m_canceller; }
+
+    /** @brief Worker side: reports progress; only the latest report is shown. */
+    void progress(const std::string& text, double fraction) {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_progress_text = text;
+            m_progress_fraction = fraction;
+            m_progress_changed = true;
+        }
+        m_dispatcher.emit();
+    }
+
+    /** @brief Worker side: runs update on the main loop, e.g. to hand over a result. */
+    void post(std::function<void()> update) {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_updates.push_back(std::move(update));
+        }
+        m_dispatcher.emit();
+    }
+
+private:
+    std::thread m_worker;
+    Glib::Dispatcher m_dispatcher;
+    BenchmarkCanceller m_canceller;
+    std::function<void(const std::string&)> m_done;
+    std::mutex m_mutex;  // Guards the fields below
+    std::vector<std::function<void()>> m_updates;
+    std::string m_progress_text;
+    double m_progress_fraction = 0.0;
+    bool m_progress_changed = false;
+    bool m_finished = false;
+    std::string m_error;
+
+    void on_update() {
+        std::vector<std::function<void()>> updates;
+        std::string text;
+        double fraction;
+        bool progressed, finished;
+        std::string error;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            updates = std::move(m_updates);
+            m_updates.clear();
+            text = m_progress_text;
+            fraction = m_progress_fraction;
+            progressed = std::exchange(m_progress_changed, false);
+            finished = std::exchange(m_finished, false);
+            error = m_error;
+        }
+        if (progressed && on_progress) on_progress(text, fraction);
+        for (auto& update : updates) update();
+        if (!finished) return;
+        m_worker.join();
+        if (auto done = std::move(m_done)) done(error);
+    }
+};
+
+// --- Cloning Status Window ---
+class CloningStatusWindow : public Gtk::Window {
+public:
+    struct RepoStatus {
+        std::string name;
+        Gtk::Label* label;
+    };
+    CloningStatusWindow(const std::vector<std::string>& repo_names)
+    : vbox(Gtk::ORIENTATION_VERTICAL) {
+        set_title("Cloning Projects...");
+        set_default_size(400, 300);
+        set_position(Gtk::WIN_POS_CENTER);
+        vbox.set_spacing(10);
+        vbox.set_margin_top(20);
+        vbox.set_margin_bottom(20);
+        vbox.set_margin_start(20);
+        vbox.set_margin_end(20);
+        add(vbox);
+        auto title = Gtk::make_managed<Gtk::Label>("<b>Cloning Repositories</b>");
+        title->set_use_markup(true);
+        title->set_halign(Gtk::ALIGN_CENTER);
+        vbox.pack_start(*title, Gtk::PACK_SHRINK);
+        for (const auto& name : repo_names) {
+            auto label = Gtk::make_managed<Gtk::Label>(name + ": <span foreground='blue'>Cloning...</span>");
+            label->set_use_markup(true);
+            label->set_halign(Gtk::ALIGN_START);
+            vbox.pack_start(*label, Gtk::PACK_SHRINK);
+            repo_status_.push_back({name, label});
+        }
+        show_all_children();
+    }
+    void set_status(size_t idx, bool success) {
+        if (idx >= repo_status_.size()) return;
+        std::string color = success ? "green" : "red";
+        std::string msg = success ? "Cloned" : "Failed";
+        repo_status_[idx].label->set_markup(repo_status_[idx].name + ": <span foreground='" + color + "'>" + msg + "</span>");
+    }
+private:
+    Gtk::Box vbox;
+    std::vector<RepoStatus> repo_status_;
+};
+
+class TempDirCleanup {
+public:
+    TempDirCleanup(const std::filesystem::path& path_to_clean)
+        : path_to_clean_(path_to_clean) {}
+    ~TempDirCleanup() {
+        if (std::filesystem::exists(path_to_clean_)) {
+            std::cout << "Cleaning up temporary directory: " << path_to_clean_ << std::endl;
+            std::error_code ec;
+            std::filesystem::remove_all(path_to_clean_, ec);
+            if (ec) {
+                std::cerr << "Error cleaning up temporary directory: " << ec.message() << std::endl;
+            }
+        }
+    }
+private:
+    std::filesystem::path path_to_clean_;
+};
+
+/**
+ * @brief Asks the user for a destination file.
+ * @param parent Window the dialog is transient for.
+ * @param title Dialog title.
+ * @param suggested_name Initial file name.
+ * @return The chosen path, or an empty string if cancelled.
+ */
+std::string choose_save_path(Gtk::Window& parent, const std::string& title, const std::string& suggested_name) {
+    Gtk::FileChooserDialog dialog(parent, title, Gtk::FILE_CHOOSER_ACTION_SAVE);
+    dialog.add_button("_Cancel", Gtk::RESPONSE_CANCEL);
+    dialog.add_button("_Save", Gtk::RESPONSE_OK);
+    dialog.set_current_name(suggested_name);
+    dialog.set_do_overwrite_confirmation(true);
+    if (dialog.run() != Gtk::RESPONSE_OK) return "";
+    return dialog.get_filename();
+}
+
+// --- Compile-Time Report Window ---
+/**
+ * @brief Shows the most expensive phases, headers and template instantiations
+ * of a profiled build, with JSON export.
+ */
+class CompileTimeReportWindow : public Gtk::Window {
+public:
+    CompileTimeReportWindow() : m_vbox(Gtk::ORIENTATION_VERTICAL) {
+        set_title("Build Profile");
+        set_default_size(700, 450);
+        m_vbox.set_spacing(6);
+        m_vbox.set_border_width(10);
+        add(m_vbox);
+        m_summary.set_halign(Gtk::ALIGN_START);
+        m_vbox.pack_start(m_summary, Gtk::PACK_SHRINK);
+        m_vbox.pack_start(m_notebook, Gtk::PACK_EXPAND_WIDGET);
+        add_tab(m_phases, "Phases");
+        add_tab(m_headers, "Headers");
+        add_tab(m_templates, "Templates");
+        auto export_btn = Gtk::make_managed<Gtk::Button>("Export JSON...");
+        export_btn->set_halign(Gtk::ALIGN_END);
+        export_btn->signal_clicked().connect([this]() {
+            std::string path = choose_save_path(*this, "Export Build Profile", "build-profile.json");
+            if (!path.empty()) write_text_file(path, to_json(m_report.to_json_value(0)) + "\n");
+        });
+        m_vbox.pack_start(*export_btn, Gtk::PACK_SHRINK);
+        show_all_children();
+    }
+
+    void set_report(const CompileTimeReport& report) {
+        m_report = report;
+        char total[64];
+        std::snprintf(total, sizeof(total), "%.1f ms", report.total_ms);
+        m_summary.set_text(std::to_string(report.translation_units.size()) + " translation unit(s), total " + total
+                           + (report.headers.empty() ? "  (per-header costs require clang -ftime-trace)" : ""));
+        fill(m_phases, report.phases);
+        fill(m_headers, report.headers);
+        fill(m_templates, report.templates);
+    }
+
+private:
+    // Only this many rows are shown per table; the JSON export has everything
+    static constexpr size_t kMaxRows = 500;
+
+    struct Columns : public Gtk::TreeModel::ColumnRecord {
+        Columns() { add(name); add(total_ms); add(count); }
+        Gtk::TreeModelColumn<Glib::ustring> name;
+        Gtk::TreeModelColumn<double> total_ms;
+        Gtk::TreeModelColumn<unsigned> count;
+    };
+    struct Table {
+        Glib::RefPtr<Gtk::ListStore> store;
+        Gtk::TreeView view;
+        Gtk::ScrolledWindow scroll;
+    };
+
+    Gtk::Box m_vbox;
+    Gtk::Label m_summary;
+    Gtk::Notebook m_notebook;
+    Columns m_columns;
+    Table m_phases, m_headers, m_templates;
+    CompileTimeReport m_report;
+
+    void add_tab(Table& table, const std::string& title) {
+        table.store = Gtk::ListStore::create(m_columns);
+        table.store->set_sort_column(m_columns.total_ms, Gtk::SORT_DESCENDING);
+        table.view.set_model(table.store);
+        table.view.append_column("Name", m_columns.name);
+        table.view.append_column("Time (ms)", m_columns.total_ms);
+        table.view.append_column("Count", m_columns.count);
+        table.view.get_column(0)->set_expand(true);
+        table.view.get_column(0)->set_sort_column(m_columns.name);
+        table.view.get_column(1)->set_sort_column(m_columns.total_ms);
+        table.view.get_column(2)->set_sort_column(m_columns.count);
+        table.scroll.set_policy(Gtk::POLICY_AUTOMATIC, Gtk::POLICY_AUTOMATIC);
+        table.scroll.add(table.view);
+        m_notebook.append_page(table.scroll, title);
+    }
+
+    void fill(Table& table, const std::map<std::string, CompileTimeReport::Entry>& bucket) {
+        table.store->clear();
+        for (const auto& entry : CompileTimeReport::top(bucket, kMaxRows)) {
+            Gtk::TreeModel::Row row = *table.store->append();
+            row[m_columns.name] = entry.name;
+            row[m_columns.total_ms] = entry.total_ms;
+            row[m_columns.count] = entry.count;
+        }
+    }
+};
+
+// --- Run History Window ---
+/**
+ * @brief Lists every finished run with its resource usage.
+ */
+class RunHistoryWindow : public Gtk::Window {
+public:
+    RunHistoryWindow() {
+        set_title("Run History");
+        set_default_size(900, 350);
+        m_store = Gtk::ListStore::create(m_columns);
+        m_treeview.set_model(m_store);
+        m_treeview.append_column("Started", m_columns.started);
+        m_treeview.append_column("Project", m_columns.project);
+        m_treeview.append_column("Commit", m_columns.commit);
+        m_treeview.append_column("Exit", m_columns.exit_code);
+        m_treeview.append_column("Envelope", m_columns.envelope);
+        m_treeview.append_column("Wall (s)", m_columns.wall);
+        m_treeview.append_column("User (s)", m_columns.user);
+        m_treeview.append_column("Sys (s)", m_columns.system);
+        m_treeview.append_column("Max RSS (KiB)", m_columns.max_rss);
+        m_treeview.append_column("Minor faults", m_columns.minor_faults);
+        m_treeview.append_column("Major faults", m_columns.major_faults);
+        m_treeview.append_column("Ctx switches", m_columns.switches);
+        m_treeview.append_column("Read", m_columns.read);
+        m_treeview.append_column("Written", m_columns.written);
+        m_treeview.append_column("IPC", m_columns.ipc);
+        m_treeview.get_column(5)->set_sort_column(m_columns.wall);
+        m_treeview.get_column(6)->set_sort_column(m_columns.user);
+        m_treeview.get_column(8)->set_sort_column(m_columns.max_rss);
+        m_scrolledwindow.set_policy(Gtk::POLICY_AUTOMATIC, Gtk::POLICY_AUTOMATIC);
+        m_scrolledwindow.add(m_treeview);
+        add(m_scrolledwindow);
+        show_all_children();
+    }
+
+    void add_entry(const RunHistoryEntry& entry) {
+        Gtk::TreeModel::Row row = *m_store->append();
+        std::time_t started = std::chrono::system_clock::to_time_t(entry.started);
+        char time_text[32];
+        std::strftime(time_text, sizeof(time_text), "%Y-%m-%d %H:%M:%S", std::localtime(&started));
+        row[m_columns.started] = time_text;
+        row[m_columns.project] = entry.project;
+        row[m_columns.commit] = entry.commit.substr(0, 12);
+        row[m_columns.exit_code] = std::to_string(entry.exit_code) + (entry.reason.empty() ? "" : " (" + entry.reason + ")");
+        row[m_columns.envelope] = entry.envelope;
+        row[m_columns.wall] = entry.usage.wall_seconds;
+        row[m_columns.user] = entry.usage.user_seconds;
+        row[m_columns.system] = entry.usage.system_seconds;
+        row[m_columns.max_rss] = entry.usage.max_rss_kb;
+        row[m_columns.minor_faults] = entry.usage.minor_faults;
+        row[m_columns.major_faults] = entry.usage.major_faults;
+        row[m_columns.switches] = entry.usage.voluntary_switches + entry.usage.involuntary_switches;
+        row[m_columns.read] = entry.usage.io_valid ? RunUsage::format_bytes(entry.usage.read_chars) : "-";
+        row[m_columns.written] = entry.usage.io_valid ? RunUsage::format_bytes(entry.usage.write_chars) : "-";
+        char ipc[16];
+        std::snprintf(ipc, sizeof(ipc), "%.2f", entry.usage.ipc());
+        row[m_columns.ipc] = entry.usage.counters_valid ? ipc : "-";
+    }
+
+private:
+    struct Columns : public Gtk::TreeModel::ColumnRecord {
+        Columns() {
+            add(started); add(project); add(commit); add(exit_code); add(envelope); add(wall); add(user); add(system);
+            add(max_rss); add(minor_faults); add(major_faults); add(switches); add(read); add(written); add(ipc);
+        }
+        Gtk::TreeModelColumn<Glib::ustring> started;
+        Gtk::TreeModelColumn<Glib::ustring> project;
+        Gtk::TreeModelColumn<Glib::ustring> commit;
+        Gtk::TreeModelColumn<Glib::ustring> exit_code;
+        Gtk::TreeModelColumn<Glib::ustring> envelope;
+        Gtk::TreeModelColumn<double> wall;
+        Gtk::TreeModelColumn<double> user;
+        Gtk::TreeModelColumn<double> system;
+        Gtk::TreeModelColumn<long> max_rss;
+        Gtk::TreeModelColumn<long> minor_faults;
+        Gtk::TreeModelColumn<long> major_faults;
+        Gtk::TreeModelColumn<long> switches;
+        Gtk::TreeModelColumn<Glib::ustring> read;
+        Gtk::TreeModelColumn<Glib::ustring> written;
+        Gtk::TreeModelColumn<Glib::ustring> ipc;
+    };
+
+    Columns m_columns;
+    Glib::RefPtr<Gtk::ListStore> m_store;
+    Gtk::TreeView m_treeview;
+    Gtk::ScrolledWindow m_scrolledwindow;
+};
+
+// --- Flame Graph Window ---
+
+/**
+ * @brief Draws a flame graph, root at the bottom. Clicking a frame zooms into
+ * it (its ancestors stay along the bottom); clicking the root zooms back out.
+ */
+class FlameGraphView : public Gtk::DrawingArea {
+public:
+    // Details of the frame under the pointer, or "" when there is none
+    std::function<void(const std::string&)> on_hover;
+
+    FlameGraphView() {
+        add_events(Gdk::BUTTON_PRESS_MASK | Gdk::POINTER_MOTION_MASK);
+    }
+
+    void set_stacks(const FoldedStacks& folded) {
+        m_root = FlameNode::build(folded);
+        m_zoom_path = {&m_root};
+        set_size_request(-1, static_cast<int>(m_root.depth() * kFrameHeight));
+        queue_draw();
+    }
+
+protected:
+    bool on_draw(const Cairo::RefPtr<Cairo::Context>& cr) override {
+        double width = get_allocated_width();
+        double height = get_allocated_height();
+        cr->set_source_rgb(0.97, 0.97, 0.97);
+        cr->paint();
+        m_boxes.clear();
+        if (m_root.total == 0) return true;
+        // Ancestors of the zoomed frame span the whole width
+        int parent = -1;
+        for (size_t level = 0; level + 1 < m_zoom_path.size(); ++level) {
+            parent = add_box(0.0, level, width, m_zoom_path[level], parent);
+        }
+        layout(*m_zoom_path.back(), 0.0, m_zoom_path.size() - 1, width / static_cast<double>(m_zoom_path.back()->total),
+               parent);
+        for (const auto& box : m_boxes) draw_box(cr, box, height);
+        return true;
+    }
+
+    bool on_button_press_event(GdkEventButton* event) override {
+        const Box* box = hit(event->x, event->y);
+        if (!box) return false;
+        m_zoom_path.clear();
+        for (const Box* at = box; at; at = at->parent >= 0 ? &m_boxes[static_cast<size_t>(at->parent)] : nullptr) {
+            m_zoom_path.insert(m_zoom_path.begin(), at->node);
+        }
+        queue_draw();
+        return true;
+    }
+
+    bool on_motion_notify_event(GdkEventMotion* event) override {
+        const Box* box = hit(event->x, event->y);
+        if (!on_hover) return false;
+        if (!box) {
+            on_hover("");
+            return false;
+        }
+        const FlameNode& node = *box->node;
+        char text[160];
+        std::snprintf(text, sizeof(text), ": %llu samples (%.2f%% of all, %.2f%% of view), %llu in itself", node.total,
+                      100.0 * static_cast<double>(node.total) / static_cast<double>(m_root.total),
+                      100.0 * static_cast<double>(node.total) / static_cast<double>(m_zoom_path.back()->total),
+                      node.self);
+        on_hover(node.name + text);
+        return false;
+    }
+
+private:
+    static constexpr double kFrameHeight = 18.0;
+    static constexpr double kMinWidth = 0.5; // Narrower frames, and their children, are not drawn
+
+    struct Box {
+        double x;
+        size_t level;
+        double width;
+        const FlameNode* node;
+        int parent; // Index into m_boxes, or -1 for the root
+    };
+
+    FlameNode m_root;
+    std::vector<const FlameNode*> m_zoom_path = {&m_root}; // Root to the zoomed frame
+    std::vector<Box> m_boxes;                               // As last drawn, for hit testing
+
+    int add_box(double x, size_t level, double width, const FlameNode* node, int parent) {
+        m_boxes.push_back({x, level, width, node, parent});
+        return static_cast<int>(m_boxes.size()) - 1;
+    }
+
+    void layout(const FlameNode& node, double x, size_t level, double scale, int parent) {
+        double width = static_cast<double>(node.total) * scale;
+        if (width < kMinWidth) return;
+        int index = add_box(x, level, width, &node, parent);
+        for (const auto& child : node.children) {
+            layout(child, x, level + 1, scale, index);
+            x += static_cast<double>(child.total) * scale;
+        }
+    }
+
+    void draw_box(const Cairo::RefPtr<Cairo::Context>& cr, const Box& box, double height) {
+        double y = height - (box.level + 1) * kFrameHeight;
+        double red, green, blue;
+        flame_color(box.node->name, red, green, blue);
+        bool ancestor = box.level + 1 < m_zoom_path.size();
+        cr->set_source_rgba(red, green, blue, ancestor ? 0.5 : 1.0);
+        cr->rectangle(box.x, y, std::max(box.width - 1.0, kMinWidth), kFrameHeight - 1.0);
+        cr->fill();
+        if (box.width < 20.0) return;
+        auto layout = create_pango_layout(box.node->name);
+        layout->set_width(static_cast<int>((box.width - 6.0) * Pango::SCALE));
+        layout->set_ellipsize(Pango::ELLIPSIZE_END);
+        cr->set_source_rgb(0.0, 0.0, 0.0);
+        cr->move_to(box.x + 3.0, y + 1.0);
+        layout->show_in_cairo_context(cr);
+    }
+
+    const Box* hit(double x, double y) const {
+        double height = get_allocated_height();
+        for (const auto& box : m_boxes) {
+            double top = height - (box.level + 1) * kFrameHeight;
+            if (x >= box.x && x < box.x + box.width && y >= top && y < top + kFrameHeight) return &box;
+        }
+        return nullptr;
+    }
+};
+
+/**
+ * @brief Shows a profiled run as a flame graph, exportable as folded stacks
+ * (for flamegraph.pl, speedscope and the like) or as SVG.
+ */
+class FlameGraphWindow : public Gtk::Window {
+public:
+    FlameGraphWindow() : m_vbox(Gtk::ORIENTATION_VERTICAL) {
+        set_title("CPU Profile");
+        set_default_size(1000, 500);
+        m_vbox.set_spacing(6);
+        m_vbox.set_border_width(10);
+        add(m_vbox);
+        m_summary.set_halign(Gtk::ALIGN_START);
+        m_vbox.pack_start(m_summary, Gtk::PACK_SHRINK);
+        m_scroll.set_policy(Gtk::POLICY_NEVER, Gtk::POLICY_AUTOMATIC);
+        m_scroll.add(m_view);
+        m_vbox.pack_start(m_scroll, Gtk::PACK_EXPAND_WIDGET);
+        m_details.set_halign(Gtk::ALIGN_START);
+        m_details.set_ellipsize(Pango::ELLIPSIZE_END);
+        m_details.set_text("Click a frame to zoom in, the bottom frame to zoom out.");
+        m_vbox.pack_start(m_details, Gtk::PACK_SHRINK);
+        m_view.on_hover = [this](const std::string& details) {
+            if (!details.empty()) m_details.set_text(details);
+        };
+
+        auto buttons = Gtk::make_managed<Gtk::Box>(Gtk::ORIENTATION_HORIZONTAL, 6);
+        buttons->set_halign(Gtk::ALIGN_END);
+        auto folded_btn = Gtk::make_managed<Gtk::Button>("Export Folded...");
+        folded_btn->signal_clicked().connect([this]() {
+            std::string path = choose_save_path(*this, "Export Folded Stacks", m_name + ".folded");
+            if (!path.empty()) write_text_file(path, m_stacks.to_text());
+        });
+        buttons->pack_start(*folded_btn, Gtk::PACK_SHRINK);
+        auto svg_btn = Gtk::make_managed<Gtk::Button>("Export SVG...");
+        svg_btn->signal_clicked().connect([this]() {
+            std::string path = choose_save_path(*this, "Export Flame Graph", m_name + ".svg");
+            if (!path.empty()) write_text_file(path, flame_graph_svg(m_stacks, m_name));
+        });
+        buttons->pack_start(*svg_btn, Gtk::PACK_SHRINK);
+        m_vbox.pack_start(*buttons, Gtk::PACK_SHRINK);
+        show_all_children();
+    }
+
+    /**
+     * @param name The profiled project.
+     * @param source How the samples were taken, e.g. "perf record".
+     */
+    void set_profile(const std::string& name, const FoldedStacks& stacks, const std::string& source) {
+        m_name = name;
+        m_stacks = stacks;
+        set_title("CPU Profile: " + name);
+        std::string summary = std::to_string(stacks.total()) + " samples, " + std::to_string(stacks.stacks.size())
+                            + " distinct stacks, via " + source;
+        if (stacks.lost) summary += "; " + std::to_string(stacks.lost) + " lost";
+        m_summary.set_text(summary);
+        m_view.set_stacks(stacks);
+    }
+
+private:
+    Gtk::Box m_vbox;
+    Gtk::Label m_summary;
+    Gtk::ScrolledWindow m_scroll;
+    FlameGraphView m_view;
+    Gtk::Label m_details;
+    std::string m_name;
+    FoldedStacks m_stacks;
+};
+
+// --- Heap Report Window ---
+
+/**
+ * @brief Shows a run's allocation profile: totals, then the call sites that
+ * allocated the most, with the full stack of the selected one. JSON export.
+ */
+class HeapReportWindow : public Gtk::Window {
+public:
+    HeapReportWindow() : m_vbox(Gtk::ORIENTATION_VERTICAL) {
+        set_title("Allocation Report");
+        set_default_size(800, 500);
+        m_vbox.set_spacing(6);
+        m_vbox.set_border_width(10);
+        add(m_vbox);
+        m_summary.set_halign(Gtk::ALIGN_START);
+        m_summary.set_line_wrap(true);
+        m_vbox.pack_start(m_summary, Gtk::PACK_SHRINK);
+
+        m_store = Gtk::ListStore::create(m_columns);
+        m_store->set_sort_column(m_columns.estimated_kib, Gtk::SORT_DESCENDING);
+        m_view.set_model(m_store);
+        m_view.append_column("Call site", m_columns.call_site);
+        m_view.append_column_numeric("Est. allocated (KiB)", m_columns.estimated_kib, "%.0f");
+        m_view.append_column("Samples", m_columns.samples);
+        m_view.get_column(0)->set_expand(true);
+        m_view.get_column(0)->set_sort_column(m_columns.call_site);
+        m_view.get_column(1)->set_sort_column(m_columns.estimated_kib);
+        m_view.get_column(2)->set_sort_column(m_columns.samples);
+        m_view.get_selection()->signal_changed().connect([this]() {
+            auto iter = m_view.get_selection()->get_selected();
+            if (iter) m_stack.set_text((*iter)[m_columns.stack]);
+        });
+        m_scroll.set_policy(Gtk::POLICY_AUTOMATIC, Gtk::POLICY_AUTOMATIC);
+        m_scroll.add(m_view);
+        m_vbox.pack_start(m_scroll, Gtk::PACK_EXPAND_WIDGET);
+
+        m_stack.set_halign(Gtk::ALIGN_START);
+        m_stack.set_selectable(true);
+        m_stack.set_text("Select a call site to see its stack.");
+        m_stack_scroll.set_policy(Gtk::POLICY_AUTOMATIC, Gtk::POLICY_AUTOMATIC);
+        m_stack_scroll.set_size_request(-1, 120);
+        m_stack_scroll.add(m_stack);
+        m_vbox.pack_start(m_stack_scroll, Gtk::PACK_SHRINK);
+
+        auto export_btn = Gtk::make_managed<Gtk::Button>("Export JSON...");
+        export_btn->set_halign(Gtk::ALIGN_END);
+        export_btn->signal_clicked().connect([this]() {
+            std::string path = choose_save_path(*this, "Export Allocation Report", m_name + "-heap.json");
+            if (!path.empty()) write_text_file(path, to_json(m_report.to_json_value()) + "\n");
+        });
+        m_vbox.pack_start(*export_btn, Gtk::PACK_SHRINK);
+        show_all_children();
+    }
+
+    void set_report(const std::string& name, const HeapReport& report) {
+        m_name = name;
+        m_report = report;
+        set_title("Allocation Report: " + name);
+        m_summary.set_text(report.summary() + ". Call sites are sampled about once per "
+                           + RunUsage::format_bytes(report.sample_interval) + " allocated.");
+        m_store->clear();
+        for (const auto& site : report.sites) {
+            std::string stack;
+            for (const auto& frame : site.stack) stack += (stack.empty() ? "" : "\n") + frame;
+            Gtk::TreeModel::Row row = *m_store->append();
+            row[m_columns.call_site] = site.call_site;
+            row[m_columns.estimated_kib] = static_cast<double>(site.estimated_bytes) / 1024.0;
+            row[m_columns.samples] = site.samples;
+            row[m_columns.stack] = stack;
+        }
+        m_stack.set_text("Select a call site to see its stack.");
+    }
+
+private:
+    struct Columns : public Gtk::TreeModel::ColumnRecord {
+        Columns() { add(call_site); add(estimated_kib); add(samples); add(stack); }
+        Gtk::TreeModelColumn<Glib::ustring> call_site;
+        Gtk::TreeModelColumn<double> estimated_kib;
+        Gtk::TreeModelColumn<unsigned long long> samples;
+        Gtk::TreeModelColumn<Glib::ustring> stack; // Leaf first, one frame per line
+    };
+
+    Gtk::Box m_vbox;
+    Gtk::Label m_summary;
+    Columns m_columns;
+    Glib::RefPtr<Gtk::ListStore> m_store;
+    Gtk::TreeView m_view;
+    Gtk::ScrolledWindow m_scroll;
+    Gtk::Label m_stack;
+    Gtk::ScrolledWindow m_stack_scroll;
+    std::string m_name;
+    HeapReport m_report;
+};
+
+// --- Benchmark Window ---
+
+/**
+ * @brief Editor for the RunControls of a benchmark window.
+ */
+class RunControlsBox : public Gtk::Box {
+public:
+    RunControlsBox() : Gtk::Box(Gtk::ORIENTATION_HORIZONTAL, 6) {
+        pack_start(*Gtk::make_managed<Gtk::Label>("Pin to CPUs:"), Gtk::PACK_SHRINK);
+        // isolcpus= cores are the quiet ones, so they are the default when the machine has them
+        std::string isolated = isolated_cpus();
+        m_cpus.set_text(isolated);
+        m_cpus.set_placeholder_text("all, or e.g. 2-3");
+        m_cpus.set_width_chars(10);
+        m_cpus.set_tooltip_text(isolated.empty() ? "No CPUs are isolated (isolcpus= boot option)"
+                                                 : "CPUs " + isolated + " are isolated from other tasks");
+        pack_start(m_cpus, Gtk::PACK_SHRINK);
+        pack_start(*Gtk::make_managed<Gtk::Label>("Nice:"), Gtk::PACK_SHRINK);
+        m_nice.set_range(-20, 19);
+        m_nice.set_increments(1, 5);
+        m_nice.set_value(0);
+        m_nice.set_tooltip_text("Negative values need CAP_SYS_NICE or RLIMIT_NICE");
+        pack_start(m_nice, Gtk::PACK_SHRINK);
+        pack_start(*Gtk::make_managed<Gtk::Label>("SCHED_FIFO:"), Gtk::PACK_SHRINK);
+        m_fifo.set_range(0, 99);
+        m_fifo.set_increments(1, 10);
+        m_fifo.set_value(0);
+        m_fifo.set_tooltip_text("Real-time priority, 0 for the normal scheduler. Needs CAP_SYS_NICE or "
+                                "RLIMIT_RTPRIO; pin the runs too, as a busy loop holds its CPU");
+        pack_start(m_fifo, Gtk::PACK_SHRINK);
+        m_no_aslr.set_label("No ASLR");
+        m_no_aslr.set_tooltip_text("Same address layout every run (personality ADDR_NO_RANDOMIZE)");
+        pack_start(m_no_aslr, Gtk::PACK_SHRINK);
+        m_page_cache.append("Page cache as is");
+        m_page_cache.append("Warm binary and input");
+        m_page_cache.append("Drop binary and input");
+        m_page_cache.set_active(0);
+        pack_start(m_page_cache, Gtk::PACK_SHRINK);
+    }
+
+    /** @brief The settings as shown; throws std::runtime_error for an invalid CPU list. */
+    RunControls controls() const {
+        RunControls controls;
+        controls.cpus = parse_cpu_list(m_cpus.get_text());
+        controls.nice = m_nice.get_value_as_int();
+        controls.fifo_priority = m_fifo.get_value_as_int();
+        controls.no_aslr = m_no_aslr.get_active();
+        controls.page_cache = static_cast<RunControls::PageCache>(std::max(0, m_page_cache.get_active_row_number()));
+        return controls;
+    }
+
+private:
+    Gtk::Entry m_cpus;
+    Gtk::SpinButton m_nice;
+    Gtk::SpinButton m_fifo;
+    Gtk::CheckButton m_no_aslr;
+    Gtk::ComboBoxText m_page_cache;
+};
+/**
+ * @brief Builds a C++ project with a chosen profile and times W warm-up plus
+ * N measured runs of it, with summary statistics and JSON/CSV export.
+ * In A/B mode a second variant (another profile and/or commit) is built too,
+ * the runs of both are interleaved so drift (thermal, background load)
+ * affects them alike, and the wall times are compared with ABComparison.
+ * The build and the runs happen on a worker thread that reports back
+ * through a Glib::Dispatcher, so the launcher stays responsive.
+ */
+class BenchmarkWindow : public Gtk::Window {
+public:
+    BenchmarkWindow() : m_vbox(Gtk::ORIENTATION_VERTICAL) {
+        set_title("Benchmark");
+        set_default_size(800, 420);
+        m_vbox.set_spacing(6);
+        m_vbox.set_border_width(10);
+        add(m_vbox);
+
+        m_title.set_halign(Gtk::ALIGN_START);
+        m_vbox.pack_start(m_title, Gtk::PACK_SHRINK);
+
+        // One row per variant: build profile and commit
+        auto variants = Gtk::make_managed<Gtk::Grid>();
+        variants->set_row_spacing(4);
+        variants->set_column_spacing(6);
+        m_compare.set_label("B:");
+        m_compare.set_tooltip_text("Also build variant B and compare it with A");
+        m_compare.signal_toggled().connect([this]() { set_busy(m_job.busy()); });
+        variants->attach(*Gtk::make_managed<Gtk::Label>("A:"), 0, 0);
+        variants->attach(m_compare, 0, 1);
+        for (int i = 0; i < 2; ++i) {
+            for (const auto& profile : build_profiles()) {
+                m_profile[i].append(profile.name, profile.name + " (" + format_command(profile.flags) + ")");
+            }
+            m_profile[i].set_active(1);
+            m_revision[i].set_placeholder_text("Commit (empty = as cloned)");
+            m_revision[i].set_tooltip_text("SHA, branch, tag or e.g. HEAD~1; history is fetched as needed");
+            variants->attach(*Gtk::make_managed<Gtk::Label>("Profile:"), 1, i);
+            variants->attach(m_profile[i], 2, i);
+            variants->attach(*Gtk::make_managed<Gtk::Label>("Revision:"), 3, i);
+            variants->attach(m_revision[i], 4, i);
+        }
+        m_vbox.pack_start(*variants, Gtk::PACK_SHRINK);
+        m_vbox.pack_start(m_run_controls, Gtk::PACK_SHRINK);
+
+        auto controls = Gtk::make_managed<Gtk::Box>(Gtk::ORIENTATION_HORIZONTAL, 6);
+        controls->pack_start(*Gtk::make_managed<Gtk::Label>("Warm-up runs:"), Gtk::PACK_SHRINK);
+        m_warmup.set_range(0, 1000);
+        m_warmup.set_increments(1, 10);
+        m_warmup.set_value(3);
+        controls->pack_start(m_warmup, Gtk::PACK_SHRINK);
+        controls->pack_start(*Gtk::make_managed<Gtk::Label>("Measured runs (each):"), Gtk::PACK_SHRINK);
+        m_runs.set_range(2, 100000);
+        m_runs.set_increments(1, 10);
+        m_runs.set_value(20);
+        controls->pack_start(m_runs, Gtk::PACK_SHRINK);
+        m_start_btn.signal_clicked().connect(sigc::mem_fun(*this, &BenchmarkWindow::start));
+        m_cancel_btn.signal_clicked().connect([this]() { m_job.cancel(); });
+        controls->pack_end(m_cancel_btn, Gtk::PACK_SHRINK);
+        controls->pack_end(m_start_btn, Gtk::PACK_SHRINK);
+        m_vbox.pack_start(*controls, Gtk::PACK_SHRINK);
+
+        m_progress.set_show_text(true);
+        m_vbox.pack_start(m_progress, Gtk::PACK_SHRINK);
+
+        m_store = Gtk::ListStore::create(m_columns);
+        m_treeview.set_model(m_store);
+        m_treeview.append_column("Metric", m_columns.metric);
+        m_treeview.append_column_numeric("Mean", m_columns.mean, "%.3f");
+        m_treeview.append_column_numeric("Median", m_columns.median, "%.3f");
+        m_treeview.append_column_numeric("Stddev", m_columns.stddev, "%.3f");
+        m_treeview.append_column_numeric("Min", m_columns.min, "%.3f");
+        m_treeview.append_column_numeric("Max", m_columns.max, "%.3f");
+        m_treeview.append_column_numeric("p90", m_columns.p90, "%.3f");
+        m_treeview.append_column_numeric("p99", m_columns.p99, "%.3f");
+        m_treeview.append_column("95% CI of mean", m_columns.ci);
+        m_treeview.append_column_numeric("CV (%)", m_columns.cv, "%.2f");
+        m_vbox.pack_start(m_treeview, Gtk::PACK_EXPAND_WIDGET);
+
+        m_verdict.set_halign(Gtk::ALIGN_START);
+        m_verdict.set_selectable(true);
+        m_vbox.pack_start(m_verdict, Gtk::PACK_SHRINK);
+        m_summary.set_halign(Gtk::ALIGN_START);
+        m_summary.set_selectable(true);
+        m_summary.set_line_wrap(true);
+        m_vbox.pack_start(m_summary, Gtk::PACK_SHRINK);
+
+        auto export_box = Gtk::make_managed<Gtk::Box>(Gtk::ORIENTATION_HORIZONTAL, 6);
+        m_export_json_btn.signal_clicked().connect([this]() {
+            std::string path = choose_save_path(*this, "Export Benchmark", m_project.name + "-benchmark.json");
+            if (!path.empty()) write_text_file(path, to_json(results_json()) + "\n");
+        });
+        m_export_csv_btn.signal_clicked().connect([this]() {
+            std::string path = choose_save_path(*this, "Export Benchmark", m_project.name + "-benchmark.csv");
+            if (path.empty()) return;
+            std::string csv;
+            for (size_t i = 0; i < m_reports.size(); ++i) csv += m_reports[i].to_csv(i == 0);
+            write_text_file(path, csv);
+        });
+        export_box->pack_end(m_export_csv_btn, Gtk::PACK_SHRINK);
+        export_box->pack_end(m_export_json_btn, Gtk::PACK_SHRINK);
+        m_vbox.pack_start(*export_box, Gtk::PACK_SHRINK);
+
+        m_job.on_progress = [this](const std::string& text, double fraction) {
+            m_progress.set_fraction(fraction);
+            m_progress.set_text(text);
+        };
+        set_busy(false);
+        m_export_json_btn.set_sensitive(false);
+        m_export_csv_btn.set_sensitive(false);
+        show_all_children();
+    }
+    /** @brief Selects the project to benchmark; ignored while a benchmark is running. */
+    void set_project(const Project& project) {
+        if (m_job.busy()) return;
+        m_project = project;
+        m_title.set_markup("<b>" + Glib::Markup::escape_text(project.name) + "</b>");
+    }
+
+    /** @brief The C++ compiler chosen in the main window; empty for default_compiler(). */
+    void set_compiler(const std::string& compiler) { m_compiler = compiler; }
+
+private:
+    /** @brief What to build for one side of a comparison. */
+    struct Variant {
+        std::string label;      // "A" or "B"
+        BuildProfile profile;
+        std::string revision;   // Empty for the checkout as cloned
+    };
+
+    struct Columns : public Gtk::TreeModel::ColumnRecord {
+        Columns() { add(metric); add(mean); add(median); add(stddev); add(min); add(max); add(p90); add(p99); add(ci); add(cv); }
+        Gtk::TreeModelColumn<Glib::ustring> metric;
+        Gtk::TreeModelColumn<double> mean;
+        Gtk::TreeModelColumn<double> median;
+        Gtk::TreeModelColumn<double> stddev;
+        Gtk::TreeModelColumn<double> min;
+        Gtk::TreeModelColumn<double> max;
+        Gtk::TreeModelColumn<double> p90;
+        Gtk::TreeModelColumn<double> p99;
+        Gtk::TreeModelColumn<Glib::ustring> ci;
+        Gtk::TreeModelColumn<double> cv;
+    };
+
+    Gtk::Box m_vbox;
+    Gtk::Label m_title;
+    Gtk::CheckButton m_compare;
+    Gtk::ComboBoxText m_profile[2];
+    Gtk::Entry m_revision[2];
+    RunControlsBox m_run_controls;
+    Gtk::SpinButton m_warmup;
+    Gtk::SpinButton m_runs;
+    Gtk::Button m_start_btn{"Run Benchmark"};
+    Gtk::Button m_cancel_btn{"Cancel"};
+    Gtk::ProgressBar m_progress;
+    Columns m_columns;
+    Glib::RefPtr<Gtk::ListStore> m_store;
+    Gtk::TreeView m_treeview;
+    Gtk::Label m_verdict;
+    Gtk::Label m_summary;
+    Gtk::Button m_export_json_btn{"Export JSON..."};
+    Gtk::Button m_export_csv_btn{"Export CSV..."};
+    Project m_project;
+    std::string m_compiler;                  // Empty for default_compiler()
+    std::vector<BenchmarkReport> m_reports;  // One per variant
+    HistoryStore m_history;
+    BackgroundJob m_job;                     // Builds and runs the variants
+
+    void set_busy(bool busy) {
+        m_start_btn.set_sensitive(!busy);
+        m_cancel_btn.set_sensitive(busy);
+        m_compare.set_sensitive(!busy);
+        for (int i = 0; i < 2; ++i) {
+            bool editable = !busy && (i == 0 || m_compare.get_active());
+            m_profile[i].set_sensitive(editable);
+            m_revision[i].set_sensitive(editable);
+        }
+        m_run_controls.set_sensitive(!busy);
+        m_warmup.set_sensitive(!busy);
+        m_runs.set_sensitive(!busy);
+    }
+
+    void start() {
+        if (m_job.busy() || m_project.path.empty()) return;
+        std::vector<Variant> variants;
+        for (int i = 0; i < (m_compare.get_active() ? 2 : 1); ++i) {
+            variants.push_back({i == 0 ? "A" : "B", build_profiles()[std::max(0, m_profile[i].get_active_row_number())],
+                                m_revision[i].get_text()});
+        }
+        unsigned warmup = static_cast<unsigned>(m_warmup.get_value_as_int());
+        unsigned runs = static_cast<unsigned>(m_runs.get_value_as_int());
+        m_store->clear();
+        m_verdict.set_text("");
+        RunControls controls;
+        try {
+            controls = m_run_controls.controls();
+        } catch (const std::exception& e) {
+            m_summary.set_text(e.what());
+            return;
+        }
+        m_summary.set_text("");
+        m_export_json_btn.set_sensitive(false);
+        m_export_csv_btn.set_sensitive(false);
+        set_busy(true);
+        m_job.start([this, project = m_project, compiler = m_compiler, variants, controls, warmup, runs]() {
+            run_worker(project, compiler, variants, controls, warmup, runs);
+        }, sigc::mem_fun(*this, &BenchmarkWindow::on_finished));
+    }
+
+    /**
+     * @brief Worker thread: builds each variant, then runs them warmup + runs times each.
+     * Measured runs go A B, B A, A B, ... so neither variant always runs first.
+     */
+    void run_worker(Project project, std::string compiler, std::vector<Variant> variants, RunControls controls,
+                    unsigned warmup, unsigned runs) {
+        std::vector<BenchmarkReport> reports(variants.size());
+        std::string error;
+        try {
+            if (compiler.empty()) compiler = default_compiler();
+            for (size_t v = 0; v < variants.size(); ++v) {
+                const Variant& variant = variants[v];
+                BenchmarkReport& report = reports[v];
+                report.project = project.name;
+                report.profile = variant.profile.name;
+                report.controls = controls.describe();
+                report.warmup_runs = warmup;
+                std::filesystem::path source = project.path;
+                if (variant.revision.empty()) {
+                    try {
+                        report.revision = git_output(source.parent_path(), {"rev-parse", "HEAD"});
+                    } catch (const std::exception&) {
+                        // Not a git checkout; the revision is simply not recorded
+                    }
+                } else {
+                    std::filesystem::path repo = git_output(source.parent_path(), {"rev-parse", "--show-toplevel"});
+                    m_job.progress(variant.label + ": checking out " + variant.revision, 0.0);
+                    report.revision = git_resolve_commit(repo, variant.revision);
+                    std::filesystem::path worktree = git_worktree_for(repo, report.revision, repo.parent_path() / ".worktrees");
+                    source = worktree / std::filesystem::relative(source, repo);
+                }
+
+                m_job.progress(variant.label + ": building " + variant.profile.name, 0.0);
+                BenchmarkBuild build;
+                try {
+                    build = build_benchmark_executable(compiler, source, variant.profile);
+                } catch (const std::exception& e) {
+                    throw std::runtime_error(variant.label + ": " + e.what());
+                }
+                report.environment = BenchmarkEnvironment::capture(compiler, build.command);
+                report.build_seconds = build.seconds;
+                report.binary_bytes = build.binary_bytes;
+                report.command = {build.executable.string()};
+            }
+
+            size_t total = (warmup + runs) * variants.size();
+            size_t done = 0;
+            for (unsigned i = 0; i < warmup + runs && !m_job.cancelled(); ++i) {
+                bool warming_up = i < warmup;
+                for (size_t k = 0; k < variants.size() && !m_job.cancelled(); ++k) {
+                    size_t v = (i % 2 == 0) ? k : variants.size() - 1 - k;
+                    std::string label = variants.size() > 1 ? variants[v].label + ": " : "";
+                    m_job.progress(label + (warming_up ? "warm-up run " + std::to_string(i + 1) + " of " + std::to_string(warmup)
+                                                      : "measured run " + std::to_string(i - warmup + 1) + " of " + std::to_string(runs)),
+                                  static_cast<double>(done++) / static_cast<double>(total));
+                    controls.prepare({reports[v].command.front()});
+                    SpawnOptions options;
+                    options.argv = reports[v].command;
+                    controls.apply(options);
+                    BenchmarkSample sample = measure_run(std::move(options), &m_job.canceller());
+                    if (m_job.cancelled()) break;
+                    if (sample.exit_code != 0) {
+                        throw std::runtime_error(label + "run " + std::to_string(i + 1) + " exited with code "
+                                                 + std::to_string(sample.exit_code) + "; benchmark abandoned");
+                    }
+                    if (!warming_up) reports[v].samples.push_back(sample);
+                }
+            }
+            if (m_job.cancelled()) {
+                error = "Cancelled after " + std::to_string(reports.front().samples.size()) + " measured run(s)";
+            }
+        } catch (const std::exception& e) {
+            error = e.what();
+        }
+        // Measured runs are shown even when the benchmark stopped early
+        m_job.post([this, reports = std::move(reports)]() mutable { m_reports = std::move(reports); });
+        if (!error.empty()) throw std::runtime_error(error);
+    }
+
+    /** @brief Adds each variant that was measured to the run history as a "benchmark" record. */
+    bool store_reports() const {
+        long long now = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+        bool stored = true;
+        for (const auto& report : m_reports) {
+            if (report.samples.empty()) continue;
+            stored = m_history.append(JsonValue::make_object()
+                .set("type", "benchmark")
+                .set("source", "benchmark")
+                .set("project", report.project)
+                .set("started", now)
+                .set("commit", report.revision)
+                .set("report", report.to_json_value())) && stored;
+        }
+        return stored;
+    }
+
+    void on_finished(const std::string& error) {
+        set_busy(false);
+        if (error.empty()) m_progress.set_fraction(1.0);
+        m_progress.set_text(error.empty() ? "Done" : "Stopped");
+        std::string message = error;
+        if (!store_reports()) {
+            message += (message.empty() ? "" : "\n") + std::string("Could not write the run history ") + m_history.path().string();
+        }
+        if (!message.empty()) m_summary.set_text(message);
+        for (const auto& report : m_reports) {
+            if (report.samples.size() < 2) return;
+        }
+
+        std::string details = message.empty() ? "" : message + "\n";
+        for (size_t i = 0; i < m_reports.size(); ++i) {
+            const BenchmarkReport& report = m_reports[i];
+            std::string label = m_reports.size() > 1 ? std::string(1, static_cast<char>('A' + i)) + ": " : "";
+            add_row(label + "Wall time (ms)", report.wall(), 1e3);
+            add_row(label + "User CPU (ms)", report.user(), 1e3);
+            add_row(label + "System CPU (ms)", report.system(), 1e3);
+            add_row(label + "Max RSS (MiB)", report.max_rss_kb(), 1.0 / 1024);
+            details += label + report.profile + " build of " + report.revision.substr(0, 12) + ", "
+                     + std::to_string(report.samples.size()) + " measured run(s) after "
+                     + std::to_string(report.warmup_runs) + " warm-up: " + report.environment.build_command + "\n";
+        }
+        if (!m_reports.front().controls.empty()) details += "Run controls: " + m_reports.front().controls + "\n";
+        const BenchmarkEnvironment& environment = m_reports.front().environment;
+        details += environment.compiler_version + "\n" + environment.cpu_model + " ("
+                 + std::to_string(environment.cpu_count) + " CPUs), " + environment.kernel;
+        m_summary.set_text(details);
+        if (m_reports.size() == 2) {
+            m_verdict.set_markup("<b>Wall time: " + Glib::Markup::escape_text(wall_comparison().verdict()) + "</b>");
+        }
+        m_export_json_btn.set_sensitive(true);
+        m_export_csv_btn.set_sensitive(true);
+    }
+
+    ABComparison wall_comparison() const {
+        auto walls = [](const BenchmarkReport& report) {
+            std::vector<double> values;
+            for (const auto& sample : report.samples) values.push_back(sample.usage.wall_seconds);
+            return values;
+        };
+        return ABComparison::of(walls(m_reports[0]), walls(m_reports[1]));
+    }
+
+    JsonValue results_json() const {
+        if (m_reports.size() == 1) return m_reports.front().to_json_value();
+        return JsonValue::make_object()
+            .set("a", m_reports[0].to_json_value())
+            .set("b", m_reports[1].to_json_value())
+            .set("wall_time_comparison", wall_comparison().to_json_value());
+    }
+
+    void add_row(const std::string& metric, const SampleStats& stats, double scale) {
+        Gtk::TreeModel::Row row = *m_store->append();
+        row[m_columns.metric] = metric;
+        row[m_columns.mean] = stats.mean * scale;
+        row[m_columns.median] = stats.median * scale;
+        row[m_columns.stddev] = stats.stddev * scale;
+        row[m_columns.min] = stats.min * scale;
+        row[m_columns.max] = stats.max * scale;
+        row[m_columns.p90] = stats.p90 * scale;
+        row[m_columns.p99] = stats.p99 * scale;
+        char ci[64];
+        std::snprintf(ci, sizeof(ci), "%.3f - %.3f", stats.ci_low * scale, stats.ci_high * scale);
+        row[m_columns.ci] = ci;
+        row[m_columns.cv] = stats.cv() * 100;
+    }
+};
+
+// --- Matrix Benchmark Window ---
+
+/**
+ * @brief One way of running the project in a matrix benchmark.
+ */
+struct MatrixCell {
+    std::string label;
+    std::vector<std::string> env;  // Added to the run's environment
+    bool disable_thp = false;
+    std::string compiler;          // Driver to build with; empty for the default compiler
+    std::string profile;           // Build profile name; empty for the one chosen in the window
+    std::vector<int> cpus;         // CPUs the runs may use; empty for all of the launcher's
+    std::vector<std::string> args; // Appended to the built executable
+    std::filesystem::path input;   // Given as stdin; empty for none
+};
+
+/**
+ * @brief Runs one build of a project in several ways (the cells) and compares
+ * them in one table against the first cell, the baseline.
+ * Each distinct compiler and profile among the cells is built once.
+ * Measured runs go round-robin over the cells, starting one cell later each
+ * round, so slow drift of the machine's state is spread evenly. Subclasses
+ * add their settings to m_options and say what the cells are in plan().
+ */
+class MatrixBenchmarkWindow : public Gtk::Window {
+public:
+    explicit MatrixBenchmarkWindow(const std::string& title)
+    : m_vbox(Gtk::ORIENTATION_VERTICAL), m_options(Gtk::ORIENTATION_VERTICAL), m_results(Gtk::ORIENTATION_VERTICAL),
+      m_title_text(title) {
+        set_title(title);
+        set_default_size(900, 420);
+        m_vbox.set_spacing(6);
+        m_vbox.set_border_width(10);
+        add(m_vbox);
+
+        m_title.set_halign(Gtk::ALIGN_START);
+        m_vbox.pack_start(m_title, Gtk::PACK_SHRINK);
+        m_options.set_spacing(4);
+        m_vbox.pack_start(m_options, Gtk::PACK_SHRINK);
+        m_vbox.pack_start(m_run_controls, Gtk::PACK_SHRINK);
+
+        auto controls = Gtk::make_managed<Gtk::Box>(Gtk::ORIENTATION_HORIZONTAL, 6);
+        controls->pack_start(m_profile_label, Gtk::PACK_SHRINK);
+        for (const auto& profile : build_profiles()) {
+            m_profile.append(profile.name, profile.name + " (" + format_command(profile.flags) + ")");
+        }
+        m_profile.set_active(1);
+        controls->pack_start(m_profile, Gtk::PACK_SHRINK);
+        controls->pack_start(*Gtk::make_managed<Gtk::Label>("Warm-up rounds:"), Gtk::PACK_SHRINK);
+        m_warmup.set_range(0, 1000);
+        m_warmup.set_increments(1, 10);
+        m_warmup.set_value(2);
+        controls->pack_start(m_warmup, Gtk::PACK_SHRINK);
+        controls->pack_start(*Gtk::make_managed<Gtk::Label>("Measured rounds:"), Gtk::PACK_SHRINK);
+        m_runs.set_range(2, 100000);
+        m_runs.set_increments(1, 10);
+        m_runs.set_value(10);
+        controls->pack_start(m_runs, Gtk::PACK_SHRINK);
+        m_start_btn.signal_clicked().connect(sigc::mem_fun(*this, &MatrixBenchmarkWindow::start));
+        m_cancel_btn.signal_clicked().connect([this]() { m_job.cancel(); });
+        controls->pack_end(m_cancel_btn, Gtk::PACK_SHRINK);
+        controls->pack_end(m_start_btn, Gtk::PACK_SHRINK);
+        m_vbox.pack_start(*controls, Gtk::PACK_SHRINK);
+
+        m_progress.set_show_text(true);
+        m_vbox.pack_start(m_progress, Gtk::PACK_SHRINK);
+
+        m_store = Gtk::ListStore::create(m_columns);
+        m_treeview.set_model(m_store);
+        m_treeview.append_column("Variant", m_columns.variant);
+        m_treeview.append_column_numeric("Build (s)", m_columns.build_seconds, "%.2f");
+        m_treeview.append_column_numeric("Binary (KiB)", m_columns.binary_kib, "%.1f");
+        m_treeview.append_column_numeric("Median wall (ms)", m_columns.median_ms, "%.3f");
+        m_treeview.append_column("95% CI of mean (ms)", m_columns.ci);
+        m_treeview.append_column_numeric("CV (%)", m_columns.cv, "%.2f");
+        m_treeview.append_column_numeric("Runs/s", m_columns.throughput, "%.2f");
+        m_treeview.append_column("Wall vs baseline", m_columns.change);
+        m_treeview.append_column("Max RSS (MiB)", m_columns.max_rss);
+        m_treeview.append_column("Minor faults", m_columns.minor_faults);
+        m_treeview.append_column("Major faults", m_columns.major_faults);
+        m_treeview.get_column(0)->set_expand(true);
+        m_vbox.pack_start(m_treeview, Gtk::PACK_EXPAND_WIDGET);
+        m_vbox.pack_start(m_results, Gtk::PACK_SHRINK);
+
+        m_summary.set_halign(Gtk::ALIGN_START);
+        m_summary.set_selectable(true);
+        m_summary.set_line_wrap(true);
+        m_vbox.pack_start(m_summary, Gtk::PACK_SHRINK);
+
+        auto export_box = Gtk::make_managed<Gtk::Box>(Gtk::ORIENTATION_HORIZONTAL, 6);
+        m_export_json_btn.signal_clicked().connect([this]() {
+            std::string path = choose_save_path(*this, "Export " + m_title_text, m_project.name + "-matrix.json");
+            if (!path.empty()) write_text_file(path, to_json(results_json()) + "\n");
+        });
+        m_export_csv_btn.signal_clicked().connect([this]() {
+            std::string path = choose_save_path(*this, "Export " + m_title_text, m_project.name + "-matrix.csv");
+            if (path.empty()) return;
+            std::string csv;
+            for (size_t i = 0; i < m_reports.size(); ++i) csv += m_reports[i].to_csv(i == 0);
+            write_text_file(path, csv);
+        });
+        export_box->pack_end(m_export_csv_btn, Gtk::PACK_SHRINK);
+        export_box->pack_end(m_export_json_btn, Gtk::PACK_SHRINK);
+        m_vbox.pack_start(*export_box, Gtk::PACK_SHRINK);
+
+        m_job.on_progress = [this](const std::string& text, double fraction) {
+            m_progress.set_fraction(fraction);
+            m_progress.set_text(text);
+        };
+        set_busy(false);
+        m_export_json_btn.set_sensitive(false);
+        m_export_csv_btn.set_sensitive(false);
+        show_all_children();
+    }
+    /** @brief Selects the project to benchmark; ignored while a benchmark is running. */
+    void set_project(const Project& project) {
+        if (m_job.busy()) return;
+        m_project = project;
+        m_title.set_markup("<b>" + Glib::Markup::escape_text(project.name) + "</b>");
+    }
+
+    /** @brief The compiler of cells that name none, as chosen in the main window. */
+    void set_compiler(const std::string& compiler) { m_compiler = compiler; }
+
+protected:
+    Gtk::Box m_vbox;
+    Gtk::Box m_options;  // Settings of the subclass, above the run controls
+    Gtk::Box m_results;  // Views of the subclass, under the table
+
+    /** @brief Hides the profile choice, for subclasses whose cells all name their profile. */
+    void hide_profile_choice() {
+        for (Gtk::Widget* widget : std::initializer_list<Gtk::Widget*>{&m_profile_label, &m_profile}) {
+            widget->set_no_show_all(true);
+            widget->hide();
+        }
+    }
+
+    /** @brief Works out the cells on the worker thread, e.g. from what is installed; may post to the window. */
+    using Planner = std::function<std::vector<MatrixCell>(BackgroundJob& job)>;
+
+    /**
+     * @brief Reads the subclass's settings when a run starts, on the main thread.
+     * Throws std::runtime_error (shown to the user) for unusable settings.
+     * @return What works out the cells to run, baseline first; it throws
+     * std::runtime_error (also shown) if there is nothing to compare.
+     */
+    virtual Planner plan() = 0;
+
+    /** @brief Shown under the table with the results, e.g. what the cells varied. */
+    virtual std::string notes() const { return ""; }
+
+    /** @brief Called with the reports (one per cell, as planned) when a run completes. */
+    virtual void show_results(const std::vector<BenchmarkReport>&) {}
+
+    /** @brief Added to the JSON export as "analysis", e.g. fits made in show_results(). */
+    virtual JsonValue extra_json() const { return JsonValue(); }
+
+    const Project& project() const { return m_project; }
+    /** @brief The compiler of cells that name none; empty for default_compiler(). */
+    const std::string& compiler() const { return m_compiler; }
+
+private:
+    struct Columns : public Gtk::TreeModel::ColumnRecord {
+        Columns() {
+            add(variant); add(build_seconds); add(binary_kib); add(median_ms); add(ci); add(cv); add(throughput);
+            add(change); add(max_rss); add(minor_faults); add(major_faults);
+        }
+        Gtk::TreeModelColumn<Glib::ustring> variant;
+        Gtk::TreeModelColumn<double> build_seconds;
+        Gtk::TreeModelColumn<double> binary_kib;
+        Gtk::TreeModelColumn<double> median_ms;
+        Gtk::TreeModelColumn<Glib::ustring> ci;
+        Gtk::TreeModelColumn<double> cv;
+        Gtk::TreeModelColumn<double> throughput;
+        Gtk::TreeModelColumn<Glib::ustring> change;
+        Gtk::TreeModelColumn<Glib::ustring> max_rss;
+        Gtk::TreeModelColumn<Glib::ustring> minor_faults;
+        Gtk::TreeModelColumn<Glib::ustring> major_faults;
+    };
+
+    std::string m_title_text;
+    Gtk::Label m_title;
+    Gtk::Label m_profile_label{"Profile:"};
+    Gtk::ComboBoxText m_profile;
+    RunControlsBox m_run_controls;
+    Gtk::SpinButton m_warmup;
+    Gtk::SpinButton m_runs;
+    Gtk::Button m_start_btn{"Run Matrix"};
+    Gtk::Button m_cancel_btn{"Cancel"};
+    Gtk::ProgressBar m_progress;
+    Columns m_columns;
+    Glib::RefPtr<Gtk::ListStore> m_store;
+    Gtk::TreeView m_treeview;
+    Gtk::Label m_summary;
+    Gtk::Button m_export_json_btn{"Export JSON..."};
+    Gtk::Button m_export_csv_btn{"Export CSV..."};
+    Project m_project;
+    std::string m_compiler;                  // Empty for default_compiler()
+    std::vector<BenchmarkReport> m_reports;  // One per cell, baseline first
+    BackgroundJob m_job;                     // Plans, builds and runs the cells
+
+    void set_busy(bool busy) {
+        m_start_btn.set_sensitive(!busy);
+        m_cancel_btn.set_sensitive(busy);
+        m_options.set_sensitive(!busy);
+        m_run_controls.set_sensitive(!busy);
+        m_profile.set_sensitive(!busy);
+        m_warmup.set_sensitive(!busy);
+        m_runs.set_sensitive(!busy);
+    }
+
+    void start() {
+        if (m_job.busy() || m_project.path.empty()) return;
+        m_store->clear();
+        m_reports.clear();
+        m_export_json_btn.set_sensitive(false);
+        m_export_csv_btn.set_sensitive(false);
+        Planner planner;
+        RunControls controls;
+        try {
+            controls = m_run_controls.controls();
+            planner = plan();
+        } catch (const std::exception& e) {
+            m_summary.set_text(e.what());
+            return;
+        }
+        m_summary.set_text("");
+        BuildProfile profile = build_profiles()[std::max(0, m_profile.get_active_row_number())];
+        unsigned warmup = static_cast<unsigned>(m_warmup.get_value_as_int());
+        unsigned runs = static_cast<unsigned>(m_runs.get_value_as_int());
+        set_busy(true);
+        m_job.start([this, project = m_project, compiler = m_compiler, profile, planner, controls, warmup, runs]() {
+            run_worker(project, compiler, profile, planner, controls, warmup, runs);
+        }, sigc::mem_fun(*this, &MatrixBenchmarkWindow::on_finished));
+    }
+
+    /** @brief Worker thread: plans the cells, builds what they need, then runs every cell warmup + runs times. */
+    void run_worker(Project project, std::string fallback_compiler, BuildProfile profile, Planner planner, RunControls controls,
+                    unsigned warmup, unsigned runs) {
+        std::vector<MatrixCell> cells = planner(m_job);
+        std::vector<BenchmarkReport> reports(cells.size());
+        std::string error;
+        try {
+            std::filesystem::path source = project.path;
+            std::string revision;
+            try {
+                revision = git_output(source.parent_path(), {"rev-parse", "HEAD"});
+            } catch (const std::exception&) {
+                // Not a git checkout; the revision is simply not recorded
+            }
+            if (fallback_compiler.empty()) fallback_compiler = default_compiler();
+            std::map<std::pair<std::string, std::string>, BenchmarkReport> builds; // By compiler and profile
+            for (size_t c = 0; c < cells.size() && !m_job.cancelled(); ++c) {
+                std::string compiler = cells[c].compiler.empty() ? fallback_compiler : cells[c].compiler;
+                BuildProfile cell_profile = profile;
+                for (const auto& candidate : build_profiles()) {
+                    if (candidate.name == cells[c].profile) cell_profile = candidate;
+                }
+                auto [built, added] = builds.try_emplace({compiler, cell_profile.name});
+                if (added) {
+                    m_job.progress("Building " + cell_profile.name + " with " + compiler, 0.0);
+                    BenchmarkBuild build;
+                    try {
+                        build = build_benchmark_executable(compiler, source, cell_profile,
+                                                           cells[c].compiler.empty() ? "" : compiler);
+                    } catch (const std::exception& e) {
+                        throw std::runtime_error(compiler + ", " + cell_profile.name + ": " + e.what());
+                    }
+                    BenchmarkReport& report = built->second;
+                    report.project = project.name;
+                    report.profile = cell_profile.name;
+                    report.revision = revision;
+                    report.command = {build.executable.string()};
+                    report.warmup_runs = warmup;
+                    report.controls = controls.describe();
+                    report.environment = BenchmarkEnvironment::capture(compiler, build.command);
+                    report.build_seconds = build.seconds;
+                    report.binary_bytes = build.binary_bytes;
+                }
+                reports[c] = built->second;
+                reports[c].variant = cells[c].label;
+                reports[c].env = cells[c].env;
+                reports[c].command.insert(reports[c].command.end(), cells[c].args.begin(), cells[c].args.end());
+            }
+
+            size_t total = (warmup + runs) * cells.size();
+            size_t done = 0;
+            for (unsigned round = 0; round < warmup + runs && !m_job.cancelled(); ++round) {
+                bool warming_up = round < warmup;
+                for (size_t k = 0; k < cells.size() && !m_job.cancelled(); ++k) {
+                    size_t c = (round + k) % cells.size();
+                    m_job.progress(cells[c].label + ": " + (warming_up ? "warm-up round " + std::to_string(round + 1)
+                                                                      : "round " + std::to_string(round - warmup + 1)
+                                                                        + " of " + std::to_string(runs)),
+                                  static_cast<double>(done++) / static_cast<double>(total));
+                    SpawnOptions options;
+                    options.argv = reports[c].command;
+                    options.env = cells[c].env;
+                    options.disable_thp = cells[c].disable_thp;
+                    options.cpus = cells[c].cpus;
+                    controls.apply(options);
+                    std::vector<std::filesystem::path> files = {options.argv.front()};
+                    if (!cells[c].input.empty()) files.push_back(cells[c].input);
+                    controls.prepare(files);
+                    int input = -1;
+                    if (!cells[c].input.empty()) {
+                        input = open(cells[c].input.c_str(), O_RDONLY | O_CLOEXEC);
+                        if (input < 0) throw std::runtime_error("Could not open " + cells[c].input.string() + ": " + std::strerror(errno));
+                        options.stdin_mode = StdioMode::Fd;
+                        options.stdin_fd = input;
+                    }
+                    BenchmarkSample sample;
+                    try {
+                        sample = measure_run(std::move(options), &m_job.canceller());
+                    } catch (...) {
+                        ChildProcess::close_fd(input);
+                        throw;
+                    }
+                    ChildProcess::close_fd(input);
+                    if (m_job.cancelled()) break;
+                    if (sample.exit_code != 0) {
+                        throw std::runtime_error(cells[c].label + ": run exited with code "
+                                                 + std::to_string(sample.exit_code) + "; benchmark abandoned");
+                    }
+                    if (!warming_up) reports[c].samples.push_back(sample);
+                }
+            }
+            if (m_job.cancelled()) error = "Cancelled";
+        } catch (const std::exception& e) {
+            error = e.what();
+        }
+        // Measured rounds are shown even when the matrix stopped early
+        m_job.post([this, reports = std::move(reports)]() mutable { m_reports = std::move(reports); });
+        if (!error.empty()) throw std::runtime_error(error);
+    }
+
+    void on_finished(const std::string& error) {
+        set_busy(false);
+        if (error.empty()) m_progress.set_fraction(1.0);
+        m_progress.set_text(error.empty() ? "Done" : "Stopped");
+        if (!error.empty()) m_summary.set_text(error);
+        if (m_reports.empty()) return; // Planning failed
+        for (const auto& report : m_reports) {
+            if (report.samples.size() < 2) return;
+        }
+
+        const BenchmarkReport& baseline = m_reports.front();
+        bool several_builds = false; // Whether the build columns tell the cells apart
+        for (const auto& report : m_reports) {
+            add_row(report, baseline);
+            several_builds = several_builds || report.command != baseline.command;
+        }
+        m_treeview.get_column(1)->set_visible(several_builds);
+        m_treeview.get_column(2)->set_visible(several_builds);
+        show_results(m_reports);
+        const BenchmarkEnvironment& environment = baseline.environment;
+        std::string details = error.empty() ? "" : error + "\n";
+        std::string extra = notes();
+        if (!extra.empty()) details += extra + "\n";
+        details += std::to_string(baseline.samples.size()) + " measured round(s) after " + std::to_string(baseline.warmup_runs)
+                 + " warm-up; baseline " + baseline.variant + ". Changes marked n.s. are not significant (p >= 0.05).\n";
+        if (!several_builds) details += environment.build_command + "\n" + environment.compiler_version + "\n";
+        if (!baseline.controls.empty()) details += "Run controls: " + baseline.controls + "\n";
+        details += environment.cpu_model + " ("
+                 + std::to_string(environment.cpu_count) + " CPUs), " + environment.kernel;
+        m_summary.set_text(details);
+        m_export_json_btn.set_sensitive(true);
+        m_export_csv_btn.set_sensitive(true);
+    }
+
+    static std::vector<double> walls(const BenchmarkReport& report) {
+        std::vector<double> values;
+        for (const auto& sample : report.samples) values.push_back(sample.usage.wall_seconds);
+        return values;
+    }
+
+    /** @brief A median with its change against the baseline's, e.g. "12.5 (+4.2%)". */
+    static std::string with_change(double value, double baseline, const char* format, bool is_baseline) {
+        char text[64];
+        std::snprintf(text, sizeof(text), format, value);
+        if (is_baseline || baseline <= 0.0) return text;
+        char change[32];
+        std::snprintf(change, sizeof(change), " (%+.1f%%)", (value / baseline - 1.0) * 100);
+        return text + std::string(change);
+    }
+
+    void add_row(const BenchmarkReport& report, const BenchmarkReport& baseline) {
+        bool is_baseline = &report == &baseline;
+        SampleStats wall = report.wall();
+        Gtk::TreeModel::Row row = *m_store->append();
+        row[m_columns.variant] = report.variant;
+        row[m_columns.build_seconds] = report.build_seconds;
+        row[m_columns.binary_kib] = static_cast<double>(report.binary_bytes) / 1024;
+        row[m_columns.median_ms] = wall.median * 1e3;
+        char ci[64];
+        std::snprintf(ci, sizeof(ci), "%.3f - %.3f", wall.ci_low * 1e3, wall.ci_high * 1e3);
+        row[m_columns.ci] = ci;
+        row[m_columns.cv] = wall.cv() * 100;
+        row[m_columns.throughput] = wall.median > 0 ? 1.0 / wall.median : 0.0;
+        if (is_baseline) {
+            row[m_columns.change] = "baseline";
+        } else {
+            ABComparison comparison = ABComparison::of(walls(baseline), walls(report));
+            char change[64];
+            std::snprintf(change, sizeof(change), "%+.1f%%%s", comparison.relative_change * 100,
+                          comparison.significant ? "" : " (n.s.)");
+            row[m_columns.change] = change;
+        }
+        row[m_columns.max_rss] = with_change(report.max_rss_kb().median / 1024, baseline.max_rss_kb().median / 1024,
+                                             "%.1f", is_baseline);
+        row[m_columns.minor_faults] = with_change(report.minor_faults().median, baseline.minor_faults().median, "%.0f",
+                                                  is_baseline);
+        row[m_columns.major_faults] = with_change(report.major_faults().median, baseline.major_faults().median, "%.0f",
+                                                  is_baseline);
+    }
+
+    JsonValue results_json() const {
+        JsonValue cells = JsonValue::make_array();
+        for (const auto& report : m_reports) {
+            JsonValue cell = report.to_json_value();
+            if (&report != &m_reports.front()) {
+                cell.set("wall_time_vs_baseline", ABComparison::of(walls(m_reports.front()), walls(report)).to_json_value());
+            }
+            cells.push(cell);
+        }
+        JsonValue results = JsonValue::make_object().set("matrix", m_title_text).set("cells", cells);
+        JsonValue extra = extra_json();
+        if (!extra.is_null()) results.set("analysis", extra);
+        return results;
+    }
+};
+
+/**
+ * @brief Runs a project under each malloc implementation found on the system
+ * (through LD_PRELOAD), optionally with transparent hugepages varied too.
+ */
+class AllocatorMatrixWindow : public MatrixBenchmarkWindow {
+public:
+    AllocatorMatrixWindow() : MatrixBenchmarkWindow("Allocator Matrix") {
+        m_found.set_halign(Gtk::ALIGN_START);
+        m_found.set_line_wrap(true);
+        m_found.set_text("Allocators are looked up when the matrix runs.");
+        m_options.pack_start(m_found, Gtk::PACK_SHRINK);
+        m_thp.set_label("Also vary transparent hugepages (off per process; opt-in through allocator settings)");
+        m_options.pack_start(m_thp, Gtk::PACK_SHRINK);
+        show_all_children();
+    }
+
+protected:
+    Planner plan() override {
+        bool want_thp = m_thp.get_active();
+        return [this, want_thp](BackgroundJob& job) {
+            // ldconfig and sysfs are read here, off the main loop
+            std::vector<MemoryAllocator> allocators = find_allocators();
+            std::string thp_mode = transparent_hugepage_mode();
+            std::string found;
+            for (const auto& allocator : allocators) {
+                found += (found.empty() ? "" : ", ") + allocator.name
+                       + (allocator.library.empty() ? "" : " (" + allocator.library.string() + ")");
+            }
+            job.post([this, found, thp_mode]() {
+                m_thp_mode = thp_mode;
+                m_found.set_text("Allocators: " + found + "\nTransparent hugepages: "
+                                 + (thp_mode.empty() ? "unknown" : thp_mode));
+            });
+            return cells_for(allocators, want_thp && !thp_mode.empty() && thp_mode != "never", thp_mode);
+        };
+    }
+
+    /** @brief One cell per allocator, plus its hugepage variants when @p vary_thp is set. */
+    static std::vector<MatrixCell> cells_for(const std::vector<MemoryAllocator>& allocators, bool vary_thp,
+                                             const std::string& thp_mode) {
+        std::vector<MatrixCell> cells;
+        for (const auto& allocator : allocators) {
+            MatrixCell cell;
+            cell.label = allocator.name;
+            if (!allocator.library.empty()) cell.env.push_back("LD_PRELOAD=" + allocator.library.string());
+            cells.push_back(cell);
+            if (!vary_thp) continue;
+            MatrixCell off = cell;
+            off.label += ", THP off";
+            off.disable_thp = true;
+            cells.push_back(off);
+            if (thp_mode != "madvise") continue; // With "always" every allocator already gets hugepages
+            // Allocators that can madvise() their heap into hugepages
+            MatrixCell on = cell;
+            if (allocator.name == "glibc") {
+                on.label += ", hugetlb tunable";
+                on.env.push_back("GLIBC_TUNABLES=glibc.malloc.hugetlb=1"); // glibc 2.35+; older ones ignore it
+            } else if (allocator.name == "jemalloc") {
+                on.label += ", thp:always";
+                on.env.push_back("MALLOC_CONF=thp:always");
+            } else {
+                continue;
+            }
+            cells.push_back(on);
+        }
+        if (cells.size() < 2) {
+            throw std::runtime_error("Only glibc's allocator was found and there is nothing else to vary. Install "
+                                     "jemalloc, mimalloc or tcmalloc, or enable the hugepage variants.");
+        }
+        return cells;
+    }
+
+    std::string notes() const override {
+        return "LD_PRELOAD replaces malloc for the whole run, including processes it starts. "
+               "Transparent hugepages: " + (m_thp_mode.empty() ? std::string("unknown") : m_thp_mode) + ".";
+    }
+
+private:
+    Gtk::Label m_found;
+    Gtk::CheckButton m_thp;
+    std::string m_thp_mode;
+};
+
+/**
+ * @brief Builds a project with each installed compiler and chosen profile and
+ * compares compile time, binary size and run time side by side.
+ */
+class CompilerMatrixWindow : public MatrixBenchmarkWindow {
+public:
+    CompilerMatrixWindow() : MatrixBenchmarkWindow("Compiler Matrix") {
+        hide_profile_choice();
+        m_toolchain_box.set_spacing(12);
+        m_options.pack_start(m_toolchain_box, Gtk::PACK_SHRINK);
+        auto profiles = Gtk::make_managed<Gtk::Box>(Gtk::ORIENTATION_HORIZONTAL, 12);
+        profiles->pack_start(*Gtk::make_managed<Gtk::Label>("Profiles:"), Gtk::PACK_SHRINK);
+        for (const auto& profile : build_profiles()) {
+            auto check = Gtk::make_managed<Gtk::CheckButton>(profile.name);
+            check->set_active(profile.name == "Release");
+            profiles->pack_start(*check, Gtk::PACK_SHRINK);
+            m_profile_checks.push_back(check);
+        }
+        m_options.pack_start(*profiles, Gtk::PACK_SHRINK);
+        show_all_children();
+    }
+
+    /** @brief Lists the installed compilers to choose from (all of them, initially). */
+    void set_toolchains(const std::vector<Toolchain>& toolchains) {
+        if (!m_toolchain_checks.empty()) return;
+        m_toolchain_box.pack_start(*Gtk::make_managed<Gtk::Label>("Compilers:"), Gtk::PACK_SHRINK);
+        for (const auto& toolchain : toolchains) {
+            auto check = Gtk::make_managed<Gtk::CheckButton>(toolchain.label());
+            check->set_active(true);
+            check->set_tooltip_text(toolchain.path.string() + "\n" + toolchain.version_line);
+            m_toolchain_box.pack_start(*check, Gtk::PACK_SHRINK);
+            m_toolchain_checks.emplace_back(check, toolchain);
+        }
+        if (toolchains.empty()) m_toolchain_box.pack_start(*Gtk::make_managed<Gtk::Label>("none found in PATH"), Gtk::PACK_SHRINK);
+        m_toolchain_box.show_all();
+    }
+
+protected:
+    Planner plan() override {
+        std::vector<MatrixCell> cells;
+        // The main window's compiler first, so that it is the baseline
+        std::string first = compiler().empty() ? default_compiler() : compiler();
+        std::vector<const Toolchain*> chosen;
+        for (const auto& [check, toolchain] : m_toolchain_checks) {
+            if (!check->get_active()) continue;
+            chosen.insert(toolchain.name == first ? chosen.begin() : chosen.end(), &toolchain);
+        }
+        for (const Toolchain* toolchain : chosen) {
+            for (size_t p = 0; p < m_profile_checks.size(); ++p) {
+                if (!m_profile_checks[p]->get_active()) continue;
+                MatrixCell cell;
+                cell.compiler = toolchain->name;
+                cell.profile = build_profiles()[p].name;
+                cell.label = toolchain->label() + ", " + cell.profile;
+                cells.push_back(cell);
+            }
+        }
+        if (cells.size() < 2) throw std::runtime_error("Choose at least two compilers or profiles to compare.");
+        return [cells](BackgroundJob&) { return cells; };
+    }
+
+    std::string notes() const override {
+        return "Build times are of a single compile each, so they are rough.";
+    }
+
+private:
+    Gtk::Box m_toolchain_box{Gtk::ORIENTATION_HORIZONTAL};
+    std::vector<std::pair<Gtk::CheckButton*, Toolchain>> m_toolchain_checks;
+    std::vector<Gtk::CheckButton*> m_profile_checks;  // In build_profiles() order
+};
 
 /**
- * @brief Function to run a shell command and capture its output.
- * @param command The command to run.
- * @return The output of the command.
+ * @brief Speed-up and parallel efficiency of a scaling sweep against core count,
+ * with the ideal (linear) speed-up for reference.
  */
-std::string run_command(const std::string& command) {
-    std::string result;
-    FILE* pipe = popen(command.c_str(), "r");
-    if (!pipe) {
-        throw std::runtime_error("popen() failed!");
+class ScalingChart : public Gtk::DrawingArea {
+public:
+    struct Point {
+        int cores;
+        double speedup;
+    };
+
+    ScalingChart() { set_size_request(-1, 260); }
+
+    void set_points(std::vector<Point> points) {
+        m_points = std::move(points);
+        queue_draw();
+    }
+
+protected:
+    bool on_draw(const Cairo::RefPtr<Cairo::Context>& cr) override {
+        double width = get_allocated_width();
+        double height = get_allocated_height();
+        cr->set_source_rgb(1.0, 1.0, 1.0);
+        cr->paint();
+        if (m_points.empty()) return true;
+
+        // Plot area, with room for the axis labels
+        const double left = 48.0, right = width - 52.0, top = 24.0, bottom = height - 30.0;
+        double max_cores = m_points.back().cores;
+        double max_speedup = max_cores;
+        for (const auto& point : m_points) max_speedup = std::max(max_speedup, point.speedup);
+        auto x_of = [&](double cores) { return left + (right - left) * (cores - 1.0) / std::max(max_cores - 1.0, 1.0); };
+        auto y_of = [&](double fraction) { return bottom - (bottom - top) * fraction; };
+
+        cr->set_line_width(1.0);
+        cr->set_source_rgb(0.6, 0.6, 0.6);
+        cr->move_to(left, top);
+        cr->line_to(left, bottom);
+        cr->line_to(right, bottom);
+        cr->line_to(right, top);
+        cr->stroke();
+        for (const auto& point : m_points) {
+            draw_text(cr, std::to_string(point.cores), x_of(point.cores) - 4.0, bottom + 4.0);
+        }
+        char text[32];
+        for (int tick = 0; tick <= 4; ++tick) {
+            std::snprintf(text, sizeof(text), "%.3g", max_speedup * tick / 4);
+            draw_text(cr, text, 6.0, y_of(tick / 4.0) - 8.0);
+            std::snprintf(text, sizeof(text), "%d%%", tick * 25);
+            draw_text(cr, text, right + 6.0, y_of(tick / 4.0) - 8.0);
+        }
+
+        // Ideal speed-up, dashed
+        cr->set_source_rgb(0.5, 0.5, 0.5);
+        cr->set_dash(std::vector<double>{4.0, 4.0}, 0.0);
+        cr->move_to(x_of(1.0), y_of(1.0 / max_speedup));
+        cr->line_to(x_of(max_cores), y_of(max_cores / max_speedup));
+        cr->stroke();
+        cr->unset_dash();
+
+        // Measured speed-up (left axis) and efficiency (right axis)
+        for (int series = 0; series < 2; ++series) {
+            if (series == 0) cr->set_source_rgb(0.16, 0.40, 0.75);
+            else cr->set_source_rgb(0.85, 0.45, 0.10);
+            cr->set_line_width(2.0);
+            for (size_t i = 0; i < m_points.size(); ++i) {
+                const Point& point = m_points[i];
+                double y = y_of(series == 0 ? point.speedup / max_speedup : std::min(point.speedup / point.cores, 1.0));
+                if (i == 0) cr->move_to(x_of(point.cores), y);
+                else cr->line_to(x_of(point.cores), y);
+            }
+            cr->stroke();
+            for (const auto& point : m_points) {
+                double y = y_of(series == 0 ? point.speedup / max_speedup : std::min(point.speedup / point.cores, 1.0));
+                cr->arc(x_of(point.cores), y, 3.0, 0.0, 2 * M_PI);
+                cr->fill();
+            }
+        }
+
+        cr->set_source_rgb(0.0, 0.0, 0.0);
+        draw_text(cr, "Speed-up (blue, left), efficiency (orange, right), ideal (dashed) against cores", left, 4.0);
+        return true;
+    }
+
+private:
+    std::vector<Point> m_points;  // By increasing core count; the first is 1 core
+
+    void draw_text(const Cairo::RefPtr<Cairo::Context>& cr, const std::string& text, double x, double y) {
+        auto layout = create_pango_layout(text);
+        cr->save();
+        cr->set_source_rgb(0.2, 0.2, 0.2);
+        cr->move_to(x, y);
+        layout->show_in_cairo_context(cr);
+        cr->restore();
+    }
+};
+
+/**
+ * @brief Reruns a project on 1, 2, 4 ... N cores (by CPU affinity) and charts
+ * how it scales. Runs also get OMP_NUM_THREADS set to their core count,
+ * which OpenMP programs and nproc follow; std::thread::hardware_concurrency()
+ * does not see affinity, so programs sizing their pools with it will
+ * oversubscribe the smaller masks.
+ */
+class ScalingSweepWindow : public MatrixBenchmarkWindow {
+public:
+    ScalingSweepWindow() : MatrixBenchmarkWindow("Scaling Sweep") {
+        m_order = scaling_cpu_order();
+        auto limits = Gtk::make_managed<Gtk::Box>(Gtk::ORIENTATION_HORIZONTAL, 6);
+        limits->pack_start(*Gtk::make_managed<Gtk::Label>("Up to cores:"), Gtk::PACK_SHRINK);
+        m_max_cores.set_range(1, std::max<double>(1, m_order.size()));
+        m_max_cores.set_increments(1, 4);
+        m_max_cores.set_value(m_order.size());
+        limits->pack_start(m_max_cores, Gtk::PACK_SHRINK);
+        m_omp.set_label("Set OMP_NUM_THREADS to the core count");
+        m_omp.set_active(true);
+        limits->pack_start(m_omp, Gtk::PACK_SHRINK);
+        m_options.pack_start(*limits, Gtk::PACK_SHRINK);
+        std::string order;
+        for (int cpu : m_order) order += (order.empty() ? "" : ", ") + std::to_string(cpu);
+        m_cpus.set_text("CPUs in the order cores are added (whole cores before SMT siblings): " + order);
+        m_cpus.set_halign(Gtk::ALIGN_START);
+        m_cpus.set_line_wrap(true);
+        m_options.pack_start(m_cpus, Gtk::PACK_SHRINK);
+        m_results.pack_start(m_chart, Gtk::PACK_EXPAND_WIDGET);
+        show_all_children();
+    }
+
+protected:
+    Planner plan() override {
+        int max = std::min<int>(m_max_cores.get_value_as_int(), static_cast<int>(m_order.size()));
+        std::vector<MatrixCell> cells;
+        m_counts = scaling_core_counts(max);
+        for (int cores : m_counts) {
+            MatrixCell cell;
+            cell.label = std::to_string(cores) + (cores == 1 ? " core" : " cores");
+            cell.cpus.assign(m_order.begin(), m_order.begin() + cores);
+            if (m_omp.get_active()) cell.env.push_back("OMP_NUM_THREADS=" + std::to_string(cores));
+            cells.push_back(cell);
+        }
+        if (cells.size() < 2) throw std::runtime_error("The launcher may only use one CPU, so there is nothing to sweep.");
+        m_chart.set_points({});
+        return [cells](BackgroundJob&) { return cells; };
+    }
+
+    void show_results(const std::vector<BenchmarkReport>& reports) override {
+        std::vector<ScalingChart::Point> points;
+        double single = reports.front().wall().median;
+        for (size_t i = 0; i < reports.size() && i < m_counts.size(); ++i) {
+            double median = reports[i].wall().median;
+            points.push_back({m_counts[i], median > 0 ? single / median : 0.0});
+        }
+        m_chart.set_points(points);
+    }
+
+    std::string notes() const override {
+        return "Speed-up is the median wall time on 1 core over that on n cores; efficiency is speed-up / n.";
+    }
+
+private:
+    std::vector<int> m_order;   // From scaling_cpu_order()
+    std::vector<int> m_counts;  // Core count of each planned cell
+    Gtk::SpinButton m_max_cores;
+    Gtk::CheckButton m_omp;
+    Gtk::Label m_cpus;
+    ScalingChart m_chart;
+};
+
+/**
+ * @brief Runs a project on inputs of growing size, passed as arguments, an
+ * environment variable and/or stdin, and fits growth models to the time
+ * and peak memory measured at each size.
+ */
+class InputSweepWindow : public MatrixBenchmarkWindow {
+public:
+    InputSweepWindow() : MatrixBenchmarkWindow("Input-Size Sweep") {
+        auto grid = Gtk::make_managed<Gtk::Grid>();
+        grid->set_row_spacing(4);
+        grid->set_column_spacing(6);
+        int row = 0;
+        auto add_row = [&](const std::string& label, Gtk::Widget& widget) {
+            auto caption = Gtk::make_managed<Gtk::Label>(label);
+            caption->set_halign(Gtk::ALIGN_START);
+            grid->attach(*caption, 0, row);
+            grid->attach(widget, 1, row++);
+        };
+
+        auto sizes = Gtk::make_managed<Gtk::Box>(Gtk::ORIENTATION_HORIZONTAL, 6);
+        m_first_size.set_range(1, 1e12);
+        m_first_size.set_increments(100, 1000);
+        m_first_size.set_value(1000);
+        m_factor.set_range(2, 10);
+        m_factor.set_value(2);
+        m_steps.set_range(2, 30);
+        m_steps.set_value(6);
+        sizes->pack_start(m_first_size, Gtk::PACK_SHRINK);
+        sizes->pack_start(*Gtk::make_managed<Gtk::Label>("times"), Gtk::PACK_SHRINK);
+        sizes->pack_start(m_factor, Gtk::PACK_SHRINK);
+        sizes->pack_start(*Gtk::make_managed<Gtk::Label>("each step, steps:"), Gtk::PACK_SHRINK);
+        sizes->pack_start(m_steps, Gtk::PACK_SHRINK);
+        add_row("Sizes n:", *sizes);
+
+        m_args.set_text("{n}");
+        m_args.set_tooltip_text("Arguments of each run; {n} is replaced by the size");
+        add_row("Arguments:", m_args);
+        m_env.set_placeholder_text("e.g. N={n}");
+        m_env.set_tooltip_text("NAME=value added to each run's environment; {n} is replaced by the size");
+        add_row("Environment:", m_env);
+
+        auto input = Gtk::make_managed<Gtk::Box>(Gtk::ORIENTATION_HORIZONTAL, 6);
+        m_stdin.append("none", "Nothing");
+        m_stdin.append("integers", "n random integers, one per line");
+        m_stdin.append("counted-integers", "n, then n random integers");
+        m_stdin.append("words", "n random words, one per line");
+        m_stdin.append("files", "Files named by pattern:");
+        m_stdin.set_active(0);
+        m_stdin.signal_changed().connect([this]() { m_input_pattern.set_sensitive(m_stdin.get_active_id() == "files"); });
+        m_input_pattern.set_placeholder_text("inputs/{n}.txt, relative to the project");
+        m_input_pattern.set_width_chars(30);
+        m_input_pattern.set_sensitive(false);
+        input->pack_start(m_stdin, Gtk::PACK_SHRINK);
+        input->pack_start(m_input_pattern, Gtk::PACK_SHRINK);
+        add_row("Standard input:", *input);
+
+        for (const auto& model : complexity_models()) m_expected.append(model.name);
+        m_expected.set_active(2); // O(n)
+        add_row("Expected time:", m_expected);
+        m_options.pack_start(*grid, Gtk::PACK_SHRINK);
+
+        m_fit.set_halign(Gtk::ALIGN_START);
+        m_fit.set_selectable(true);
+        m_results.pack_start(m_fit, Gtk::PACK_SHRINK);
+        show_all_children();
+    }
+
+protected:
+    Planner plan() override {
+        std::vector<std::string> arg_template = split_arguments(m_args.get_text());
+        std::string env_template = m_env.get_text();
+        if (!env_template.empty() && env_template.find('=') == std::string::npos) {
+            throw std::runtime_error("The environment setting needs the form NAME=value.");
+        }
+        std::string input = m_stdin.get_active_id();
+        std::string pattern = m_input_pattern.get_text();
+        if (input == "files" && pattern.find("{n}") == std::string::npos) {
+            throw std::runtime_error("The input file pattern needs {n} where the size goes.");
+        }
+        std::filesystem::path project_dir = std::filesystem::path(project().path).parent_path();
+        bool generate = input != "files" && input != "none";
+        InputGenerator generator = input == "integers" ? InputGenerator::Integers
+                                 : input == "counted-integers" ? InputGenerator::CountedIntegers
+                                 : InputGenerator::Words;
+
+        std::vector<MatrixCell> cells;
+        std::vector<long long> sizes;
+        double n = m_first_size.get_value();
+        for (int step = 0; step < m_steps.get_value_as_int(); ++step, n *= m_factor.get_value()) {
+            if (n > 1e15) throw std::runtime_error("Sizes above 10^15 are not supported; take fewer steps.");
+            long long size = std::llround(n);
+            if (generate && generated_input_bytes(generator, size) > kMaxGeneratedInputBytes) {
+                throw std::runtime_error("The generated input for n = " + std::to_string(size) + " would exceed "
+                                         + std::to_string(kMaxGeneratedInputBytes >> 20) + " MiB; take fewer steps.");
+            }
+            MatrixCell cell;
+            cell.label = "n = " + std::to_string(size);
+            for (const auto& arg : arg_template) cell.args.push_back(substitute_size(arg, size));
+            if (!env_template.empty()) cell.env.push_back(substitute_size(env_template, size));
+            if (input == "files") {
+                cell.input = project_dir / substitute_size(pattern, size);
+                if (!std::filesystem::exists(cell.input)) throw std::runtime_error("No input file " + cell.input.string());
+            }
+            cells.push_back(cell);
+            sizes.push_back(size);
+        }
+        m_sizes.assign(sizes.begin(), sizes.end());
+        m_fit.set_text("");
+        if (!generate) return [cells](BackgroundJob&) { return cells; };
+        // Large inputs take a while to write the first time
+        return [cells, sizes, generator](BackgroundJob& job) mutable {
+            for (size_t i = 0; i < cells.size(); ++i) {
+                if (job.cancelled()) throw std::runtime_error("Cancelled");
+                job.progress("Generating input for " + cells[i].label, 0.0);
+                cells[i].input = generated_input(generator, sizes[i]);
+            }
+            return cells;
+        };
+    }
+
+    void show_results(const std::vector<BenchmarkReport>& reports) override {
+        std::vector<double> wall, rss;
+        for (const auto& report : reports) {
+            wall.push_back(report.wall().median);
+            rss.push_back(report.max_rss_kb().median);
+        }
+        m_time_fit = ComplexityReport::of(m_sizes, wall);
+        m_memory_fit = ComplexityReport::of(m_sizes, rss);
+        size_t expected = static_cast<size_t>(std::max(0, m_expected.get_active_row_number()));
+
+        auto describe = [](const char* what, const ComplexityReport& report) {
+            char line[160];
+            std::snprintf(line, sizeof(line), "%s grows like %s (fit error %.1f%%; local exponent %.2f).", what,
+                          report.best_name(), report.fits[report.best].error * 100, report.exponent);
+            std::string text = line;
+            text += " Other fits:";
+            for (const auto& fit : report.fits) {
+                if (&fit == &report.fits[report.best]) continue;
+                std::snprintf(line, sizeof(line), " %s %.1f%%", complexity_models()[fit.model].name, fit.error * 100);
+                text += line;
+            }
+            return text;
+        };
+        std::string text = describe("Time", m_time_fit) + "\n" + describe("Peak memory", m_memory_fit);
+        if (m_time_fit.worse_than(expected)) {
+            text = "<b>Time grows faster than the expected " + std::string(complexity_models()[expected].name)
+                 + ".</b>\n" + Glib::Markup::escape_text(text);
+        } else {
+            text = Glib::Markup::escape_text(text);
+        }
+        m_fit.set_markup(text);
+    }
+
+    std::string notes() const override {
+        return "Fits use the median of each size and minimise relative error; the constant term absorbs start-up cost.";
+    }
+
+    JsonValue extra_json() const override {
+        if (m_time_fit.fits.empty()) return JsonValue();
+        return JsonValue::make_object()
+            .set("time", m_time_fit.to_json_value())
+            .set("max_rss", m_memory_fit.to_json_value());
+    }
+
+private:
+    Gtk::SpinButton m_first_size;
+    Gtk::SpinButton m_factor;
+    Gtk::SpinButton m_steps;
+    Gtk::Entry m_args;
+    Gtk::Entry m_env;
+    Gtk::ComboBoxText m_stdin;
+    Gtk::Entry m_input_pattern;
+    Gtk::ComboBoxText m_expected;
+    Gtk::Label m_fit;
+    std::vector<double> m_sizes;  // Of each planned cell
+    ComplexityReport m_time_fit;
+    ComplexityReport m_memory_fit;
+};
+
+// --- Watch Window ---
+
+/**
+ * @brief One commit's benchmark in a watch-mode time series.
+ */
+struct WatchPoint {
+    std::string commit;
+    std::string subject;        // First line of the commit message
+    std::vector<double> walls;  // Wall time of each measured run, in seconds
+    double median = 0.0;
+    double q1 = 0.0;            // Interquartile range of the runs
+    double q3 = 0.0;
+    int trend = 0;              // Against the commit before: 1 slower, -1 faster, 0 no clear change
+
+    /** @brief Reads a "benchmark" record of the run history. */
+    static WatchPoint from_record(const JsonValue& record) {
+        WatchPoint point;
+        point.commit = record["commit"].as_string();
+        point.subject = record["subject"].as_string();
+        for (const auto& sample : record["report"]["samples"].array) point.walls.push_back(sample["wall_s"].as_number());
+        std::vector<double> sorted = point.walls;
+        std::sort(sorted.begin(), sorted.end());
+        point.median = percentile(sorted, 0.5);
+        point.q1 = percentile(sorted, 0.25);
+        point.q3 = percentile(sorted, 0.75);
+        return point;
+    }
+};
+
+/**
+ * @brief Median wall time per commit of each watched project, one panel per
+ * project with its own scale. Bars span the interquartile range; commits
+ * significantly slower than the one before are red, faster ones green.
+ */
+class WatchChart : public Gtk::DrawingArea {
+public:
+    static constexpr double kPanelHeight = 190.0;
+
+    WatchChart() { set_size_request(-1, static_cast<int>(kPanelHeight)); }
+
+    void set_series(const std::map<std::string, std::vector<WatchPoint>>& series) {
+        m_series = series;
+        set_size_request(-1, static_cast<int>(kPanelHeight * std::max<size_t>(1, m_series.size())));
+        queue_draw();
+    }
+
+protected:
+    bool on_draw(const Cairo::RefPtr<Cairo::Context>& cr) override {
+        double width = get_allocated_width();
+        cr->set_source_rgb(1.0, 1.0, 1.0);
+        cr->paint();
+        if (m_series.empty()) {
+            draw_text(cr, "No commits benchmarked yet", 12.0, 12.0);
+            return true;
+        }
+        double panel_top = 0.0;
+        for (const auto& [project, points] : m_series) {
+            draw_panel(cr, project, points, panel_top, width);
+            panel_top += kPanelHeight;
+        }
+        return true;
+    }
+
+private:
+    std::map<std::string, std::vector<WatchPoint>> m_series;  // By project, oldest commit first
+
+    void draw_panel(const Cairo::RefPtr<Cairo::Context>& cr, const std::string& project,
+                    const std::vector<WatchPoint>& points, double panel_top, double width) {
+        const double left = 64.0, right = width - 16.0, top = panel_top + 24.0, bottom = panel_top + kPanelHeight - 34.0;
+        draw_text(cr, project + ": median wall time (ms) per commit, oldest first", left, panel_top + 4.0);
+        cr->set_line_width(1.0);
+        cr->set_source_rgb(0.6, 0.6, 0.6);
+        cr->move_to(left, top);
+        cr->line_to(left, bottom);
+        cr->line_to(right, bottom);
+        cr->stroke();
+        if (points.empty()) return;
+
+        double max_wall = 0.0;
+        for (const auto& point : points) max_wall = std::max(max_wall, point.q3);
+        if (max_wall <= 0.0) max_wall = 1.0;
+        double step = points.size() > 1 ? (right - left - 20.0) / static_cast<double>(points.size() - 1) : 0.0;
+        auto x_of = [&](size_t i) { return left + 10.0 + step * static_cast<double>(i); };
+        auto y_of = [&](double wall) { return bottom - (bottom - top) * wall / (max_wall * 1.1); };
+        char text[32];
+        for (int tick = 0; tick <= 4; ++tick) {
+            double wall = max_wall * 1.1 * tick / 4;
+            std::snprintf(text, sizeof(text), "%.4g", wall * 1e3);
+            draw_text(cr, text, 6.0, y_of(wall) - 8.0);
+        }
+        // Short SHAs under the points, thinned out so they do not overlap
+        size_t every = std::max<size_t>(1, static_cast<size_t>(std::ceil(64.0 / std::max(step, 1.0))));
+        for (size_t i = 0; i < points.size(); i += every) {
+            draw_text(cr, points[i].commit.substr(0, 7), x_of(i) - 20.0, bottom + 4.0);
+        }
+
+        cr->set_source_rgb(0.16, 0.40, 0.75);
+        cr->set_line_width(2.0);
+        for (size_t i = 0; i < points.size(); ++i) {
+            if (i == 0) cr->move_to(x_of(i), y_of(points[i].median));
+            else cr->line_to(x_of(i), y_of(points[i].median));
+        }
+        cr->stroke();
+        cr->set_line_width(1.0);
+        for (size_t i = 0; i < points.size(); ++i) {
+            const WatchPoint& point = points[i];
+            if (point.trend > 0) cr->set_source_rgb(0.80, 0.15, 0.15);
+            else if (point.trend < 0) cr->set_source_rgb(0.15, 0.60, 0.20);
+            else cr->set_source_rgb(0.16, 0.40, 0.75);
+            cr->move_to(x_of(i), y_of(point.q1));
+            cr->line_to(x_of(i), y_of(point.q3));
+            cr->stroke();
+            cr->arc(x_of(i), y_of(point.median), 3.5, 0.0, 2 * M_PI);
+            cr->fill();
+        }
+    }
+
+    void draw_text(const Cairo::RefPtr<Cairo::Context>& cr, const std::string& text, double x, double y) {
+        auto layout = create_pango_layout(text);
+        cr->save();
+        cr->set_source_rgb(0.2, 0.2, 0.2);
+        cr->move_to(x, y);
+        layout->show_in_cairo_context(cr);
+        cr->restore();
+    }
+};
+
+/**
+ * @brief Watch mode: polls the clones of the C++ projects for new upstream
+ * commits and benchmarks each one, building it only when the project's
+ * directory changed (build_commit). Every result is appended to the run
+ * history as a "benchmark" record, which is also where the per-commit chart
+ * is loaded from, so the series carries over between sessions.
+ * The first poll of a session benchmarks the checkout as cloned, unless the
+ * history already has it, as the baseline for the commits that follow.
+ */
+class WatchWindow : public Gtk::Window {
+public:
+    static constexpr size_t kMaxCommitsPerPoll = 10;  // Older ones in a larger batch are skipped
+
+    /**
+     * @brief Called when a new commit is significantly slower than the one
+     * before, with the project, the two commits and a description.
+     */
+    std::function<void(const Project&, const std::string& good, const std::string& bad, const std::string& text)> on_regression;
+
+    WatchWindow() : m_vbox(Gtk::ORIENTATION_VERTICAL) {
+        set_title("Watch Mode");
+        set_default_size(820, 560);
+        m_vbox.set_spacing(6);
+        m_vbox.set_border_width(10);
+        add(m_vbox);
+
+        m_projects_label.set_halign(Gtk::ALIGN_START);
+        m_projects_label.set_line_wrap(true);
+        m_vbox.pack_start(m_projects_label, Gtk::PACK_SHRINK);
+
+        auto build = Gtk::make_managed<Gtk::Box>(Gtk::ORIENTATION_HORIZONTAL, 6);
+        build->pack_start(*Gtk::make_managed<Gtk::Label>("Profile:"), Gtk::PACK_SHRINK);
+        for (const auto& profile : build_profiles()) {
+            m_profile.append(profile.name, profile.name + " (" + format_command(profile.flags) + ")");
+        }
+        m_profile.set_active(1);
+        build->pack_start(m_profile, Gtk::PACK_SHRINK);
+        build->pack_start(*Gtk::make_managed<Gtk::Label>("Arguments:"), Gtk::PACK_SHRINK);
+        m_args.set_placeholder_text("none");
+        build->pack_start(m_args, Gtk::PACK_EXPAND_WIDGET);
+        m_vbox.pack_start(*build, Gtk::PACK_SHRINK);
+        m_vbox.pack_start(m_run_controls, Gtk::PACK_SHRINK);
+
+        auto controls = Gtk::make_managed<Gtk::Box>(Gtk::ORIENTATION_HORIZONTAL, 6);
+        controls->pack_start(*Gtk::make_managed<Gtk::Label>("Warm-up runs:"), Gtk::PACK_SHRINK);
+        m_warmup.set_range(0, 1000);
+        m_warmup.set_increments(1, 10);
+        m_warmup.set_value(2);
+        controls->pack_start(m_warmup, Gtk::PACK_SHRINK);
+        controls->pack_start(*Gtk::make_managed<Gtk::Label>("Measured runs:"), Gtk::PACK_SHRINK);
+        m_runs.set_range(3, 100000);
+        m_runs.set_increments(1, 10);
+        m_runs.set_value(10);
+        controls->pack_start(m_runs, Gtk::PACK_SHRINK);
+        controls->pack_start(*Gtk::make_managed<Gtk::Label>("Poll every (min):"), Gtk::PACK_SHRINK);
+        m_interval.set_range(1, 24 * 60);
+        m_interval.set_increments(1, 15);
+        m_interval.set_value(10);
+        m_interval.signal_value_changed().connect([this]() {
+            if (m_watch.get_active()) schedule();
+        });
+        controls->pack_start(m_interval, Gtk::PACK_SHRINK);
+        m_watch.set_label("Watch");
+        m_watch.set_tooltip_text("Poll for new commits now and then every interval");
+        m_watch.signal_toggled().connect([this]() {
+            if (m_watch.get_active()) {
+                schedule();
+                poll();
+            } else {
+                m_timer.disconnect();
+            }
+        });
+        controls->pack_start(m_watch, Gtk::PACK_SHRINK);
+        m_poll_btn.signal_clicked().connect(sigc::mem_fun(*this, &WatchWindow::poll));
+        m_stop_btn.signal_clicked().connect([this]() { m_job.cancel(); });
+        controls->pack_end(m_stop_btn, Gtk::PACK_SHRINK);
+        controls->pack_end(m_poll_btn, Gtk::PACK_SHRINK);
+        m_vbox.pack_start(*controls, Gtk::PACK_SHRINK);
+
+        m_progress.set_show_text(true);
+        m_vbox.pack_start(m_progress, Gtk::PACK_SHRINK);
+        m_scrolledwindow.set_policy(Gtk::POLICY_NEVER, Gtk::POLICY_AUTOMATIC);
+        m_scrolledwindow.add(m_chart);
+        m_vbox.pack_start(m_scrolledwindow, Gtk::PACK_EXPAND_WIDGET);
+        m_status.set_halign(Gtk::ALIGN_START);
+        m_status.set_selectable(true);
+        m_status.set_line_wrap(true);
+        m_vbox.pack_start(m_status, Gtk::PACK_SHRINK);
+
+        for (const JsonValue& record : m_store.load()) {
+            std::string type = record["type"].as_string();
+            if (type == "benchmark" && record["source"].as_string() == "watch") add_point(record);
+            if (type == "watch_seen") m_last_seen[record["project"].as_string()] = record["commit"].as_string();
+        }
+        m_chart.set_series(m_series);
+
+        m_job.on_progress = [this](const std::string& text, double) {
+            m_progress.set_text(text);
+            m_progress.pulse();
+        };
+        set_busy(false);
+        show_all_children();
+    }
+    ~WatchWindow() { m_timer.disconnect(); }
+
+    /** @brief The projects to watch: those built from C++ sources. */
+    void set_projects(const std::vector<Project>& projects) {
+        m_projects.clear();
+        std::string names;
+        for (const auto& project : projects) {
+            if (project.type != "C++" || project.name.find("Calculator") != std::string::npos) continue;
+            m_projects.push_back(project);
+            names += (names.empty() ? "" : ", ") + project.name;
+        }
+        m_projects_label.set_text(names.empty() ? "No C++ projects to watch." : "Watching: " + names);
+    }
+
+    /** @brief The C++ compiler chosen in the main window; empty for default_compiler(). */
+    void set_compiler(const std::string& compiler) { m_compiler = compiler; }
+
+private:
+    Gtk::Box m_vbox;
+    Gtk::Label m_projects_label;
+    Gtk::ComboBoxText m_profile;
+    Gtk::Entry m_args;
+    RunControlsBox m_run_controls;
+    Gtk::SpinButton m_warmup;
+    Gtk::SpinButton m_runs;
+    Gtk::SpinButton m_interval;
+    Gtk::CheckButton m_watch;
+    Gtk::Button m_poll_btn{"Poll Now"};
+    Gtk::Button m_stop_btn{"Stop"};
+    Gtk::ProgressBar m_progress;
+    Gtk::ScrolledWindow m_scrolledwindow;
+    WatchChart m_chart;
+    Gtk::Label m_status;
+    std::vector<Project> m_projects;
+    std::string m_compiler;  // Empty for default_compiler()
+    HistoryStore m_store;
+    std::map<std::string, std::vector<WatchPoint>> m_series;  // By project
+    std::map<std::string, std::string> m_last_seen;           // Newest commit polled, by project
+    sigc::connection m_timer;
+    BackgroundJob m_job;  // Fetches and benchmarks new commits
+
+    void set_busy(bool busy) {
+        m_poll_btn.set_sensitive(!busy);
+        m_stop_btn.set_sensitive(busy);
+        m_profile.set_sensitive(!busy);
+        m_args.set_sensitive(!busy);
+        m_run_controls.set_sensitive(!busy);
+        m_warmup.set_sensitive(!busy);
+        m_runs.set_sensitive(!busy);
+    }
+
+    void schedule() {
+        m_timer.disconnect();
+        m_timer = Glib::signal_timeout().connect_seconds([this]() {
+            poll();
+            return true;
+        }, static_cast<unsigned>(m_interval.get_value_as_int()) * 60);
+    }
+
+    /** @brief Starts a poll of every project, unless one is still running. */
+    void poll() {
+        if (m_job.busy() || m_projects.empty()) return;
+        RunControls controls;
+        std::vector<std::string> args;
+        try {
+            controls = m_run_controls.controls();
+            args = split_arguments(m_args.get_text());
+        } catch (const std::exception& e) {
+            m_status.set_text(e.what());
+            return;
+        }
+        std::set<std::string> benchmarked;
+        for (const auto& [project, points] : m_series) {
+            for (const auto& point : points) benchmarked.insert(project + "@" + point.commit);
+        }
+        CommitBenchmarkSettings settings;
+        settings.compiler = m_compiler;
+        settings.profile = build_profiles()[std::max(0, m_profile.get_active_row_number())];
+        settings.controls = controls;
+        settings.args = args;
+        settings.warmup = static_cast<unsigned>(m_warmup.get_value_as_int());
+        settings.runs = static_cast<unsigned>(m_runs.get_value_as_int());
+        m_status.set_text("");
+        set_busy(true);
+        m_job.start([this, projects = m_projects, last_seen = m_last_seen, benchmarked, settings]() {
+            poll_worker(projects, last_seen, benchmarked, settings);
+        }, sigc::mem_fun(*this, &WatchWindow::on_finished));
+    }
+
+    /** @brief Worker side: hands a benchmark record and/or the newest commit polled to the main loop. */
+    void post(JsonValue record, const std::string& project, const std::string& last_seen) {
+        m_job.post([this, record = std::move(record), project, last_seen]() {
+            std::string status = remember(project, last_seen);
+            if (!record.is_null()) status += add_record(record);
+            if (!status.empty()) m_status.set_text(m_status.get_text() + status);
+        });
+    }
+
+    /**
+     * @brief Worker thread: fetches each project's clone and benchmarks the
+     * commits it gained, oldest first. A project that cannot be fetched or
+     * a commit that does not build is reported and skipped.
+     */
+    void poll_worker(std::vector<Project> projects, std::map<std::string, std::string> last_seen,
+                     std::set<std::string> benchmarked, CommitBenchmarkSettings settings) {
+        std::string errors;
+        for (const auto& project : projects) {
+            if (m_job.cancelled()) break;
+            try {
+                std::filesystem::path source = project.path;
+                std::filesystem::path repo = git_output(source.parent_path(), {"rev-parse", "--show-toplevel"});
+                std::filesystem::path relative = std::filesystem::relative(source, repo);
+                std::vector<std::string> commits;
+                auto seen = last_seen.find(project.name);
+                std::string since;
+                if (seen != last_seen.end()) {
+                    try {
+                        git_output(repo, {"cat-file", "-e", seen->second + "^{commit}"});
+                        since = seen->second;
+                    } catch (const std::exception&) {
+                        // Gone, e.g. after a force-push; start again from HEAD
+                    }
+                }
+                if (since.empty()) {
+                    since = git_output(repo, {"rev-parse", "HEAD"});
+                    if (!benchmarked.count(project.name + "@" + since)) commits.push_back(since);
+                }
+                m_job.progress(project.name + ": fetching", 0.0);
+                std::vector<std::string> fresh = fetch_new_commits(repo, since);
+                fresh.erase(std::remove_if(fresh.begin(), fresh.end(), [&](const std::string& sha) {
+                    return benchmarked.count(project.name + "@" + sha) > 0;
+                }), fresh.end());
+                if (fresh.size() > kMaxCommitsPerPoll) {
+                    errors += project.name + ": " + std::to_string(fresh.size() - kMaxCommitsPerPoll)
+                            + " older new commit(s) skipped\n";
+                    fresh.erase(fresh.begin(), fresh.end() - kMaxCommitsPerPoll);
+                }
+                commits.insert(commits.end(), fresh.begin(), fresh.end());
+                if (commits.empty()) {
+                    m_job.progress(project.name + ": up to date", 0.0);
+                    post(JsonValue(), project.name, since);
+                }
+                for (const auto& sha : commits) {
+                    if (m_job.cancelled()) break;
+                    std::string label = project.name + " " + sha.substr(0, 7) + ": ";
+                    try {
+                        JsonValue record = watch_record(project, repo, relative, sha, settings, label);
+                        if (m_job.cancelled()) break;
+                        m_job.progress(label + "done", 0.0);
+                        post(std::move(record), project.name, sha);
+                    } catch (const std::exception& e) {
+                        // Not retried: the next poll carries on from the commit after it
+                        errors += label + e.what() + "\n";
+                        m_job.progress(label + "failed", 0.0);
+                        post(JsonValue(), project.name, sha);
+                    }
+                }
+            } catch (const std::exception& e) {
+                errors += project.name + ": " + e.what() + "\n";
+            }
+        }
+        if (m_job.cancelled()) errors += "Stopped\n";
+        if (!errors.empty()) m_job.post([this, errors]() { m_status.set_text(m_status.get_text() + errors); });
+    }
+
+    /** @brief Benchmarks one commit as a "benchmark" record; runs on the worker thread. */
+    JsonValue watch_record(const Project& project, const std::filesystem::path& repo, const std::filesystem::path& relative,
+                           const std::string& sha, const CommitBenchmarkSettings& settings, const std::string& label) {
+        bool reused = false;
+        BenchmarkReport report = benchmark_commit(project.name, repo, relative, sha, settings, m_job.canceller(),
+                                                  [this, &label](const std::string& step) { m_job.progress(label + step, 0.0); },
+                                                  reused);
+        std::string subject;
+        try {
+            subject = git_output(repo, {"log", "-1", "--format=%s", sha});
+        } catch (const std::exception&) {
+        }
+        return JsonValue::make_object()
+            .set("type", "benchmark")
+            .set("source", "watch")
+            .set("project", project.name)
+            .set("started", static_cast<long long>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                                std::chrono::system_clock::now().time_since_epoch()).count()))
+            .set("commit", sha)
+            .set("subject", subject)
+            .set("rebuilt", !reused)
+            .set("report", report.to_json_value());
+    }
+
+    /**
+     * @brief Adds a benchmarked commit to its project's series, replacing an
+     * earlier measurement of the same commit, and compares it with the commit
+     * before it. @return The point as added.
+     */
+    const WatchPoint& add_point(const JsonValue& record) {
+        std::vector<WatchPoint>& points = m_series[record["project"].as_string()];
+        WatchPoint point = WatchPoint::from_record(record);
+        points.erase(std::remove_if(points.begin(), points.end(),
+                                    [&point](const WatchPoint& other) { return other.commit == point.commit; }),
+                     points.end());
+        if (!points.empty() && points.back().walls.size() >= 2 && point.walls.size() >= 2) {
+            ABComparison comparison = ABComparison::of(points.back().walls, point.walls);
+            if (comparison.significant) point.trend = comparison.relative_change > 0 ? 1 : -1;
+        }
+        points.push_back(std::move(point));
+        return points.back();
+    }
+
+    /**
+     * @brief Stores the newest commit polled of a project with the history,
+     * so that the next session carries on from there. @return Any error, for the status.
+     */
+    std::string remember(const std::string& project, const std::string& sha) {
+        if (sha.empty() || m_last_seen[project] == sha) return "";
+        m_last_seen[project] = sha;
+        if (m_store.append(JsonValue::make_object().set("type", "watch_seen").set("project", project).set("commit", sha))) {
+            return "";
+        }
+        return "Could not write the run history " + m_store.path().string() + "\n";
+    }
+
+    /** @brief Stores a benchmark record and charts it. @return A regression it shows, or an error, for the status. */
+    std::string add_record(const JsonValue& record) {
+        std::string status;
+        if (!m_store.append(record)) status += "Could not write the run history " + m_store.path().string() + "\n";
+        std::string project = record["project"].as_string();
+        const WatchPoint& point = add_point(record);
+        m_chart.set_series(m_series);
+        const std::vector<WatchPoint>& points = m_series[project];
+        if (point.trend <= 0 || points.size() < 2) return status;
+        const WatchPoint& before = points[points.size() - 2];
+        char change[64];
+        std::snprintf(change, sizeof(change), "%+.1f%% median wall time", (point.median / before.median - 1) * 100);
+        std::string text = "Performance regression in " + project + " at commit " + point.commit.substr(0, 12)
+                         + " (" + point.subject + "): " + change + " against " + before.commit.substr(0, 12);
+        auto project_of = std::find_if(m_projects.begin(), m_projects.end(),
+                                       [&project](const Project& watched) { return watched.name == project; });
+        if (on_regression && project_of != m_projects.end()) on_regression(*project_of, before.commit, point.commit, text);
+        return status + text + "\n";
+    }
+
+    void on_finished(const std::string& error) {
+        set_busy(false);
+        std::time_t now = std::time(nullptr);
+        char polled[64];
+        std::strftime(polled, sizeof(polled), "Last polled %H:%M:%S", std::localtime(&now));
+        m_progress.set_fraction(1.0);
+        m_progress.set_text(polled);
+        if (!error.empty()) m_status.set_text(m_status.get_text() + error + "\n");
+    }
+};
+
+// --- Bisect Window ---
+
+/**
+ * @brief Finds the commit that made a project slower: measures the good and
+ * bad commits, checks that bad is significantly slower, then bisects the
+ * first-parent history between them (PerformanceBisector), building each
+ * candidate with build_commit's cache. The clone is deepened as needed.
+ * Every commit measured is listed with its change against good.
+ */
+class BisectWindow : public Gtk::Window {
+public:
+    BisectWindow() : m_vbox(Gtk::ORIENTATION_VERTICAL) {
+        set_title("Performance Bisect");
+        set_default_size(860, 480);
+        m_vbox.set_spacing(6);
+        m_vbox.set_border_width(10);
+        add(m_vbox);
+
+        m_title.set_halign(Gtk::ALIGN_START);
+        m_vbox.pack_start(m_title, Gtk::PACK_SHRINK);
+
+        auto range = Gtk::make_managed<Gtk::Box>(Gtk::ORIENTATION_HORIZONTAL, 6);
+        range->pack_start(*Gtk::make_managed<Gtk::Label>("Good:"), Gtk::PACK_SHRINK);
+        m_good.set_placeholder_text("fast commit, e.g. HEAD~20");
+        range->pack_start(m_good, Gtk::PACK_EXPAND_WIDGET);
+        range->pack_start(*Gtk::make_managed<Gtk::Label>("Bad:"), Gtk::PACK_SHRINK);
+        m_bad.set_text("HEAD");
+        m_bad.set_placeholder_text("slow commit");
+        range->pack_start(m_bad, Gtk::PACK_EXPAND_WIDGET);
+        range->pack_start(*Gtk::make_managed<Gtk::Label>("Profile:"), Gtk::PACK_SHRINK);
+        for (const auto& profile : build_profiles()) {
+            m_profile.append(profile.name, profile.name + " (" + format_command(profile.flags) + ")");
+        }
+        m_profile.set_active(1);
+        range->pack_start(m_profile, Gtk::PACK_SHRINK);
+        m_vbox.pack_start(*range, Gtk::PACK_SHRINK);
+
+        auto args = Gtk::make_managed<Gtk::Box>(Gtk::ORIENTATION_HORIZONTAL, 6);
+        args->pack_start(*Gtk::make_managed<Gtk::Label>("Arguments:"), Gtk::PACK_SHRINK);
+        m_args.set_placeholder_text("none");
+        args->pack_start(m_args, Gtk::PACK_EXPAND_WIDGET);
+        m_vbox.pack_start(*args, Gtk::PACK_SHRINK);
+        m_vbox.pack_start(m_run_controls, Gtk::PACK_SHRINK);
+
+        auto controls = Gtk::make_managed<Gtk::Box>(Gtk::ORIENTATION_HORIZONTAL, 6);
+        controls->pack_start(*Gtk::make_managed<Gtk::Label>("Warm-up runs:"), Gtk::PACK_SHRINK);
+        m_warmup.set_range(0, 1000);
+        m_warmup.set_increments(1, 10);
+        m_warmup.set_value(2);
+        controls->pack_start(m_warmup, Gtk::PACK_SHRINK);
+        controls->pack_start(*Gtk::make_managed<Gtk::Label>("Measured runs (each commit):"), Gtk::PACK_SHRINK);
+        m_runs.set_range(3, 100000);
+        m_runs.set_increments(1, 10);
+        m_runs.set_value(10);
+        controls->pack_start(m_runs, Gtk::PACK_SHRINK);
+        m_start_btn.signal_clicked().connect(sigc::mem_fun(*this, &BisectWindow::start));
+        m_cancel_btn.signal_clicked().connect([this]() { m_job.cancel(); });
+        controls->pack_end(m_cancel_btn, Gtk::PACK_SHRINK);
+        controls->pack_end(m_start_btn, Gtk::PACK_SHRINK);
+        m_vbox.pack_start(*controls, Gtk::PACK_SHRINK);
+
+        m_progress.set_show_text(true);
+        m_vbox.pack_start(m_progress, Gtk::PACK_SHRINK);
+
+        m_store = Gtk::ListStore::create(m_columns);
+        m_treeview.set_model(m_store);
+        m_treeview.append_column_numeric("Step", m_columns.step, "%d");
+        m_treeview.append_column("Commit", m_columns.commit);
+        m_treeview.append_column_numeric("Median wall (ms)", m_columns.median, "%.3f");
+        m_treeview.append_column_numeric("vs good (%)", m_columns.change, "%+.1f");
+        m_treeview.append_column_numeric("p", m_columns.p_value, "%.2g");
+        m_treeview.append_column("Verdict", m_columns.verdict);
+        m_treeview.append_column("Build", m_columns.build);
+        m_treeview.append_column("Subject", m_columns.subject);
+        m_scrolledwindow.set_policy(Gtk::POLICY_AUTOMATIC, Gtk::POLICY_AUTOMATIC);
+        m_scrolledwindow.add(m_treeview);
+        m_vbox.pack_start(m_scrolledwindow, Gtk::PACK_EXPAND_WIDGET);
+
+        m_result.set_halign(Gtk::ALIGN_START);
+        m_result.set_selectable(true);
+        m_result.set_line_wrap(true);
+        m_vbox.pack_start(m_result, Gtk::PACK_SHRINK);
+
+        m_job.on_progress = [this](const std::string& text, double fraction) {
+            m_progress.set_fraction(fraction);
+            m_progress.set_text(text);
+        };
+        set_busy(false);
+        show_all_children();
+    }
+
+    /** @brief Selects the project to bisect; ignored while a bisect is running. */
+    void set_project(const Project& project) {
+        if (m_job.busy()) return;
+        m_project = project;
+        m_title.set_markup("<b>" + Glib::Markup::escape_text(project.name) + "</b>");
+    }
+
+    /** @brief Fills in a range where a slow-down was detected; ignored while a bisect is running. */
+    void suggest(const Project& project, const std::string& good, const std::string& bad) {
+        if (m_job.busy()) return;
+        set_project(project);
+        m_good.set_text(good);
+        m_bad.set_text(bad);
+    }
+
+    /** @brief The C++ compiler chosen in the main window; empty for default_compiler(). */
+    void set_compiler(const std::string& compiler) { m_compiler = compiler; }
+
+private:
+    struct Columns : public Gtk::TreeModel::ColumnRecord {
+        Columns() { add(step); add(commit); add(median); add(change); add(p_value); add(verdict); add(build); add(subject); }
+        Gtk::TreeModelColumn<int> step;
+        Gtk::TreeModelColumn<Glib::ustring> commit;
+        Gtk::TreeModelColumn<double> median;
+        Gtk::TreeModelColumn<double> change;
+        Gtk::TreeModelColumn<double> p_value;
+        Gtk::TreeModelColumn<Glib::ustring> verdict;
+        Gtk::TreeModelColumn<Glib::ustring> build;
+        Gtk::TreeModelColumn<Glib::ustring> subject;
+    };
+
+    Gtk::Box m_vbox;
+    Gtk::Label m_title;
+    Gtk::Entry m_good;
+    Gtk::Entry m_bad;
+    Gtk::ComboBoxText m_profile;
+    Gtk::Entry m_args;
+    RunControlsBox m_run_controls;
+    Gtk::SpinButton m_warmup;
+    Gtk::SpinButton m_runs;
+    Gtk::Button m_start_btn{"Bisect"};
+    Gtk::Button m_cancel_btn{"Cancel"};
+    Gtk::ProgressBar m_progress;
+    Columns m_columns;
+    Glib::RefPtr<Gtk::ListStore> m_store;
+    Gtk::TreeView m_treeview;
+    Gtk::ScrolledWindow m_scrolledwindow;
+    Gtk::Label m_result;
+    Project m_project;
+    std::string m_compiler;  // Empty for default_compiler()
+    int m_step_count = 0;
+    BackgroundJob m_job;  // Measures the commits
+
+    void set_busy(bool busy) {
+        m_start_btn.set_sensitive(!busy);
+        m_cancel_btn.set_sensitive(busy);
+        m_good.set_sensitive(!busy);
+        m_bad.set_sensitive(!busy);
+        m_profile.set_sensitive(!busy);
+        m_args.set_sensitive(!busy);
+        m_run_controls.set_sensitive(!busy);
+        m_warmup.set_sensitive(!busy);
+        m_runs.set_sensitive(!busy);
+    }
+
+    void start() {
+        if (m_job.busy() || m_project.path.empty()) return;
+        if (m_good.get_text().empty() || m_bad.get_text().empty()) {
+            m_result.set_text("Enter a good (fast) and a bad (slow) commit.");
+            return;
+        }
+        CommitBenchmarkSettings settings;
+        try {
+            settings.controls = m_run_controls.controls();
+            settings.args = split_arguments(m_args.get_text());
+        } catch (const std::exception& e) {
+            m_result.set_text(e.what());
+            return;
+        }
+        settings.compiler = m_compiler;
+        settings.profile = build_profiles()[std::max(0, m_profile.get_active_row_number())];
+        settings.warmup = static_cast<unsigned>(m_warmup.get_value_as_int());
+        settings.runs = static_cast<unsigned>(m_runs.get_value_as_int());
+        m_store->clear();
+        m_step_count = 0;
+        m_result.set_text("");
+        set_busy(true);
+        m_job.start([this, project = m_project, good = std::string(m_good.get_text()), bad = std::string(m_bad.get_text()),
+                     settings]() { run_worker(project, good, bad, settings); },
+                    sigc::mem_fun(*this, &BisectWindow::on_finished));
+    }
+
+    /** @brief Worker side: lists a measured commit. */
+    void post(const std::string& text, const BisectStep& step) {
+        m_job.progress(text, 0.0);
+        m_job.post([this, step]() { add_row(step); });
+    }
+
+    /**
+     * @brief Worker thread: resolves and measures both ends, then bisects.
+     * The ends must measure; a commit in between that fails is skipped.
+     */
+    void run_worker(Project project, std::string good, std::string bad, CommitBenchmarkSettings settings) {
+        std::filesystem::path source = project.path;
+        std::filesystem::path repo = git_output(source.parent_path(), {"rev-parse", "--show-toplevel"});
+        std::filesystem::path relative = std::filesystem::relative(source, repo);
+        m_job.progress("Resolving " + good + " and " + bad, 0.0);
+        std::string good_sha = git_resolve_commit(repo, good);
+        std::string bad_sha = git_resolve_commit(repo, bad);
+        m_job.progress("Fetching the history between them", 0.0);
+        std::vector<std::string> commits = first_parent_range(repo, good_sha, bad_sha);
+        if (commits.size() < 2) throw std::runtime_error("Good and bad are the same commit; nothing to bisect.");
+        // About log2(n) commits in between, plus the two ends
+        double expected = std::ceil(std::log2(static_cast<double>(commits.size() - 1))) + 2;
+        size_t measured = 0;
+
+        BisectStep good_step;
+        auto measure = [&](size_t index) {
+            BisectStep step;
+            step.index = index;
+            step.commit = commits[index];
+            try {
+                step.subject = git_output(repo, {"log", "-1", "--format=%s", step.commit});
+            } catch (const std::exception&) {
+            }
+            std::string label = "Commit " + std::to_string(measured + 1) + " of about "
+                              + std::to_string(static_cast<int>(expected)) + ", " + step.commit.substr(0, 7) + ": ";
+            double fraction = std::min(1.0, static_cast<double>(measured) / expected);
+            bool reused = false;
+            BenchmarkReport report = benchmark_commit(project.name, repo, relative, step.commit, settings,
+                                                      m_job.canceller(),
+                                                      [&](const std::string& text) { m_job.progress(label + text, fraction); },
+                                                      reused);
+            ++measured;
+            if (m_job.cancelled()) throw std::runtime_error("Cancelled");
+            for (const auto& sample : report.samples) step.walls.push_back(sample.usage.wall_seconds);
+            step.wall = SampleStats::of(step.walls);
+            step.rebuilt = !reused;
+            if (index != 0) step.against_good = ABComparison::of(good_step.walls, step.walls);
+            return step;
+        };
+        auto measure_end = [&](size_t index, const std::string& name) {
+            try {
+                return measure(index);
+            } catch (const std::exception& e) {
+                throw std::runtime_error(name + " commit " + commits[index].substr(0, 12) + ": " + e.what());
+            }
+        };
+        good_step = measure_end(0, "Good");
+        post("Measured good", good_step);
+        BisectStep bad_step = measure_end(commits.size() - 1, "Bad");
+        bad_step.slow = true;
+        post("Measured bad", bad_step);
+        const ABComparison& change = bad_step.against_good;
+        if (!change.significant || change.relative_change <= 0) {
+            throw std::runtime_error(bad_sha.substr(0, 12) + " is not significantly slower than " + good_sha.substr(0, 12)
+                                     + ": " + change.verdict());
+        }
+
+        std::map<size_t, BisectStep> steps = {{0, good_step}, {commits.size() - 1, bad_step}};
+        PerformanceBisector bisector(commits.size());
+        using Verdict = PerformanceBisector::Verdict;
+        for (size_t index; (index = bisector.next()) != PerformanceBisector::npos && !m_job.cancelled();) {
+            BisectStep step;
+            try {
+                step = measure(index);
+                Verdict verdict = PerformanceBisector::classify(good_step.walls, bad_step.walls, step.walls);
+                if (verdict == Verdict::Unclear) {
+                    // One more round of runs before skipping it: noise may hide a real difference
+                    BisectStep again = measure(index);
+                    step.walls.insert(step.walls.end(), again.walls.begin(), again.walls.end());
+                    step.wall = SampleStats::of(step.walls);
+                    step.against_good = ABComparison::of(good_step.walls, step.walls);
+                    verdict = PerformanceBisector::classify(good_step.walls, bad_step.walls, step.walls);
+                }
+                if (verdict == Verdict::Unclear) {
+                    throw std::runtime_error("not significantly different from either good or bad");
+                }
+                step.slow = verdict == Verdict::Slow;
+                bisector.mark(index, step.slow);
+                steps[index] = step;
+            } catch (const std::exception& e) {
+                if (m_job.cancelled()) break;
+                step.index = index;
+                step.commit = commits[index];
+                step.error = e.what();
+                bisector.skip(index);
+            }
+            post("Bisecting", step);
+        }
+        if (m_job.cancelled()) throw std::runtime_error("Cancelled");
+
+        const BisectStep& fast = steps.at(bisector.last_fast());
+        const BisectStep& slow = steps.at(bisector.first_slow());
+        ABComparison delta = ABComparison::of(fast.walls, slow.walls);
+        char text[160];
+        std::snprintf(text, sizeof(text), "%+.1f%% median wall time (95%% CI %+.1f%% to %+.1f%%, p = %.2g)",
+                      delta.relative_change * 100, delta.ci_low * 100, delta.ci_high * 100, delta.p_value);
+        std::string result;
+        if (bisector.exact()) {
+            result = "First slow commit: " + slow.commit.substr(0, 12) + " \"" + slow.subject + "\", " + text
+                   + " against its parent " + fast.commit.substr(0, 12) + ".";
+        } else {
+            result = "The slow-down is in one of the commits after " + fast.commit.substr(0, 12) + " up to "
+                   + slow.commit.substr(0, 12) + ", which could not all be measured: " + text + ".";
+        }
+        result += "\nThe whole range: " + change.verdict();
+        m_job.post([this, result]() { m_result.set_text(result); });
+    }
+
+    void on_finished(const std::string& error) {
+        set_busy(false);
+        m_progress.set_fraction(1.0);
+        m_progress.set_text("Done");
+        if (!error.empty()) m_result.set_text(error);
+    }
+
+    void add_row(const BisectStep& step) {
+        Gtk::TreeModel::Row row = *m_store->append();
+        row[m_columns.step] = ++m_step_count;
+        row[m_columns.commit] = step.commit.substr(0, 12);
+        row[m_columns.subject] = step.subject;
+        if (!step.error.empty()) {
+            row[m_columns.verdict] = "skipped: " + step.error.substr(0, step.error.find('\n'));
+            return;
+        }
+        row[m_columns.median] = step.wall.median * 1e3;
+        row[m_columns.change] = step.against_good.relative_change * 100;
+        row[m_columns.p_value] = step.index == 0 ? 1.0 : step.against_good.p_value;
+        row[m_columns.verdict] = step.index == 0 ? "good" : step.slow ? "slow" : "fast";
+        row[m_columns.build] = step.rebuilt ? "built" : "cached";
+    }
+};
+
+// --- Cache Simulation Window ---
+
+/**
+ * @brief Runs a C++ project once under Cachegrind or Callgrind and lists
+ * the instructions and simulated cache misses of each function, for when
+ * the machine (e.g. a VM) gives no hardware counters. A second commit can
+ * be run too; the counts are deterministic, so their difference is the
+ * change itself rather than noise.
+ */
+class CacheSimWindow : public Gtk::Window {
+public:
+    CacheSimWindow() : m_vbox(Gtk::ORIENTATION_VERTICAL) {
+        set_title("Cache Simulation");
+        set_default_size(900, 520);
+        m_vbox.set_spacing(6);
+        m_vbox.set_border_width(10);
+        add(m_vbox);
+
+        m_title.set_halign(Gtk::ALIGN_START);
+        m_vbox.pack_start(m_title, Gtk::PACK_SHRINK);
+
+        auto options = Gtk::make_managed<Gtk::Box>(Gtk::ORIENTATION_HORIZONTAL, 6);
+        options->pack_start(*Gtk::make_managed<Gtk::Label>("Tool:"), Gtk::PACK_SHRINK);
+        m_tool.append("cachegrind", "Cachegrind");
+        m_tool.append("callgrind", "Callgrind");
+        m_tool.set_active(0);
+        options->pack_start(m_tool, Gtk::PACK_SHRINK);
+        options->pack_start(*Gtk::make_managed<Gtk::Label>("Profile:"), Gtk::PACK_SHRINK);
+        for (const auto& profile : build_profiles()) {
+            m_profile.append(profile.name, profile.name + " (" + format_command(profile.flags) + ")");
+        }
+        m_profile.set_active(1);
+        m_profile.set_tooltip_text("-g is added, which names the source files and leaves the code as it is");
+        options->pack_start(m_profile, Gtk::PACK_SHRINK);
+        options->pack_start(*Gtk::make_managed<Gtk::Label>("Arguments:"), Gtk::PACK_SHRINK);
+        m_args.set_placeholder_text("none");
+        options->pack_start(m_args, Gtk::PACK_EXPAND_WIDGET);
+        m_vbox.pack_start(*options, Gtk::PACK_SHRINK);
+
+        auto revisions = Gtk::make_managed<Gtk::Box>(Gtk::ORIENTATION_HORIZONTAL, 6);
+        revisions->pack_start(*Gtk::make_managed<Gtk::Label>("Revision:"), Gtk::PACK_SHRINK);
+        m_revision[0].set_placeholder_text("Commit (empty = as cloned)");
+        revisions->pack_start(m_revision[0], Gtk::PACK_EXPAND_WIDGET);
+        m_compare.set_label("Compare with:");
+        m_compare.signal_toggled().connect([this]() { set_busy(m_job.busy()); });
+        revisions->pack_start(m_compare, Gtk::PACK_SHRINK);
+        m_revision[1].set_placeholder_text("e.g. HEAD~1");
+        revisions->pack_start(m_revision[1], Gtk::PACK_EXPAND_WIDGET);
+        m_start_btn.signal_clicked().connect(sigc::mem_fun(*this, &CacheSimWindow::start));
+        m_cancel_btn.signal_clicked().connect([this]() { m_job.cancel(); });
+        revisions->pack_end(m_cancel_btn, Gtk::PACK_SHRINK);
+        revisions->pack_end(m_start_btn, Gtk::PACK_SHRINK);
+        m_vbox.pack_start(*revisions, Gtk::PACK_SHRINK);
+
+        m_progress.set_show_text(true);
+        m_vbox.pack_start(m_progress, Gtk::PACK_SHRINK);
+
+        m_store = Gtk::ListStore::create(m_columns);
+        m_store->set_sort_column(m_columns.ir, Gtk::SORT_DESCENDING);
+        m_treeview.set_model(m_store);
+        m_treeview.append_column("Function", m_columns.function);
+        m_treeview.append_column_numeric("Instructions", m_columns.ir, "%.0f");
+        m_treeview.append_column_numeric("Share (%)", m_columns.share, "%.2f");
+        m_treeview.append_column_numeric("L1 miss (%)", m_columns.l1_miss, "%.2f");
+        m_treeview.append_column_numeric("LL miss (%)", m_columns.ll_miss, "%.3f");
+        m_treeview.append_column_numeric("D1 misses", m_columns.d1_misses, "%.0f");
+        m_treeview.append_column_numeric("LL misses", m_columns.ll_misses, "%.0f");
+        m_treeview.append_column_numeric("Instructions (B)", m_columns.ir_b, "%.0f");
+        m_treeview.append_column_numeric("Change (%)", m_columns.change, "%+.2f");
+        m_treeview.append_column("File", m_columns.file);
+        const Gtk::TreeModelColumn<double>* sortable[] = {&m_columns.ir, &m_columns.share, &m_columns.l1_miss,
+                                                          &m_columns.ll_miss, &m_columns.d1_misses, &m_columns.ll_misses,
+                                                          &m_columns.ir_b, &m_columns.change};
+        m_treeview.get_column(0)->set_sort_column(m_columns.function);
+        for (int i = 0; i < 8; ++i) m_treeview.get_column(i + 1)->set_sort_column(*sortable[i]);
+        m_treeview.get_column(9)->set_sort_column(m_columns.file);
+        m_scrolledwindow.set_policy(Gtk::POLICY_AUTOMATIC, Gtk::POLICY_AUTOMATIC);
+        m_scrolledwindow.add(m_treeview);
+        m_vbox.pack_start(m_scrolledwindow, Gtk::PACK_EXPAND_WIDGET);
+
+        m_summary.set_halign(Gtk::ALIGN_START);
+        m_summary.set_selectable(true);
+        m_summary.set_line_wrap(true);
+        m_vbox.pack_start(m_summary, Gtk::PACK_SHRINK);
+
+        m_job.on_progress = [this](const std::string& text, double) {
+            m_progress.set_text(text);
+            m_progress.pulse();
+        };
+        set_busy(false);
+        show_all_children();
+        show_comparison_columns(false);
     }
-    char buffer[128];
-    while (fgets(buffer, sizeof(buffer), pipe) != nullptr) {
-        result += buffer;
+
+    /** @brief Selects the project to run; ignored while a run is in progress. */
+    void set_project(const Project& project) {
+        if (m_job.busy()) return;
+        m_project = project;
+        m_title.set_markup("<b>" + Glib::Markup::escape_text(project.name) + "</b>");
     }
-    pclose(pipe);
-    return result;
-}
 
+    /** @brief The C++ compiler chosen in the main window; empty for default_compiler(). */
+    void set_compiler(const std::string& compiler) { m_compiler = compiler; }
+
+private:
+    struct Columns : public Gtk::TreeModel::ColumnRecord {
+        Columns() {
+            add(function); add(ir); add(share); add(l1_miss); add(ll_miss); add(d1_misses); add(ll_misses);
+            add(ir_b); add(change); add(file);
+        }
+        Gtk::TreeModelColumn<Glib::ustring> function;
+        Gtk::TreeModelColumn<double> ir;
+        Gtk::TreeModelColumn<double> share;      // Of all instructions
+        Gtk::TreeModelColumn<double> l1_miss;
+        Gtk::TreeModelColumn<double> ll_miss;
+        Gtk::TreeModelColumn<double> d1_misses;  // Data reads and writes
+        Gtk::TreeModelColumn<double> ll_misses;  // Instructions and data
+        Gtk::TreeModelColumn<double> ir_b;
+        Gtk::TreeModelColumn<double> change;     // Of the instructions, B against A
+        Gtk::TreeModelColumn<Glib::ustring> file;
+    };
+
+    Gtk::Box m_vbox;
+    Gtk::Label m_title;
+    Gtk::ComboBoxText m_tool;
+    Gtk::ComboBoxText m_profile;
+    Gtk::Entry m_args;
+    Gtk::Entry m_revision[2];
+    Gtk::CheckButton m_compare;
+    Gtk::Button m_start_btn{"Run"};
+    Gtk::Button m_cancel_btn{"Cancel"};
+    Gtk::ProgressBar m_progress;
+    Columns m_columns;
+    Glib::RefPtr<Gtk::ListStore> m_store;
+    Gtk::TreeView m_treeview;
+    Gtk::ScrolledWindow m_scrolledwindow;
+    Gtk::Label m_summary;
+    Project m_project;
+    std::string m_compiler;  // Empty for default_compiler()
+    std::vector<CacheSimReport> m_reports;  // One per revision run
+    std::vector<std::string> m_commits;     // Their commits
+    BackgroundJob m_job;                    // Builds and simulates the revisions
+
+    void set_busy(bool busy) {
+        m_start_btn.set_sensitive(!busy);
+        m_cancel_btn.set_sensitive(busy);
+        m_tool.set_sensitive(!busy);
+        m_profile.set_sensitive(!busy);
+        m_args.set_sensitive(!busy);
+        m_revision[0].set_sensitive(!busy);
+        m_compare.set_sensitive(!busy);
+        m_revision[1].set_sensitive(!busy && m_compare.get_active());
+    }
+
+    void show_comparison_columns(bool visible) {
+        m_treeview.get_column(7)->set_visible(visible);
+        m_treeview.get_column(8)->set_visible(visible);
+    }
+
+    void start() {
+        if (m_job.busy() || m_project.path.empty()) return;
+        std::vector<std::string> args;
+        try {
+            args = split_arguments(m_args.get_text());
+        } catch (const std::exception& e) {
+            m_summary.set_text(e.what());
+            return;
+        }
+        std::vector<std::string> revisions = {m_revision[0].get_text()};
+        if (m_compare.get_active()) revisions.push_back(m_revision[1].get_text());
+        BuildProfile profile = build_profiles()[std::max(0, m_profile.get_active_row_number())];
+        if (std::find(profile.flags.begin(), profile.flags.end(), "-g") == profile.flags.end()) profile.flags.push_back("-g");
+        m_store->clear();
+        m_summary.set_text("");
+        m_reports.clear();
+        m_commits.clear();
+        set_busy(true);
+        m_job.start([this, project = m_project, compiler = m_compiler, tool = std::string(m_tool.get_active_id()), profile,
+                     revisions, args]() { run_worker(project, compiler, tool, profile, revisions, args); },
+                    sigc::mem_fun(*this, &CacheSimWindow::on_finished));
+    }
+
+    /** @brief Worker thread: builds each revision (through build_commit's cache) and runs it under Valgrind. */
+    void run_worker(Project project, std::string compiler, std::string tool, BuildProfile profile,
+                    std::vector<std::string> revisions, std::vector<std::string> args) {
+        std::vector<CacheSimReport> reports;
+        std::vector<std::string> commits;
+        std::string error;
+        try {
+            std::filesystem::path source = project.path;
+            std::filesystem::path repo = git_output(source.parent_path(), {"rev-parse", "--show-toplevel"});
+            std::filesystem::path relative = std::filesystem::relative(source, repo);
+            if (compiler.empty()) compiler = default_compiler();
+            for (size_t i = 0; i < revisions.size() && !m_job.cancelled(); ++i) {
+                std::string label = revisions.size() > 1 ? std::string(1, static_cast<char>('A' + i)) + ": " : "";
+                m_job.progress(label + "checking out " + (revisions[i].empty() ? "HEAD" : revisions[i]), 0.0);
+                std::string sha = git_resolve_commit(repo, revisions[i].empty() ? "HEAD" : revisions[i]);
+                m_job.progress(label + "building " + sha.substr(0, 12), 0.0);
+                bool reused = false;
+                BenchmarkBuild build = build_commit(compiler, repo, relative, sha, profile, reused);
+                std::vector<std::string> command = {build.executable.string()};
+                command.insert(command.end(), args.begin(), args.end());
+                m_job.progress(label + "running under " + tool + " (much slower than a normal run)", 0.0);
+                std::filesystem::path out_file = cache_directory() / "cachesim"
+                                               / (relative.stem().string() + "-" + sha.substr(0, 12) + "." + tool + ".out");
+                std::filesystem::create_directories(out_file.parent_path());
+                reports.push_back(run_cache_simulation(tool, command, out_file, &m_job.canceller()));
+                commits.push_back(sha);
+            }
+            if (m_job.cancelled()) error = "Cancelled";
+        } catch (const std::exception& e) {
+            error = m_job.cancelled() ? "Cancelled" : e.what();
+        }
+        // The revisions simulated are shown even when a later one failed
+        m_job.post([this, reports = std::move(reports), commits = std::move(commits)]() mutable {
+            m_reports = std::move(reports);
+            m_commits = std::move(commits);
+        });
+        if (!error.empty()) throw std::runtime_error(error);
+    }
+
+    void on_finished(const std::string& error) {
+        set_busy(false);
+        m_progress.set_fraction(1.0);
+        m_progress.set_text(error.empty() ? "Done" : "Stopped");
+
+        const std::vector<CacheSimReport>& reports = m_reports;
+        const std::vector<std::string>& commits = m_commits;
+        std::string details = error.empty() ? "" : error + "\n";
+        for (size_t i = 0; i < reports.size(); ++i) {
+            std::string label = reports.size() > 1 ? std::string(1, static_cast<char>('A' + i)) + " " : "";
+            details += label + commits[i].substr(0, 12) + ": " + reports[i].summary();
+            if (reports[i].exit_code != 0) details += " (the program exited with code " + std::to_string(reports[i].exit_code) + ")";
+            details += "\n";
+        }
+        bool compared = reports.size() == 2;
+        show_comparison_columns(compared);
+        if (!reports.empty()) show_functions(reports.front(), compared ? &reports[1] : nullptr);
+        if (compared) {
+            double a = static_cast<double>(reports[0].count(reports[0].totals, "Ir"));
+            double b = static_cast<double>(reports[1].count(reports[1].totals, "Ir"));
+            char change[96];
+            std::snprintf(change, sizeof(change), "B executes %+.3f%% instructions against A", a > 0 ? (b / a - 1) * 100 : 0.0);
+            details += change;
+        }
+        m_summary.set_text(details);
+    }
+
+    /**
+     * @brief One row per function with instructions in A or B, matched by name.
+     * Both sides are summed per name (see CacheSimReport::functions_by_name()),
+     * so a function that moved to another file between the commits still matches.
+     */
+    void show_functions(const CacheSimReport& a, const CacheSimReport* b) {
+        double total = static_cast<double>(a.count(a.totals, "Ir"));
+        std::map<std::string, Gtk::TreeModel::Row> rows;
+        for (const auto& function : a.functions_by_name()) {
+            double ir = static_cast<double>(a.count(function.counts, "Ir"));
+            if (ir == 0) continue;
+            Gtk::TreeModel::Row row = *m_store->append();
+            row[m_columns.function] = function.name;
+            row[m_columns.file] = function.file;
+            row[m_columns.ir] = ir;
+            row[m_columns.share] = total > 0 ? ir / total * 100 : 0.0;
+            row[m_columns.l1_miss] = a.l1_miss_rate(function.counts) * 100;
+            row[m_columns.ll_miss] = a.ll_miss_rate(function.counts) * 100;
+            row[m_columns.d1_misses] = static_cast<double>(a.count(function.counts, "D1mr") + a.count(function.counts, "D1mw"));
+            row[m_columns.ll_misses] = static_cast<double>(a.count(function.counts, "ILmr") + a.count(function.counts, "DLmr")
+                                                           + a.count(function.counts, "DLmw"));
+            rows.emplace(function.name, row);
+        }
+        if (!b) return;
+        for (const auto& function : b->functions_by_name()) {
+            double ir_b = static_cast<double>(b->count(function.counts, "Ir"));
+            auto found = rows.find(function.name);
+            if (found == rows.end()) {
+                if (ir_b == 0) continue;
+                Gtk::TreeModel::Row row = *m_store->append();
+                row[m_columns.function] = function.name;
+                row[m_columns.file] = function.file;
+                found = rows.emplace(function.name, row).first;
+            }
+            Gtk::TreeModel::Row& row = found->second;
+            double ir = row[m_columns.ir];
+            row[m_columns.ir_b] = ir_b;
+            row[m_columns.change] = ir > 0 ? (ir_b / ir - 1) * 100 : 100.0;  // New in B: all of it is added
+        }
+    }
+};
+
+// --- Diagnostics View ---
 /**
- * @brief Function to clone a Git repository.
- * @param repo_url The URL of the repository.
- * @param local_dir The local directory to clone into.
- * @return True if the clone was successful, false otherwise.
+ * @brief Collapsible list of compiler diagnostics.
+ * Only one row per top-level diagnostic is created up front; the full message,
+ * notes and instantiation context are materialised when a row is expanded, so
+ * the pane stays responsive regardless of how much the compiler printed.
  */
-bool clone_repository(const std::string& repo_url, const std::string& local_dir) {
-    std::string command = "git clone --depth 1 " + repo_url + " \"" + local_dir + "\"";
-    std::cout << "Cloning " << repo_url << " into " << local_dir << std::endl;
-    int result = std::system(command.c_str());
-    return result == 0;
-}
+class DiagnosticsView : public Gtk::ScrolledWindow {
+public:
+    DiagnosticsView() {
+        m_store = Gtk::TreeStore::create(m_columns);
+        m_treeview.set_model(m_store);
+        m_treeview.append_column("Location", m_columns.location);
+        m_treeview.append_column("Severity", m_columns.severity);
+        m_treeview.append_column("Message", m_columns.message);
+        m_treeview.get_column(0)->set_resizable(true);
+        m_treeview.get_column(2)->set_expand(true);
+        m_treeview.set_enable_search(false);
+        m_treeview.signal_test_expand_row().connect(sigc::mem_fun(*this, &DiagnosticsView::on_test_expand_row), false);
+        set_policy(Gtk::POLICY_AUTOMATIC, Gtk::POLICY_AUTOMATIC);
+        add(m_treeview);
+    }
 
-// Structure to hold project details
-struct Project {
-    std::string name;    // Display name in the launcher
-    std::string type;    // "C++", "HTML"
-    std::string path;    // Path to the project's main executable/HTML file after extraction
-};
+    /**
+     * @brief Replaces the displayed diagnostics.
+     * @param list The parsed compiler diagnostics.
+     */
+    void set_diagnostics(DiagnosticList list) {
+        m_store->clear();
+        m_list = std::move(list);
+        for (size_t idx : m_list.top_level) {
+            add_row(m_store->append(), idx);
+        }
+    }
 
-// Global variable to store the extraction target directory
-std::filesystem::path g_extraction_target_dir;
+    void clear() {
+        m_store->clear();
+        m_list = DiagnosticList();
+    }
 
-// --- Cloning Status Window ---
-class CloningStatusWindow : public Gtk::Window {
-public:
-    struct RepoStatus {
-        std::string name;
-        Gtk::Label* label;
+private:
+    // Rows longer than this show a summary until expanded
+    static constexpr size_t kSummaryLength = 200;
+    static constexpr int kPlaceholder = -1;
+    static constexpr int kTextRow = -2;
+
+    struct Columns : public Gtk::TreeModel::ColumnRecord {
+        Columns() { add(location); add(severity); add(message); add(index); add(loaded); }
+        Gtk::TreeModelColumn<Glib::ustring> location;
+        Gtk::TreeModelColumn<Glib::ustring> severity;
+        Gtk::TreeModelColumn<Glib::ustring> message;
+        Gtk::TreeModelColumn<int> index;   // Index into m_list.items, or kPlaceholder/kTextRow
+        Gtk::TreeModelColumn<bool> loaded; // Children have been materialised
     };
-    CloningStatusWindow(const std::vector<std::string>& repo_names)
-    : vbox(Gtk::ORIENTATION_VERTICAL) {
-        set_title("Cloning Projects...");
-        set_default_size(400, 300);
-        set_position(Gtk::WIN_POS_CENTER);
-        vbox.set_spacing(10);
-        vbox.set_margin_top(20);
-        vbox.set_margin_bottom(20);
-        vbox.set_margin_start(20);
-        vbox.set_margin_end(20);
-        add(vbox);
-        auto title = Gtk::make_managed<Gtk::Label>("<b>Cloning Repositories</b>");
-        title->set_use_markup(true);
-        title->set_halign(Gtk::ALIGN_CENTER);
-        vbox.pack_start(*title, Gtk::PACK_SHRINK);
-        for (const auto& name : repo_names) {
-            auto label = Gtk::make_managed<Gtk::Label>(name + ": <span foreground='blue'>Cloning...</span>");
-            label->set_use_markup(true);
-            label->set_halign(Gtk::ALIGN_START);
-            vbox.pack_start(*label, Gtk::PACK_SHRINK);
-            repo_status_.push_back({name, label});
+
+    Columns m_columns;
+    Glib::RefPtr<Gtk::TreeStore> m_store;
+    Gtk::TreeView m_treeview;
+    DiagnosticList m_list;
+
+    static std::string summary(const std::string& message) {
+        std::string first_line = message.substr(0, message.find('\n'));
+        if (first_line.size() > kSummaryLength) {
+            first_line = first_line.substr(0, kSummaryLength) + "...";
         }
-        show_all_children();
+        return first_line;
     }
-    void set_status(size_t idx, bool success) {
-        if (idx >= repo_status_.size()) return;
-        std::string color = success ? "green" : "red";
-        std::string msg = success ? "Cloned" : "Failed";
-        repo_status_[idx].label->set_markup(repo_status_[idx].name + ": <span foreground='" + color + "'>" + msg + "</span>");
+
+    void add_row(const Gtk::TreeModel::iterator& iter, size_t index) {
+        const auto& diag = m_list.items[index];
+        Gtk::TreeModel::Row row = *iter;
+        row[m_columns.location] = m_list.location(diag);
+        row[m_columns.severity] = DiagnosticList::severity_name(diag.severity);
+        row[m_columns.message] = summary(diag.message);
+        row[m_columns.index] = static_cast<int>(index);
+        row[m_columns.loaded] = false;
+        if (!diag.children.empty() || summary(diag.message) != diag.message) {
+            // Placeholder so the row gets an expander; replaced on first expansion.
+            Gtk::TreeModel::Row placeholder = *m_store->append(row.children());
+            placeholder[m_columns.index] = kPlaceholder;
+        }
     }
-private:
-    Gtk::Box vbox;
-    std::vector<RepoStatus> repo_status_;
-};
 
-class TempDirCleanup {
-public:
-    TempDirCleanup(const std::filesystem::path& path_to_clean)
-        : path_to_clean_(path_to_clean) {}
-    ~TempDirCleanup() {
-        if (std::filesystem::exists(path_to_clean_)) {
-            std::cout << "Cleaning up temporary directory: " << path_to_clean_ << std::endl;
-            std::error_code ec;
-            std::filesystem::remove_all(path_to_clean_, ec);
-            if (ec) {
-                std::cerr << "Error cleaning up temporary directory: " << ec.message() << std::endl;
+    bool on_test_expand_row(const Gtk::TreeModel::iterator& iter, const Gtk::TreeModel::Path&) {
+        Gtk::TreeModel::Row row = *iter;
+        int index = row[m_columns.index];
+        if (row[m_columns.loaded] || index < 0) return false;
+        row[m_columns.loaded] = true;
+        auto children = row.children();
+        for (auto child = children.begin(); child != children.end();) {
+            child = m_store->erase(child);
+        }
+        const auto& diag = m_list.items[index];
+        if (summary(diag.message) != diag.message) {
+            size_t start = 0;
+            while (start <= diag.message.size()) {
+                size_t end = diag.message.find('\n', start);
+                if (end == std::string::npos) end = diag.message.size();
+                Gtk::TreeModel::Row text_row = *m_store->append(row.children());
+                text_row[m_columns.message] = diag.message.substr(start, end - start);
+                text_row[m_columns.index] = kTextRow;
+                start = end + 1;
             }
         }
+        for (size_t child_index : diag.children) {
+            add_row(m_store->append(row.children()), child_index);
+        }
+        return false; // Allow the expansion to proceed
     }
-private:
-    std::filesystem::path path_to_clean_;
 };
 
-
 /**
  * @brief Main window for the bare-bones Gtkmm application.
  * This window displays a title, project dropdowns, and an exit button.
@@ -172,9 +9029,63 @@ public:
             for (const auto& proj : projs_of_type) {
                 auto menu_item = Gtk::make_managed<Gtk::MenuItem>(proj.name);
                 // Connect signal to launch the project, capturing 'this' to call member function
-                menu_item->signal_activate().connect(sigc::bind(sigc::mem_fun(*this, &MainWindow::launch_project), proj));
+                menu_item->signal_activate().connect([this, proj]() { launch_project(proj); });
                 menu->append(*menu_item); // Add the menu item to the menu
             }
+            if (type == "C++") {
+                menu->append(*Gtk::make_managed<Gtk::SeparatorMenuItem>());
+                auto watch_item = Gtk::make_managed<Gtk::MenuItem>("Watch for New Commits...");
+                watch_item->signal_activate().connect([this]() { m_watch_window.present(); });
+                menu->append(*watch_item);
+                for (const auto& proj : projs_of_type) {
+                    if (proj.name.find("Calculator") != std::string::npos) continue; // Not built from source
+                    auto bench_item = Gtk::make_managed<Gtk::MenuItem>("Benchmark " + proj.name + "...");
+                    bench_item->signal_activate().connect([this, proj]() {
+                        m_benchmark_window.set_project(proj);
+                        m_benchmark_window.present();
+                    });
+                    menu->append(*bench_item);
+                    auto profile_item = Gtk::make_managed<Gtk::MenuItem>("Profile " + proj.name);
+                    profile_item->signal_activate().connect([this, proj]() { launch_project(proj, true); });
+                    menu->append(*profile_item);
+                    auto allocator_item = Gtk::make_managed<Gtk::MenuItem>("Allocator Matrix " + proj.name + "...");
+                    allocator_item->signal_activate().connect([this, proj]() {
+                        m_allocator_window.set_project(proj);
+                        m_allocator_window.present();
+                    });
+                    menu->append(*allocator_item);
+                    auto compiler_item = Gtk::make_managed<Gtk::MenuItem>("Compiler Matrix " + proj.name + "...");
+                    compiler_item->signal_activate().connect([this, proj]() {
+                        m_compiler_matrix_window.set_project(proj);
+                        m_compiler_matrix_window.present();
+                    });
+                    menu->append(*compiler_item);
+                    auto scaling_item = Gtk::make_managed<Gtk::MenuItem>("Scaling Sweep " + proj.name + "...");
+                    scaling_item->signal_activate().connect([this, proj]() {
+                        m_scaling_window.set_project(proj);
+                        m_scaling_window.present();
+                    });
+                    menu->append(*scaling_item);
+                    auto input_item = Gtk::make_managed<Gtk::MenuItem>("Input-Size Sweep " + proj.name + "...");
+                    input_item->signal_activate().connect([this, proj]() {
+                        m_input_sweep_window.set_project(proj);
+                        m_input_sweep_window.present();
+                    });
+                    menu->append(*input_item);
+                    auto bisect_item = Gtk::make_managed<Gtk::MenuItem>("Bisect " + proj.name + "...");
+                    bisect_item->signal_activate().connect([this, proj]() {
+                        m_bisect_window.set_project(proj);
+                        m_bisect_window.present();
+                    });
+                    menu->append(*bisect_item);
+                    auto cache_sim_item = Gtk::make_managed<Gtk::MenuItem>("Cache Simulation " + proj.name + "...");
+                    cache_sim_item->signal_activate().connect([this, proj]() {
+                        m_cache_sim_window.set_project(proj);
+                        m_cache_sim_window.present();
+                    });
+                    menu->append(*cache_sim_item);
+                }
+            }
             menu->show_all(); // Show all items in the menu (important for them to be visible)
 
             menu_button->set_popup(*menu); // Set the menu as the popup for the button
@@ -190,6 +9101,124 @@ public:
         });
         vbox.pack_start(*output_btn, Gtk::PACK_SHRINK);
 
+        auto history_btn = Gtk::make_managed<Gtk::Button>("Show Run History");
+        history_btn->set_halign(Gtk::ALIGN_CENTER);
+        history_btn->set_size_request(180, 40);
+        history_btn->signal_clicked().connect([this]() {
+            m_history_window.show();
+        });
+        for (const JsonValue& record : m_history_store.load()) {
+            if (record["type"].as_string() != "run") continue;
+            m_run_history.push_back(RunHistoryEntry::from_json(record));
+            m_history_window.add_entry(m_run_history.back());
+        }
+        vbox.pack_start(*history_btn, Gtk::PACK_SHRINK);
+        m_watch_window.set_projects(projects_);
+        m_watch_window.on_regression = [this](const Project& project, const std::string& good, const std::string& bad,
+                                              const std::string& text) {
+            append_to_error(text + "; use Bisect in the C++ Projects menu to find the commit\n");
+            m_bisect_window.suggest(project, good, bad);
+        };
+
+        // C++ projects build with the chosen compiler
+        auto compiler_box = Gtk::make_managed<Gtk::Box>(Gtk::ORIENTATION_HORIZONTAL, 6);
+        compiler_box->set_halign(Gtk::ALIGN_CENTER);
+        compiler_box->pack_start(*Gtk::make_managed<Gtk::Label>("C++ compiler:"), Gtk::PACK_SHRINK);
+        // Probing asks every compiler for its version, so it runs off the main loop
+        m_compiler.append("", "looking for compilers...");
+        m_compiler.set_active(0);
+        m_compiler.set_sensitive(false);
+        m_compiler.signal_changed().connect(sigc::mem_fun(*this, &MainWindow::on_compiler_changed));
+        m_background.run([this]() -> std::function<void()> {
+            std::vector<Toolchain> toolchains = installed_toolchains();
+            std::string preferred = default_compiler();
+            return [this, toolchains, preferred]() { show_toolchains(toolchains, preferred); };
+        });
+        compiler_box->pack_start(m_compiler, Gtk::PACK_SHRINK);
+        vbox.pack_start(*compiler_box, Gtk::PACK_SHRINK);
+
+        // Passed to C++ projects when they run, e.g. an input file or a problem size
+        auto args_box = Gtk::make_managed<Gtk::Box>(Gtk::ORIENTATION_HORIZONTAL, 6);
+        args_box->set_halign(Gtk::ALIGN_CENTER);
+        args_box->pack_start(*Gtk::make_managed<Gtk::Label>("Run arguments:"), Gtk::PACK_SHRINK);
+        m_run_args.set_placeholder_text("none");
+        m_run_args.set_width_chars(30);
+        args_box->pack_start(m_run_args, Gtk::PACK_SHRINK);
+        vbox.pack_start(*args_box, Gtk::PACK_SHRINK);
+
+        // Profiled C++ builds report where compile time goes
+        m_profile_build.set_label("Profile C++ builds (-ftime-trace / -ftime-report)");
+        m_profile_build.set_halign(Gtk::ALIGN_CENTER);
+        vbox.pack_start(m_profile_build, Gtk::PACK_SHRINK);
+
+        // Interactive programs see a terminal: line-buffered output, and isatty(0) holds
+        m_use_pty.set_label("Run C++ projects in a pseudo-terminal");
+        m_use_pty.set_halign(Gtk::ALIGN_CENTER);
+        vbox.pack_start(m_use_pty, Gtk::PACK_SHRINK);
+
+        // Otherwise runs read /dev/null, as a program reading stdin would wait forever on an idle pipe
+        m_interactive_input.set_label("Accept input for C++ runs (stdin pipe)");
+        m_interactive_input.set_halign(Gtk::ALIGN_CENTER);
+        vbox.pack_start(m_interactive_input, Gtk::PACK_SHRINK);
+
+        m_count_events.set_label("Count hardware events (IPC, branch and cache misses)");
+        m_count_events.set_halign(Gtk::ALIGN_CENTER);
+        vbox.pack_start(m_count_events, Gtk::PACK_SHRINK);
+
+        m_profile_heap.set_label("Profile heap allocations (preloaded malloc interposer)");
+        m_profile_heap.set_halign(Gtk::ALIGN_CENTER);
+        vbox.pack_start(m_profile_heap, Gtk::PACK_SHRINK);
+
+        // Per-run limits enforced by the process supervisor
+        auto limits_box = Gtk::make_managed<Gtk::Box>(Gtk::ORIENTATION_HORIZONTAL, 6);
+        limits_box->set_halign(Gtk::ALIGN_CENTER);
+        limits_box->pack_start(*Gtk::make_managed<Gtk::Label>("Wall-clock limit (s):"), Gtk::PACK_SHRINK);
+        m_wall_limit.set_range(0, 86400);
+        m_wall_limit.set_increments(1, 60);
+        m_wall_limit.set_tooltip_text("Stop runs after this many seconds (0 = no limit)");
+        limits_box->pack_start(m_wall_limit, Gtk::PACK_SHRINK);
+        limits_box->pack_start(*Gtk::make_managed<Gtk::Label>("CPU limit (s):"), Gtk::PACK_SHRINK);
+        m_cpu_limit.set_range(0, 86400);
+        m_cpu_limit.set_increments(1, 60);
+        m_cpu_limit.set_tooltip_text("Kill runs after this much CPU time (0 = no limit)");
+        limits_box->pack_start(m_cpu_limit, Gtk::PACK_SHRINK);
+        vbox.pack_start(*limits_box, Gtk::PACK_SHRINK);
+
+        // Resource envelope, e.g. to mimic a smaller production instance
+        auto envelope_box = Gtk::make_managed<Gtk::Box>(Gtk::ORIENTATION_HORIZONTAL, 6);
+        envelope_box->set_halign(Gtk::ALIGN_CENTER);
+        envelope_box->pack_start(*Gtk::make_managed<Gtk::Label>("Address space (MiB):"), Gtk::PACK_SHRINK);
+        m_address_space_limit.set_range(0, 1 << 20);
+        m_address_space_limit.set_increments(64, 1024);
+        m_address_space_limit.set_tooltip_text("RLIMIT_AS: allocations beyond this fail (0 = no limit)");
+        envelope_box->pack_start(m_address_space_limit, Gtk::PACK_SHRINK);
+        envelope_box->pack_start(*Gtk::make_managed<Gtk::Label>("CPUs:"), Gtk::PACK_SHRINK);
+        m_cgroup_cpus.set_digits(2);
+        m_cgroup_cpus.set_range(0, 1024);
+        m_cgroup_cpus.set_increments(0.25, 1);
+        m_cgroup_cpus.set_tooltip_text("cgroup v2 cpu.max bandwidth in CPUs (0 = no cap); needs a delegated cgroup");
+        envelope_box->pack_start(m_cgroup_cpus, Gtk::PACK_SHRINK);
+        envelope_box->pack_start(*Gtk::make_managed<Gtk::Label>("Memory (MiB):"), Gtk::PACK_SHRINK);
+        m_cgroup_memory.set_range(0, 1 << 20);
+        m_cgroup_memory.set_increments(64, 1024);
+        m_cgroup_memory.set_tooltip_text("cgroup v2 memory.max; the run is OOM-killed above it (0 = no cap)");
+        envelope_box->pack_start(m_cgroup_memory, Gtk::PACK_SHRINK);
+        vbox.pack_start(*envelope_box, Gtk::PACK_SHRINK);
+
+        m_output_window.on_stop_requested = [this](int run_id, bool force) {
+            auto it = m_active_runs.find(run_id);
+            if (it == m_active_runs.end()) return;
+            if (force) it->second->kill(); else it->second->stop();
+        };
+        m_output_window.on_input = [this](int run_id, const std::string& text, std::chrono::steady_clock::time_point typed) {
+            auto it = m_active_runs.find(run_id);
+            return it != m_active_runs.end() && it->second->send_input(text, typed);
+        };
+        m_output_window.on_eof_requested = [this](int run_id) {
+            auto it = m_active_runs.find(run_id);
+            if (it != m_active_runs.end()) it->second->close_input();
+        };
+
         // Error Label
         auto error_label = Gtk::make_managed<Gtk::Label>("<b>Error Log:</b>");
         error_label->set_use_markup(true);
@@ -206,6 +9235,14 @@ public:
         m_error_scrolledwindow.add(m_error_textview);
         m_error_scrolledwindow.set_size_request(-1, 150); // Set a fixed height
         vbox.pack_start(m_error_scrolledwindow, Gtk::PACK_EXPAND_WIDGET); // Expand to fill available space
+
+        // Compiler diagnostics, one collapsible row per diagnostic
+        auto diagnostics_label = Gtk::make_managed<Gtk::Label>("<b>Compiler Diagnostics:</b>");
+        diagnostics_label->set_use_markup(true);
+        diagnostics_label->set_halign(Gtk::ALIGN_START);
+        vbox.pack_start(*diagnostics_label, Gtk::PACK_SHRINK);
+        m_diagnostics_view.set_size_request(-1, 150);
+        vbox.pack_start(m_diagnostics_view, Gtk::PACK_EXPAND_WIDGET);
         // --- End Text Boxes ---
 
         // Create and add an Exit button
@@ -224,33 +9261,265 @@ private:
     Gtk::Box vbox; // The main vertical box for layout
     std::vector<Project> projects_; // Vector to store project data
 
-    // Output window for project output
+    // Output window for project output: one tab per run, plus a run status list
     class OutputWindow : public Gtk::Window {
     public:
         OutputWindow()
-        : m_output_textview(), m_output_buffer(Gtk::TextBuffer::create()) {
+        : m_vbox(Gtk::ORIENTATION_VERTICAL), m_paned(Gtk::ORIENTATION_HORIZONTAL) {
             set_title("Project Output");
-            set_default_size(600, 300);
-            m_output_textview.set_buffer(m_output_buffer);
-            m_output_textview.set_editable(false);
-            m_output_textview.set_wrap_mode(Gtk::WRAP_WORD);
-            m_output_scrolledwindow.set_policy(Gtk::POLICY_AUTOMATIC, Gtk::POLICY_AUTOMATIC);
-            m_output_scrolledwindow.add(m_output_textview);
-            add(m_output_scrolledwindow);
+            set_default_size(900, 400);
+            m_vbox.set_spacing(4);
+            add(m_vbox);
+
+            m_runs_store = Gtk::ListStore::create(m_columns);
+            m_runs_view.set_model(m_runs_store);
+            m_runs_view.append_column("Run", m_columns.title);
+            m_runs_view.append_column("PID", m_columns.pid);
+            m_runs_view.append_column("Elapsed", m_columns.elapsed);
+            m_runs_view.append_column("Exit", m_columns.exit_code);
+            m_runs_view.get_selection()->signal_changed().connect([this]() {
+                auto iter = m_runs_view.get_selection()->get_selected();
+                if (!iter) return;
+                auto it = m_tabs.find((*iter)[m_columns.id]);
+                if (it != m_tabs.end()) m_notebook.set_current_page(m_notebook.page_num(it->second->box));
+            });
+            m_runs_scrolledwindow.set_policy(Gtk::POLICY_NEVER, Gtk::POLICY_AUTOMATIC);
+            m_runs_scrolledwindow.add(m_runs_view);
+            m_runs_scrolledwindow.set_size_request(280, -1);
+
+            m_notebook.set_scrollable(true);
+            m_paned.pack1(m_runs_scrolledwindow, false, false);
+            m_paned.pack2(m_notebook, true, false);
+            m_vbox.pack_start(m_paned, Gtk::PACK_EXPAND_WIDGET);
+
+            auto button_box = Gtk::make_managed<Gtk::Box>(Gtk::ORIENTATION_HORIZONTAL, 6);
+            auto stop_btn = Gtk::make_managed<Gtk::Button>("Stop");
+            stop_btn->set_tooltip_text("SIGTERM the selected run's process group, SIGKILL after 3 s");
+            stop_btn->signal_clicked().connect([this]() { request_stop(false); });
+            auto kill_btn = Gtk::make_managed<Gtk::Button>("Kill");
+            kill_btn->set_tooltip_text("SIGKILL the selected run's process group");
+            kill_btn->signal_clicked().connect([this]() { request_stop(true); });
+            auto clear_btn = Gtk::make_managed<Gtk::Button>("Close Finished Runs");
+            clear_btn->signal_clicked().connect(sigc::mem_fun(*this, &OutputWindow::remove_finished));
+            button_box->pack_start(*stop_btn, Gtk::PACK_SHRINK);
+            button_box->pack_start(*kill_btn, Gtk::PACK_SHRINK);
+            button_box->pack_end(*clear_btn, Gtk::PACK_SHRINK);
+            m_vbox.pack_start(*button_box, Gtk::PACK_SHRINK);
+
+            m_elapsed_timer = Glib::signal_timeout().connect(sigc::mem_fun(*this, &OutputWindow::update_elapsed), 250);
             show_all_children();
         }
-        void append_to_output(const std::string& text) {
-            m_output_buffer->insert_at_cursor(text);
-            auto end_iter = m_output_buffer->end();
-            m_output_textview.scroll_to(end_iter, 0.0);
+        ~OutputWindow() { m_elapsed_timer.disconnect(); }
+
+        /**
+         * @brief Adds a tab and a status row for a new launch.
+         * @param title Tab title, usually the project name.
+         * @return The run id used by the other methods.
+         */
+        int add_run(const std::string& title) {
+            int id = ++m_next_id;
+            auto tab = std::make_unique<RunTab>();
+            tab->title = title + " #" + std::to_string(id);
+            tab->iter = m_runs_store->append();
+            (*tab->iter)[m_columns.id] = id;
+            (*tab->iter)[m_columns.title] = tab->title;
+            tab->input_entry.signal_activate().connect([this, id]() { submit_input(id); });
+            tab->send_button.signal_clicked().connect([this, id]() { submit_input(id); });
+            tab->eof_button.signal_clicked().connect([this, id]() {
+                if (on_eof_requested) on_eof_requested(id);
+            });
+            m_notebook.append_page(tab->box, tab->title);
+            tab->box.show_all();
+            m_notebook.set_current_page(m_notebook.page_num(tab->box));
+            m_tabs[id] = std::move(tab);
+            return id;
+        }
+
+        void append_to_output(int run_id, const std::string& text, bool is_stderr = false) {
+            auto it = m_tabs.find(run_id);
+            if (it != m_tabs.end()) it->second->append(text, is_stderr);
+        }
+
+        /**
+         * @brief Marks a run's process as started.
+         * @param accepts_input Whether it reads from the launcher, else its input field is disabled.
+         */
+        void set_running(int run_id, pid_t pid, bool accepts_input) {
+            auto it = m_tabs.find(run_id);
+            if (it == m_tabs.end()) return;
+            it->second->running = true;
+            it->second->input_box.set_sensitive(accepts_input);
+            it->second->started = std::chrono::steady_clock::now();
+            (*it->second->iter)[m_columns.pid] = std::to_string(pid);
+        }
+
+        /**
+         * @brief Marks a run's process as exited.
+         * @param reason Why the supervisor ended it, if it did.
+         */
+        void set_finished(int run_id, int exit_code, const std::string& reason = "") {
+            auto it = m_tabs.find(run_id);
+            if (it == m_tabs.end()) return;
+            RunTab& tab = *it->second;
+            (*tab.iter)[m_columns.elapsed] = format_elapsed(std::chrono::steady_clock::now() - tab.started);
+            (*tab.iter)[m_columns.exit_code] = std::to_string(exit_code) + (reason.empty() ? "" : " (" + reason + ")");
+            tab.running = false;
+            tab.input_box.set_sensitive(false);
+        }
+
+        /** @brief Shows a run's resource usage under its output. */
+        void set_usage_summary(int run_id, const std::string& summary) {
+            auto it = m_tabs.find(run_id);
+            if (it != m_tabs.end()) it->second->usage_label.set_text(summary);
+        }
+
+        /** @brief Shows a run's input-to-response latency next to its input field. */
+        void set_input_latency(int run_id, const std::string& text) {
+            auto it = m_tabs.find(run_id);
+            if (it != m_tabs.end()) it->second->latency_label.set_text(text);
         }
-        void clear_output() {
-            m_output_buffer->set_text("");
+
+        /** @brief Closes the tabs of all launches that have no process running. */
+        void remove_finished() {
+            for (auto it = m_tabs.begin(); it != m_tabs.end();) {
+                if (it->second->running) { ++it; continue; }
+                m_notebook.remove_page(it->second->box);
+                m_runs_store->erase(it->second->iter);
+                it = m_tabs.erase(it);
+            }
         }
+
+        // Called with the run id and whether to kill (true) or stop (false)
+        std::function<void(int, bool)> on_stop_requested;
+        // Called with the run id, a line of input (newline included) and when it was entered;
+        // returns false if the run did not accept it
+        std::function<bool(int, const std::string&, std::chrono::steady_clock::time_point)> on_input;
+        std::function<void(int)> on_eof_requested;
+
     private:
-        Gtk::ScrolledWindow m_output_scrolledwindow;
-        Gtk::TextView m_output_textview;
-        Glib::RefPtr<Gtk::TextBuffer> m_output_buffer;
+        // Upper bound on the characters kept in each run's output view
+        static constexpr int kMaxOutputChars = 1 << 20;
+
+        /** @brief Output view and status of one run. */
+        struct RunTab {
+            Gtk::Box box{Gtk::ORIENTATION_VERTICAL};
+            Gtk::ScrolledWindow scrolledwindow;
+            Gtk::TextView textview;
+            Gtk::Label usage_label;  // Resource summary once the run has exited
+            Gtk::Box input_box{Gtk::ORIENTATION_HORIZONTAL, 6};
+            Gtk::Entry input_entry;
+            Gtk::Button send_button{"Send"};
+            Gtk::Button eof_button{"EOF"};
+            Gtk::Label latency_label;
+            Glib::RefPtr<Gtk::TextBuffer> buffer = Gtk::TextBuffer::create();
+            Glib::RefPtr<Gtk::TextMark> end_mark;
+            Glib::RefPtr<Gtk::TextTag> stderr_tag;
+            Glib::RefPtr<Gtk::TextTag> input_tag;
+            Gtk::TreeModel::iterator iter; // Status row in the runs list
+            std::string title;
+            std::chrono::steady_clock::time_point started;
+            bool running = false;
+
+            RunTab() {
+                textview.set_buffer(buffer);
+                textview.set_editable(false);
+                textview.set_wrap_mode(Gtk::WRAP_WORD);
+                textview.set_monospace(true);
+                scrolledwindow.set_policy(Gtk::POLICY_AUTOMATIC, Gtk::POLICY_AUTOMATIC);
+                scrolledwindow.add(textview);
+                box.pack_start(scrolledwindow, Gtk::PACK_EXPAND_WIDGET);
+                input_entry.set_placeholder_text("Input to the run; Enter sends a line");
+                eof_button.set_tooltip_text("End the run's input (Ctrl-D on a terminal)");
+                input_box.pack_start(input_entry, Gtk::PACK_EXPAND_WIDGET);
+                input_box.pack_start(send_button, Gtk::PACK_SHRINK);
+                input_box.pack_start(eof_button, Gtk::PACK_SHRINK);
+                input_box.pack_start(latency_label, Gtk::PACK_SHRINK);
+                box.pack_start(input_box, Gtk::PACK_SHRINK);
+                usage_label.set_halign(Gtk::ALIGN_START);
+                usage_label.set_selectable(true);
+                usage_label.set_line_wrap(true);
+                box.pack_start(usage_label, Gtk::PACK_SHRINK);
+                end_mark = buffer->create_mark(buffer->end(), false);
+                stderr_tag = buffer->create_tag("stderr");
+                stderr_tag->property_foreground() = "#c01c28";
+                input_tag = buffer->create_tag("input");
+                input_tag->property_foreground() = "#1c71d8";
+            }
+
+            void append(const std::string& text, bool is_stderr, bool is_input = false) {
+                if (is_input) {
+                    buffer->insert_with_tag(buffer->end(), text, input_tag);
+                } else if (is_stderr) {
+                    buffer->insert_with_tag(buffer->end(), text, stderr_tag);
+                } else {
+                    buffer->insert(buffer->end(), text);
+                }
+                // Keep memory bounded by the display: drop the oldest text, trimming
+                // to three quarters so this does not run on every append.
+                if (buffer->get_char_count() > kMaxOutputChars) {
+                    int excess = buffer->get_char_count() - kMaxOutputChars * 3 / 4;
+                    buffer->erase(buffer->begin(), buffer->get_iter_at_offset(excess));
+                }
+                textview.scroll_to(end_mark, 0.0);
+            }
+        };
+
+        struct Columns : public Gtk::TreeModel::ColumnRecord {
+            Columns() { add(id); add(title); add(pid); add(elapsed); add(exit_code); }
+            Gtk::TreeModelColumn<int> id;
+            Gtk::TreeModelColumn<Glib::ustring> title;
+            Gtk::TreeModelColumn<Glib::ustring> pid;
+            Gtk::TreeModelColumn<Glib::ustring> elapsed;
+            Gtk::TreeModelColumn<Glib::ustring> exit_code;
+        };
+
+        Gtk::Box m_vbox;
+        Gtk::Paned m_paned;
+        Gtk::ScrolledWindow m_runs_scrolledwindow;
+        Gtk::TreeView m_runs_view;
+        Glib::RefPtr<Gtk::ListStore> m_runs_store;
+        Columns m_columns;
+        Gtk::Notebook m_notebook;
+        std::map<int, std::unique_ptr<RunTab>> m_tabs;
+        int m_next_id = 0;
+        sigc::connection m_elapsed_timer;
+
+        void submit_input(int run_id) {
+            auto now = std::chrono::steady_clock::now();
+            auto it = m_tabs.find(run_id);
+            if (it == m_tabs.end() || !it->second->running || !on_input) return;
+            RunTab& tab = *it->second;
+            std::string line = tab.input_entry.get_text() + "\n";
+            if (on_input(run_id, line, now)) {
+                tab.append(line, false, true);
+                tab.input_entry.set_text("");
+            } else {
+                tab.latency_label.set_text("Input not accepted");
+            }
+        }
+
+        void request_stop(bool force) {
+            int page = m_notebook.get_current_page();
+            for (auto& [id, tab] : m_tabs) {
+                if (m_notebook.page_num(tab->box) == page && tab->running && on_stop_requested) {
+                    on_stop_requested(id, force);
+                }
+            }
+        }
+
+        static std::string format_elapsed(std::chrono::steady_clock::duration elapsed) {
+            char text[32];
+            std::snprintf(text, sizeof(text), "%.1f s", std::chrono::duration<double>(elapsed).count());
+            return text;
+        }
+
+        bool update_elapsed() {
+            auto now = std::chrono::steady_clock::now();
+            for (auto& [id, tab] : m_tabs) {
+                if (tab->running) (*tab->iter)[m_columns.elapsed] = format_elapsed(now - tab->started);
+            }
+            return true;
+        }
     };
     OutputWindow m_output_window;
 
@@ -258,13 +9527,63 @@ private:
     Gtk::ScrolledWindow m_error_scrolledwindow;
     Gtk::TextView m_error_textview;
     Glib::RefPtr<Gtk::TextBuffer> m_error_buffer;
+    DiagnosticsView m_diagnostics_view;
+    Gtk::ComboBoxText m_compiler;
+    Gtk::Entry m_run_args;
+    Gtk::CheckButton m_profile_build;
+    Gtk::CheckButton m_use_pty;
+    Gtk::CheckButton m_interactive_input;
+    Gtk::CheckButton m_count_events;
+    Gtk::CheckButton m_profile_heap;
+    Gtk::SpinButton m_wall_limit;
+    Gtk::SpinButton m_cpu_limit;
+    Gtk::SpinButton m_address_space_limit;
+    Gtk::SpinButton m_cgroup_cpus;
+    Gtk::SpinButton m_cgroup_memory;
+    std::vector<RunHistoryEntry> m_run_history;  // This session's runs after the stored ones, oldest first
+    HistoryStore m_history_store;
+    std::set<std::string> m_reported_regressions; // Project and commit, so each is reported once
+    RunHistoryWindow m_history_window;
+    BenchmarkWindow m_benchmark_window;
+    AllocatorMatrixWindow m_allocator_window;
+    CompilerMatrixWindow m_compiler_matrix_window;
+    ScalingSweepWindow m_scaling_window;
+    InputSweepWindow m_input_sweep_window;
+    WatchWindow m_watch_window;
+    BisectWindow m_bisect_window;
+    CacheSimWindow m_cache_sim_window;
+    CompileTimeReportWindow m_report_window;
+    FlameGraphWindow m_flame_window;
+    HeapReportWindow m_heap_window;
 
     /**
      * @brief Appends text to the main output text box.
      * @param text The text to append.
      */
     void append_to_output(const std::string& text) {
-        m_output_window.append_to_output(text);
+        m_output_window.append_to_output(m_current_run, text);
+    }
+
+    /** @brief Fills the compiler choice once the toolchain probe is done. */
+    void show_toolchains(const std::vector<Toolchain>& toolchains, const std::string& preferred) {
+        m_compiler.remove_all();
+        for (const auto& toolchain : toolchains) m_compiler.append(toolchain.name, toolchain.label());
+        m_compiler.set_sensitive(!toolchains.empty());
+        if (!m_compiler.set_active_id(preferred)) m_compiler.set_active(0);
+        m_compiler_matrix_window.set_toolchains(toolchains);
+    }
+
+    /** @brief Builds in the benchmark windows with the compiler chosen here. */
+    void on_compiler_changed() {
+        std::string compiler = m_compiler.get_active_id();
+        m_benchmark_window.set_compiler(compiler);
+        m_allocator_window.set_compiler(compiler);
+        m_compiler_matrix_window.set_compiler(compiler);
+        m_scaling_window.set_compiler(compiler);
+        m_input_sweep_window.set_compiler(compiler);
+        m_watch_window.set_compiler(compiler);
+        m_bisect_window.set_compiler(compiler);
+        m_cache_sim_window.set_compiler(compiler);
     }
 
     /**
@@ -278,32 +9597,268 @@ private:
         m_error_textview.scroll_to(end_iter, 0.0);
     }
 
+    // Run (output tab) that launch_project is currently reporting into
+    int m_current_run = 0;
+    // Processes still running, keyed by run id
+    std::map<int, std::unique_ptr<ProcessSupervisor>> m_active_runs;
+    // Executables of those runs, which the next build of the same project must not overwrite
+    std::set<std::filesystem::path> m_executables_in_use;
+    // Slow follow-up work of runs (e.g. symbolising samples); finishes before the windows it reports to go
+    BackgroundTasks m_background;
+
+    /**
+     * @brief Reports OOM kills, memory.max pressure and CPU throttling of a run's cgroup.
+     */
+    void report_envelope_events(const std::string& project_name, const ProcessSupervisor::Limits& envelope,
+                                const RunUsage& usage) {
+        if (!usage.cgroup_valid) return;
+        if (usage.oom_kills || usage.oom_events) {
+            append_to_error("Error: " + project_name + " ran out of memory in its cgroup (memory.max "
+                            + std::to_string(envelope.cgroup_memory_mb) + " MiB): "
+                            + std::to_string(usage.oom_kills) + " process(es) OOM-killed\n");
+        } else if (usage.memory_max_events) {
+            append_to_error("Warning: " + project_name + " hit its memory cap "
+                            + std::to_string(usage.memory_max_events) + " time(s) and was forced to reclaim\n");
+        }
+        if (usage.cpu_throttled_periods) {
+            char text[160];
+            std::snprintf(text, sizeof(text), " was CPU-throttled in %llu of %llu periods (%.3f s) at %.2f CPUs\n",
+                          usage.cpu_throttled_periods, usage.cpu_periods, usage.cpu_throttled_seconds,
+                          envelope.cgroup_cpus);
+            append_to_error("Warning: " + project_name + text);
+        }
+    }
+
+    /**
+     * @brief Folds a sampled run's stacks on a worker and then shows its flame graph.
+     * @param fold From ProcessSupervisor::take_stack_folder().
+     * @param source What sampled the run, for the window's caption.
+     * @param folded_callback Called on the GTK thread once the samples have been read.
+     */
+    void show_profile(const std::string& project_name, std::function<FoldedStacks()> fold, const std::string& source,
+                      std::function<void()> folded_callback) {
+        if (!fold) {
+            folded_callback();
+            return;
+        }
+        m_background.run([this, project_name, fold = std::move(fold), source,
+                          folded_callback = std::move(folded_callback)]() -> std::function<void()> {
+            FoldedStacks folded;
+            std::string error;
+            try {
+                folded = fold();
+            } catch (const std::exception& e) {
+                error = e.what();
+            }
+            return [this, project_name, folded = std::move(folded), source, error, folded_callback]() {
+                folded_callback();
+                if (!error.empty()) {
+                    append_to_error("Error: " + project_name + ": could not read the samples: " + error + "\n");
+                } else if (folded.total() == 0) {
+                    append_to_error("Warning: " + project_name + ": no stack samples were recorded (the run may have been too short)\n");
+                } else {
+                    m_flame_window.set_profile(project_name, folded, source);
+                    m_flame_window.present();
+                }
+            };
+        });
+    }
+
+    /**
+     * @brief Symbolises a heap-profiled run's allocation sites on a worker and then shows them.
+     * @param report From ProcessSupervisor::take_heap_reporter().
+     * @param reported_callback Called on the GTK thread once the report is built.
+     */
+    void show_heap_report(int run_id, const std::string& project_name, std::function<HeapReport()> report,
+                          std::function<void()> reported_callback) {
+        if (!report) {
+            reported_callback();
+            return;
+        }
+        m_background.run([this, run_id, project_name, report = std::move(report),
+                          reported_callback = std::move(reported_callback)]() -> std::function<void()> {
+            HeapReport heap;
+            std::string error;
+            try {
+                heap = report();
+            } catch (const std::exception& e) {
+                error = e.what();
+            }
+            return [this, run_id, project_name, heap = std::move(heap), error, reported_callback]() {
+                reported_callback();
+                if (!error.empty()) {
+                    append_to_error("Error: " + project_name + ": could not build the heap profile: " + error + "\n");
+                } else if (heap.processes) {
+                    m_output_window.append_to_output(run_id, "Heap: " + heap.summary() + "\n");
+                    m_heap_window.set_report(project_name, heap);
+                    m_heap_window.present();
+                }
+            };
+        });
+    }
+
+    /**
+     * @brief Starts a built C++ project and streams its output live into its tab.
+     * @param run_id The output tab of this launch.
+     * @param project_name Used to label errors, since several runs can be active.
+     * @param run_cmd The executable and its arguments.
+     * @param sample Record call stacks and show a flame graph at exit: with
+     * `perf record` if it is installed, else with the built-in StackSampler.
+     * @param commit, configuration Recorded in the run history, where runs
+     * of the same configuration are checked for a regression between commits.
+     */
+    void start_run(int run_id, const std::string& project_name, const std::vector<std::string>& run_cmd,
+                   bool sample = false, const std::string& commit = "", const std::string& configuration = "") {
+        append_to_output("Running C++ project: " + format_command(run_cmd) + "\n");
+        ProcessSupervisor::Limits limits;
+        limits.wall_seconds = static_cast<unsigned>(m_wall_limit.get_value_as_int());
+        limits.cpu_seconds = static_cast<unsigned>(m_cpu_limit.get_value_as_int());
+        limits.address_space_mb = static_cast<unsigned>(m_address_space_limit.get_value_as_int());
+        limits.cgroup_cpus = m_cgroup_cpus.get_value();
+        limits.cgroup_memory_mb = static_cast<unsigned>(m_cgroup_memory.get_value_as_int());
+        auto watcher = std::make_unique<ProcessSupervisor>();
+        ChildProcess child;
+        auto started = std::chrono::steady_clock::now();
+        try {
+            SpawnOptions options;
+            options.argv = run_cmd;
+            if (m_interactive_input.get_active()) options.stdin_mode = StdioMode::Pipe;
+            options.stderr_mode = StdioMode::Pipe;
+            options.pty = m_use_pty.get_active();
+            std::string warning = watcher->prepare(options, limits);
+            if (!warning.empty()) append_to_error("Warning: " + project_name + ": " + warning + "\n");
+            if (m_count_events.get_active()) watcher->enable_counters(options);
+            if (m_profile_heap.get_active()) {
+                try {
+                    watcher->enable_heap_profile(options);
+                } catch (const std::exception& e) {
+                    append_to_error("Warning: " + project_name + ": heap not profiled: " + e.what() + "\n");
+                }
+            }
+            if (sample) watcher->enable_sampler(options, run_cmd.front() + ".perf.data");
+            child = spawn_process(options);
+            if (sample) append_to_output("Sampling with " + watcher->stack_source() + "\n");
+            std::string counters_error = watcher->counters_error();
+            if (!counters_error.empty()) {
+                append_to_error("Warning: " + project_name + ": " + counters_error
+                                + "; Cache Simulation in the C++ Projects menu needs no hardware counters\n");
+            }
+            std::string sampler_error = watcher->sampler_error();
+            if (!sampler_error.empty()) append_to_error("Warning: " + project_name + ": not profiled: " + sampler_error + "\n");
+        } catch (const std::exception& e) {
+            append_to_error("Error: Could not execute run command: " + std::string(e.what()) + "\n");
+            return;
+        }
+        m_executables_in_use.insert(run_cmd.front());
+        append_to_output("Envelope: " + watcher->envelope().describe() + "\n");
+        append_to_output("Project output:\n");
+        m_output_window.set_running(run_id, child.pid, child.stdin_fd >= 0);
+        watcher->on_output = [this, run_id](OutputRecord::Stream stream, const std::string& text) {
+            m_output_window.append_to_output(run_id, text, stream == OutputRecord::Stream::Stderr);
+        };
+        watcher->on_response = [this, run_id](double) {
+            auto& latencies = m_active_runs.at(run_id)->response_latencies();
+            std::vector<double> sorted = latencies;
+            std::sort(sorted.begin(), sorted.end());
+            char text[128];
+            std::snprintf(text, sizeof(text), "Response: %.1f ms (median %.1f, max %.1f ms over %zu)",
+                          latencies.back(), sorted[sorted.size() / 2], sorted.back(), sorted.size());
+            m_output_window.set_input_latency(run_id, text);
+        };
+        auto started_wall = std::chrono::system_clock::now();
+        bool heap_profiled = m_profile_heap.get_active();
+        std::string executable = run_cmd.front();
+        watcher->on_exit = [this, run_id, project_name, started_wall, sample, heap_profiled, commit,
+                            configuration, executable](int status) {
+            auto& run = m_active_runs.at(run_id);
+            m_output_window.append_to_output(run_id, "\n" + run->record().summary() + "\n");
+            int run_result_code = exit_code_of(status);
+            const std::string& reason = run->termination_reason();
+            m_output_window.set_finished(run_id, run_result_code, reason);
+            m_output_window.set_usage_summary(run_id, run->usage().summary());
+            RunHistoryEntry entry;
+            entry.project = project_name;
+            entry.started = started_wall;
+            entry.exit_code = run_result_code;
+            entry.reason = reason;
+            entry.envelope = run->envelope().describe();
+            entry.usage = run->usage();
+            entry.commit = commit;
+            entry.configuration = configuration;
+            entry.instrumented = sample || heap_profiled;
+            report_envelope_events(project_name, run->envelope(), run->usage());
+            m_run_history.push_back(entry);
+            m_history_window.add_entry(entry);
+            if (!m_history_store.append(entry.to_json_value())) {
+                append_to_error("Warning: could not write the run history " + m_history_store.path().string() + "\n");
+            }
+            Regression regression;
+            if (detect_regression(m_run_history, entry, regression)
+                && m_reported_regressions.insert(project_name + "@" + regression.since_commit).second) {
+                append_to_error("Performance regression in " + project_name + " " + regression.describe()
+                                + "; use Bisect in the C++ Projects menu to find the commit\n");
+                for (const auto& project : projects_) {
+                    if (project.name == project_name) m_bisect_window.suggest(project, regression.previous_commit,
+                                                                              regression.since_commit);
+                }
+            }
+            // The executable is read for its symbols, so it is not rebuilt until both readers are done
+            auto readers = std::make_shared<int>(2);
+            auto done_reading = [this, executable, readers]() {
+                if (--*readers == 0) m_executables_in_use.erase(executable);
+            };
+            show_profile(project_name, sample ? run->take_stack_folder() : nullptr, run->stack_source(), done_reading);
+            show_heap_report(run_id, project_name, run->take_heap_reporter(), done_reading);
+            if (run_result_code == 0) {
+                m_output_window.append_to_output(run_id, "Project exited successfully.\n");
+            } else {
+                append_to_error("Error running C++ project " + project_name + ". Command returned: "
+                                + std::to_string(run_result_code) + (reason.empty() ? "" : " (" + reason + ")") + "\n");
+            }
+            // The watcher is still on the call stack; release it from the main loop.
+            Glib::signal_idle().connect_once([this, run_id]() { m_active_runs.erase(run_id); });
+        };
+        watcher->start(std::move(child), started);
+        m_active_runs[run_id] = std::move(watcher);
+    }
+
     /**
      * @brief Function to launch a project based on its type and path.
      * This function now includes a basic compilation step for C++ projects
      * and redirects output to the text views.
+     * @param sample Profile the run (C++ only): build with frame pointers and
+     * debug info, then show where it spent its CPU time as a flame graph.
      */
-    void launch_project(const Project& project) {
-        // Clear previous output/errors
-        m_output_window.clear_output();
-        m_error_buffer->set_text("");
+    void launch_project(const Project& project, bool sample = false) {
+        // Each launch reports into its own tab; runs already in progress keep theirs
+        m_current_run = m_output_window.add_run(project.name);
+        // The error log and diagnostics are shared by all runs: label this launch rather than
+        // clearing what runs still in progress reported. Diagnostics are replaced once this build ends.
+        append_to_error("--- " + project.name + " #" + std::to_string(m_current_run) + " ---\n");
 
         m_output_window.show();
         append_to_output("Attempting to launch: " + project.name + " (Type: " + project.type + ", Path: " + project.path + ")\n");
 
         if (project.type == "HTML") {
-            std::string command;
-            #ifdef _WIN32
-                command = "start \"\" \"" + project.path + "\"";
-            #elif __APPLE__
-                command = "open \"" + project.path + "\"";
+            #ifdef __APPLE__
+                std::vector<std::string> command = {"open", project.path};
             #else // Linux
-                command = "xdg-open \"" + project.path + "\"";
+                std::vector<std::string> command = {"xdg-open", project.path};
             #endif
-            append_to_output("Executing command: " + command + "\n");
-            int result = std::system(command.c_str());
+            append_to_output("Executing command: " + format_command(command) + "\n");
+            int result = -1;
+            try {
+                // The browser inherits xdg-open's stdio, so nothing may be left for it to hold open
+                SpawnOptions options;
+                options.argv = command;
+                options.stdout_mode = StdioMode::Null;
+                options.stderr_mode = StdioMode::Null;
+                result = spawn_process(options).wait();
+            } catch (const std::exception& e) {
+                append_to_error(std::string(e.what()) + "\n");
+            }
             if (result != 0) {
-                append_to_error("Error launching HTML project. Command returned: " + std::to_string(result) + "\n");
+                append_to_error("Error launching HTML project. Command returned: " + std::to_string(exit_code_of(result)) + "\n");
             } else {
                 append_to_output("HTML project launched successfully.\n");
             }
@@ -324,66 +9879,136 @@ private:
             std::filesystem::path output_dir = source_path.parent_path();
             std::string executable_name = source_path.stem().string();
 
-            std::string compile_command;
-            std::string run_cmd;
-            std::filesystem::path executable_path;
-
             #ifdef _WIN32
-                executable_path = output_dir / (executable_name + ".exe");
-                compile_command = "g++ \"" + source_path.string() + "\" -o \"" + executable_path.string() + "\" -std=c++17 2>&1";
-                run_cmd = "\"" + executable_path.string() + "\" 2>&1";
+                const std::string extension = ".exe";
             #else // Linux and macOS
-                executable_path = output_dir / executable_name;
-                compile_command = "g++ \"" + source_path.string() + "\" -o \"" + executable_path.string() + "\" -std=c++17 2>&1";
-                run_cmd = "\"" + executable_path.string() + "\" 2>&1";
+                const std::string extension;
             #endif
-
-            append_to_output("Compiling C++ project: " + compile_command + "\n");
-
-            FILE* pipe_compile = popen(compile_command.c_str(), "r");
-            if (!pipe_compile) {
-                append_to_error("Error: Could not execute compile command.\n");
-                return;
+            std::filesystem::path canonical_path = output_dir / (executable_name + extension);
+            // A run still executing keeps its binary; build this one next to it under another name
+            std::filesystem::path executable_path = canonical_path;
+            for (int slot = 2; m_executables_in_use.count(executable_path); ++slot) {
+                executable_path = output_dir / (executable_name + "-" + std::to_string(slot) + extension);
             }
-            std::string compile_output;
-            char buffer[1024];
-            while (fgets(buffer, sizeof(buffer), pipe_compile) != nullptr) {
-                compile_output += buffer;
-            }
-            int compile_result_code = pclose(pipe_compile);
-            if (compile_result_code == -1) {
-                append_to_error("Error: Failed to close compile pipe.\n");
+            std::vector<std::string> run_cmd = {executable_path.string()};
+            try {
+                std::vector<std::string> args = split_arguments(m_run_args.get_text());
+                run_cmd.insert(run_cmd.end(), args.begin(), args.end());
+            } catch (const std::exception& e) {
+                append_to_error(std::string("Run arguments: ") + e.what() + "\n");
                 return;
             }
 
-            if (compile_result_code == 0) {
-                append_to_output("Compilation successful.\n");
-                append_to_output("Running C++ project: " + run_cmd + "\n");
-
-                FILE* pipe_run = popen(run_cmd.c_str(), "r");
-                if (!pipe_run) {
-                    append_to_error("Error: Could not execute run command.\n");
-                    return;
+            std::string compiler = m_compiler.get_active_id();
+            if (compiler.empty()) compiler = default_compiler();
+            // clang (including Apple's g++) has no JSON diagnostics and profiles via -ftime-trace
+            bool clang = compiler_is_clang(compiler);
+            bool profile_build = m_profile_build.get_active();
+            auto build_steps = [&](const std::filesystem::path& executable) {
+                std::vector<std::vector<std::string>> steps;
+                std::filesystem::path object = executable;
+                object += ".o";
+                if (profile_build && clang) {
+                    // The trace is written next to the object file, so compile and link separately.
+                    steps.push_back({compiler, "-c", source_path.string(), "-o", object.string(), "-std=c++17", "-ftime-trace"});
+                    steps.push_back({compiler, object.string(), "-o", executable.string()});
+                } else {
+                    std::vector<std::string> step = {compiler, source_path.string(), "-o", executable.string(), "-std=c++17"};
+                    if (!clang) step.push_back("-fdiagnostics-format=json");
+                    if (profile_build) step.push_back("-ftime-report");
+                    steps.push_back(step);
                 }
-                std::string run_output;
-                while (fgets(buffer, sizeof(buffer), pipe_run) != nullptr) {
-                    run_output += buffer;
+                if (sample) {
+                    // Frame pointers make call chains walkable; -g is for perf report/annotate afterwards
+                    for (const char* flag : {"-O2", "-g", "-fno-omit-frame-pointer"}) steps.front().push_back(flag);
                 }
-                int run_result_code = pclose(pipe_run);
-                if (run_result_code == -1) {
-                    append_to_error("Error: Failed to close run pipe.\n");
+                return steps;
+            };
+            std::vector<std::vector<std::string>> compile_steps = build_steps(executable_path);
+            std::filesystem::path object_path = executable_path;
+            object_path += ".o";
+
+            std::string commit;
+            try {
+                commit = git_output(output_dir, {"rev-parse", "HEAD"});
+            } catch (const std::exception&) {
+                // Not a git checkout; its runs are kept but never compared across commits
+            }
+            // What must match for two runs to be comparable: the build command (written with
+            // the project's usual output path, whichever slot this run built into) and the run arguments
+            std::vector<std::vector<std::string>> canonical_steps = build_steps(canonical_path);
+            std::string configuration = format_command(canonical_steps.front());
+            for (size_t i = 1; i < canonical_steps.size(); ++i) configuration += " && " + format_command(canonical_steps[i]);
+            configuration += " ; " + format_command(std::vector<std::string>(run_cmd.begin() + 1, run_cmd.end()));
+
+            std::string compile_output;
+            int compile_result_code = 0;
+            auto compile_started = std::chrono::steady_clock::now();
+            auto compile_started_wall = std::chrono::system_clock::now();
+            for (const auto& step : compile_steps) {
+                append_to_output("Compiling C++ project: " + format_command(step) + "\n");
+                try {
+                    ProcessResult result = run_process(step);
+                    compile_output += result.output;
+                    compile_result_code = result.status;
+                } catch (const std::exception& e) {
+                    append_to_error("Error: Could not execute compile command: " + std::string(e.what()) + "\n");
                     return;
                 }
+                if (compile_result_code != 0) break;
+            }
 
-                if (run_result_code == 0) {
-                    append_to_output("Project output:\n" + run_output + "\n");
+            if (profile_build) {
+                CompileTimeReport report;
+                if (clang) {
+                    std::filesystem::path trace_path = object_path;
+                    trace_path.replace_extension(".json");
+                    try {
+                        report.add_clang_trace(source_path.string(), parse_json(read_text_file(trace_path)));
+                    } catch (const std::exception& e) {
+                        append_to_error("Could not read time trace " + trace_path.string() + ": " + e.what() + "\n");
+                    }
                 } else {
-                    append_to_error("Error running C++ project. Command returned: " + std::to_string(run_result_code) + "\n");
-                    append_to_error("Run output (if any):\n" + run_output + "\n");
+                    report.add_gcc_time_report(source_path.string(), compile_output);
+                }
+                m_report_window.set_report(report);
+                m_report_window.show();
+            }
+
+            DiagnosticList diagnostics = parse_compiler_diagnostics(compile_output);
+            size_t warning_count = diagnostics.count(DiagnosticList::Severity::Warning);
+            size_t error_count = diagnostics.count(DiagnosticList::Severity::Error)
+                               + diagnostics.count(DiagnosticList::Severity::Fatal);
+            m_diagnostics_view.set_diagnostics(std::move(diagnostics));
+            m_history_store.append(JsonValue::make_object()
+                .set("type", "build")
+                .set("project", project.name)
+                .set("started", static_cast<long long>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                                    compile_started_wall.time_since_epoch()).count()))
+                .set("commit", commit)
+                .set("configuration", configuration)
+                .set("compiler", compiler)
+                .set("seconds", std::chrono::duration<double>(std::chrono::steady_clock::now() - compile_started).count())
+                .set("exit_code", exit_code_of(compile_result_code))
+                .set("warnings", static_cast<double>(warning_count))
+                .set("errors", static_cast<double>(error_count)));
+
+            if (compile_result_code == 0) {
+                append_to_output("Compilation successful.\n");
+                if (warning_count > 0) {
+                    append_to_output(std::to_string(warning_count) + " compiler warning(s), see Compiler Diagnostics.\n");
                 }
+                start_run(m_current_run, project.name, run_cmd, sample, commit, configuration);
+                return;
             } else {
-                append_to_error("Error compiling C++ project. Command returned: " + std::to_string(compile_result_code) + "\n");
-                append_to_error("Compiler output:\n" + compile_output + "\n");
+                append_to_error("Error compiling C++ project. Command returned: " + std::to_string(exit_code_of(compile_result_code)) + "\n");
+                if (error_count == 0) {
+                    // Nothing recognisable as a diagnostic (e.g. the compiler crashed): show what it said
+                    append_to_error(compile_output.empty() ? "The compiler printed nothing.\n" : compile_output + "\n");
+                } else {
+                    append_to_error(std::to_string(error_count) + " error(s), " + std::to_string(warning_count)
+                                    + " warning(s), see Compiler Diagnostics.\n");
+                }
             }
         } else {
             append_to_error("Unsupported project type for launching: " + project.type + "\n");
@@ -391,6 +10016,8 @@ private:
     }
 };
 
+// Left out when the unit tests compile this file in with their own main()
+#ifndef BOREDAF_NO_MAIN
 /**
  * @brief Main function of the application.
  * Initializes Gtkmm, creates the main window, and runs the application.
@@ -399,6 +10026,19 @@ private:
  * @return Application exit code.
  */
 int main(int argc, char* argv[]) {
+    // Fork the spawn helper while the address space is still small
+    g_spawn_helper.start();
+    // Writing input to a run that has exited must fail with EPIPE, not kill the launcher.
+    // Set after the helper is forked so its children start with the default action.
+    signal(SIGPIPE, SIG_IGN);
+
+    if (argc >= 2 && std::string(argv[1]) == "--bench-spawn") {
+        benchmark_spawn(argc >= 3 ? std::max(1, std::atoi(argv[2])) : 200);
+        return 0;
+    }
+    // Compiled (or found in the cache) while the projects are cloned; needs the helper forked first
+    heap_interposer_build();
+
     // Determine the system's temporary directory
     std::filesystem::path base_temp_dir = std::filesystem::temp_directory_path();
     std::string unique_subdir_name = "BareBonesApp_Projects_" + std::to_string(std::chrono::duration_cast<std::chrono::milliseconds>(
@@ -441,13 +10081,11 @@ int main(int argc, char* argv[]) {
     for (size_t i = 0; i < project_repos.size(); ++i) {
         const auto& repo = project_repos[i];
         std::filesystem::path repo_target_dir = g_extraction_target_dir / repo.local_dir;
-        std::string clone_cmd = "git clone --depth 1 " + repo.repo_url + " \"" + repo_target_dir.string() + "\"";
-        std::cout << "Cloning " << repo.repo_url << " into " << repo_target_dir << std::endl;
-        int clone_result = std::system(clone_cmd.c_str());
-        cloning_window->set_status(i, clone_result == 0);
+        bool cloned = clone_repository(repo.repo_url, repo_target_dir.string());
+        cloning_window->set_status(i, cloned);
         while (Gtk::Main::events_pending()) Gtk::Main::iteration();
-        if (clone_result != 0) {
-            std::cerr << "Error cloning repo: " << repo.repo_url << " (code " << clone_result << ")" << std::endl;
+        if (!cloned) {
+            std::cerr << "Error cloning repo: " << repo.repo_url << std::endl;
             continue;
         }
         // Detect project type and main file
@@ -486,4 +10124,5 @@ int main(int argc, char* argv[]) {
     MainWindow window(projects);
     int result = app->run(window);
     return result;
-}
\ No newline at end of file
+}
+#endif // BOREDAF_NO_MAIN
\ No newline at end of file
@@ -0,0 +1,42 @@
+/**
+ * @file bisect_test.cpp
+ * @brief Unit tests for bisecting a performance regression.
+ */
+
+#include "main.cpp"
+#include "test_harness.h"
+
+// --- Bisection ---
+
+TEST(bisector_classifies_against_both_ends) {
+    std::vector<double> good = {1.00, 1.01, 0.99, 1.00, 1.02};
+    std::vector<double> bad = {1.50, 1.51, 1.49, 1.50, 1.52};
+    using Verdict = PerformanceBisector::Verdict;
+    CHECK(PerformanceBisector::classify(good, bad, {1.00, 1.01, 0.99, 1.01, 1.00}) == Verdict::Fast);
+    CHECK(PerformanceBisector::classify(good, bad, {1.50, 1.49, 1.51, 1.50, 1.50}) == Verdict::Slow);
+    CHECK(PerformanceBisector::classify(good, bad, {0.9, 1.6, 1.0, 1.5, 1.2}) == Verdict::Unclear);
+}
+
+TEST(bisector_narrows_to_the_first_slow_commit) {
+    PerformanceBisector bisector(9); // 0 good, 8 bad; commit 5 is the first slow one
+    for (size_t index = bisector.next(); index != PerformanceBisector::npos; index = bisector.next()) {
+        bisector.mark(index, index >= 5);
+    }
+    CHECK(bisector.exact());
+    CHECK(bisector.last_fast() == 4);
+    CHECK(bisector.first_slow() == 5);
+}
+
+TEST(bisector_steps_around_skipped_commits) {
+    PerformanceBisector bisector(9);
+    bisector.skip(4);
+    for (size_t index = bisector.next(); index != PerformanceBisector::npos; index = bisector.next()) {
+        CHECK(index != 4);
+        bisector.mark(index, index >= 5);
+    }
+    CHECK(!bisector.exact());
+    CHECK(bisector.last_fast() == 3);
+    CHECK(bisector.first_slow() == 5);
+}
+
+int main() { return run_tests(); }
@@ -0,0 +1,84 @@
+/**
+ * @file cachesim_test.cpp
+ * @brief Unit tests for reading Cachegrind and Callgrind profiles.
+ */
+
+#include "main.cpp"
+#include "test_harness.h"
+
+// --- Cache Simulation ---
+
+TEST(cachegrind_output_gives_counts_per_function) {
+    CacheSimReport report = parse_cachegrind_output(
+        "cmd: ./prog --fast\n"
+        "events: Ir D1mr\n"
+        "fl=a.c\n"
+        "fn=f\n"
+        "5 100 2\n"
+        "6 50 1\n"
+        "fn=g\n"
+        "9 10 0\n"
+        "summary: 160 3\n");
+    CHECK(report.command == "./prog --fast");
+    CHECK(report.events.size() == 2);
+    CHECK(report.functions.size() == 2);
+    CHECK(report.functions[0].name == "f");
+    CHECK(report.functions[0].file == "a.c");
+    CHECK(report.count(report.functions[0].counts, "Ir") == 150);
+    CHECK(report.count(report.functions[0].counts, "D1mr") == 3);
+    CHECK(report.count(report.totals, "Ir") == 160);
+    CHECK(report.count(report.totals, "DLmr") == 0);
+}
+
+TEST(callgrind_output_expands_names_and_skips_call_costs) {
+    CacheSimReport report = parse_cachegrind_output(
+        "events: Ir\n"
+        "fl=(1) a.c\n"
+        "fn=(1) g\n"
+        "3 40\n"
+        "fn=(2) main\n"
+        "1 5\n"
+        "cfn=(1)\n"
+        "calls=1 3\n"
+        "2 40\n"
+        "fn=(1)\n"
+        "+1 2\n");
+    CHECK(report.functions.size() == 2);
+    CHECK(report.functions[0].name == "g");
+    CHECK(report.count(report.functions[0].counts, "Ir") == 42);
+    CHECK(report.functions[1].name == "main");
+    CHECK(report.count(report.functions[1].counts, "Ir") == 5);
+    CHECK(report.count(report.totals, "Ir") == 47); // Summed, as there is no summary line
+}
+
+TEST(cachegrind_output_without_events_is_rejected) {
+    CHECK_THROWS(parse_cachegrind_output("fl=a.c\nfn=f\n1 2\n"));
+}
+
+TEST(functions_are_summed_per_name_across_files) {
+    CacheSimReport report = parse_cachegrind_output(
+        "events: Ir D1mr\n"
+        "fl=a.cpp\n"
+        "fn=inline_helper()\n"
+        "1 100 1\n"
+        "fn=main\n"
+        "2 10 0\n"
+        "fl=b.cpp\n"
+        "fn=inline_helper()\n"
+        "1 50 2\n"
+        "fl=c.cpp\n"
+        "fn=inline_helper()\n"
+        "1 7 0\n");
+    CHECK(report.functions.size() == 4);
+    std::vector<CacheSimFunction> merged = report.functions_by_name();
+    CHECK(merged.size() == 2);
+    CHECK(merged[0].name == "inline_helper()");
+    CHECK(merged[0].file == "a.cpp, +2");
+    CHECK(report.count(merged[0].counts, "Ir") == 157);
+    CHECK(report.count(merged[0].counts, "D1mr") == 3);
+    CHECK(merged[1].name == "main");
+    CHECK(merged[1].file == "a.cpp");
+    CHECK(report.count(merged[1].counts, "Ir") == 10);
+}
+
+int main() { return run_tests(); }
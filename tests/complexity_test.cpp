@@ -0,0 +1,85 @@
+/**
+ * @file complexity_test.cpp
+ * @brief Unit tests for fitting complexity models to input-size sweeps.
+ */
+
+#include "main.cpp"
+#include "test_harness.h"
+
+#include <cmath>
+
+// --- Complexity ---
+
+TEST(complexity_fits_linear_and_quadratic_growth) {
+    std::vector<double> n = {1000, 2000, 4000, 8000, 16000, 32000};
+    std::vector<double> linear, quadratic;
+    for (double size : n) {
+        linear.push_back(0.001 + 2e-6 * size);
+        quadratic.push_back(0.001 + 3e-9 * size * size);
+    }
+    ComplexityReport linear_report = ComplexityReport::of(n, linear);
+    CHECK(std::string(linear_report.best_name()) == "O(n)");
+    CHECK(std::fabs(linear_report.exponent - 1.0) < 0.1);
+    ComplexityReport quadratic_report = ComplexityReport::of(n, quadratic);
+    CHECK(std::string(quadratic_report.best_name()) == "O(n^2)");
+    CHECK(std::fabs(quadratic_report.exponent - 2.0) < 0.1);
+}
+
+TEST(complexity_fits_constant_and_n_log_n_growth) {
+    std::vector<double> n = {1000, 2000, 4000, 8000, 16000, 32000};
+    std::vector<double> constant, n_log_n;
+    for (double size : n) {
+        constant.push_back(0.25);
+        n_log_n.push_back(1e-7 * size * std::log2(size));
+    }
+    CHECK(std::string(ComplexityReport::of(n, constant).best_name()) == "O(1)");
+    ComplexityReport report = ComplexityReport::of(n, n_log_n);
+    CHECK(std::string(report.best_name()) == "O(n log n)");
+    CHECK(report.worse_than(2)); // Grows faster than O(n)
+    CHECK(!report.worse_than(3));
+}
+
+// --- Generated Inputs ---
+
+namespace {
+
+/** @brief Points cache_directory() at a fresh directory for the generated inputs. */
+std::filesystem::path use_scratch_cache() {
+    char pattern[] = "/tmp/boredaf-test-XXXXXX";
+    const char* dir = mkdtemp(pattern);
+    if (dir) setenv("XDG_CACHE_HOME", dir, 1);
+    return dir ? dir : "";
+}
+
+} // namespace
+
+TEST(generated_inputs_are_deterministic_and_within_their_bound) {
+    std::filesystem::path scratch = use_scratch_cache();
+    CHECK(!scratch.empty());
+    std::filesystem::path file = generated_input(InputGenerator::CountedIntegers, 1000);
+    std::string text = read_text_file(file);
+    CHECK(text.rfind("1000\n", 0) == 0);
+    CHECK(text.size() <= generated_input_bytes(InputGenerator::CountedIntegers, 1000));
+    std::filesystem::remove(file);
+    CHECK(read_text_file(generated_input(InputGenerator::CountedIntegers, 1000)) == text); // Same seed, same input
+    std::filesystem::path words = generated_input(InputGenerator::Words, 500);
+    CHECK(std::filesystem::file_size(words) <= generated_input_bytes(InputGenerator::Words, 500));
+    std::filesystem::remove_all(scratch);
+}
+
+TEST(generated_inputs_over_the_cap_are_refused) {
+    std::filesystem::path scratch = use_scratch_cache();
+    long long too_many = static_cast<long long>(kMaxGeneratedInputBytes / 12 + 1);
+    CHECK(generated_input_bytes(InputGenerator::Integers, too_many) > kMaxGeneratedInputBytes);
+    CHECK(generated_input_bytes(InputGenerator::Integers, -5) == 0);
+    CHECK_THROWS(generated_input(InputGenerator::Integers, too_many));
+    CHECK(std::filesystem::is_empty(scratch / "boredaf" / "inputs")); // Nothing partial left behind
+    std::filesystem::remove_all(scratch);
+}
+
+TEST(size_placeholders_are_substituted) {
+    CHECK(substitute_size("--n {n} --out {n}.txt", 4096) == "--n 4096 --out 4096.txt");
+    CHECK(substitute_size("no placeholder", 7) == "no placeholder");
+}
+
+int main() { return run_tests(); }
@@ -0,0 +1,54 @@
+/**
+ * @file counters_test.cpp
+ * @brief Unit tests for counting a run's events with perf_event_open.
+ * Machines without a PMU or with perf events locked down cannot count; the
+ * tests then only check that attaching fails with a reason.
+ */
+
+#include "main.cpp"
+#include "test_harness.h"
+
+// --- Performance Counters ---
+
+namespace {
+
+/** @brief Runs a short busy loop with counters attached while it is held before exec. */
+bool count_busy_loop(PerfCounters& counters, RunUsage& usage) {
+    SpawnOptions options;
+    options.argv = {"sh", "-c", "i=0; while [ $i -lt 20000 ]; do i=$((i + 1)); done"};
+    options.stdout_mode = StdioMode::Null;
+    bool attached = false;
+    options.before_exec = [&](pid_t pid, bool held) { attached = counters.attach(pid, held); };
+    ChildProcess child = spawn_process(options);
+    int status = child.wait();
+    CHECK(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+    if (attached) counters.read_into(usage);
+    return attached;
+}
+
+} // namespace
+
+TEST(counters_count_a_run_from_exec) {
+    PerfCounters counters;
+    RunUsage usage;
+    if (!count_busy_loop(counters, usage)) {
+        CHECK(!counters.error().empty());
+        std::cout << "  (counters unavailable: " << counters.error() << ")\n";
+        return;
+    }
+    CHECK(usage.task_clock_valid);
+    CHECK(usage.task_clock_ns > 0.0);
+    if (!usage.counters_valid) return; // No PMU, e.g. in a VM
+    CHECK(usage.cycles > 0.0);
+    CHECK(usage.instructions > 0.0);
+    CHECK(usage.branches > 0.0);
+    CHECK(usage.branch_misses <= usage.branches);
+}
+
+int main() {
+    if (!g_spawn_helper.start()) {
+        std::cerr << "Could not start the spawn helper\n";
+        return 1;
+    }
+    return run_tests();
+}
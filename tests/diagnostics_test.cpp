@@ -0,0 +1,53 @@
+/**
+ * @file diagnostics_test.cpp
+ * @brief Unit tests for parsing compiler diagnostics, as text and as GCC JSON.
+ */
+
+#include "main.cpp"
+#include "test_harness.h"
+
+// --- Compiler Diagnostics ---
+
+TEST(diagnostics_parse_located_lines_and_notes) {
+    DiagnosticList list = parse_compiler_diagnostics(
+        "a.cpp:3:5: error: expected ';'\n"
+        "a.cpp:1:1: note: declared here\n"
+        "b.cpp:7: warning: unused variable\n");
+    CHECK(list.top_level.size() == 2);
+    CHECK(list.count(DiagnosticList::Severity::Error) == 1);
+    CHECK(list.count(DiagnosticList::Severity::Warning) == 1);
+    const auto& error = list.items[list.top_level[0]];
+    CHECK(list.location(error) == "a.cpp:3:5");
+    CHECK(error.message == "expected ';'");
+    CHECK(error.children.size() == 1);
+    CHECK(list.items[error.children[0]].severity == DiagnosticList::Severity::Note);
+    CHECK(list.location(list.items[list.top_level[1]]) == "b.cpp:7");
+    CHECK(list.files.size() == 2); // a.cpp is interned once
+}
+
+TEST(diagnostics_attach_include_context_to_the_next_diagnostic) {
+    DiagnosticList list = parse_compiler_diagnostics(
+        "In file included from main.cpp:2:\n"
+        "util.h:4:10: fatal error: missing.h: No such file or directory\n");
+    CHECK(list.top_level.size() == 1);
+    const auto& fatal = list.items[list.top_level[0]];
+    CHECK(fatal.severity == DiagnosticList::Severity::Fatal);
+    CHECK(fatal.children.size() == 1);
+    CHECK(list.items[fatal.children[0]].message == "In file included from main.cpp:2:");
+}
+
+TEST(diagnostics_decode_gcc_json) {
+    DiagnosticList list = parse_compiler_diagnostics(
+        R"([{"kind": "error", "message": "no match", "locations": [{"caret": {"file": "x.cpp", "line": 9, "column": 2}}],)"
+        R"( "children": [{"kind": "note", "message": "candidate", "locations": []}]}])"
+        "\n");
+    CHECK(list.top_level.size() == 1);
+    const auto& error = list.items[list.top_level[0]];
+    CHECK(error.severity == DiagnosticList::Severity::Error);
+    CHECK(list.location(error) == "x.cpp:9:2");
+    CHECK(error.children.size() == 1);
+    CHECK(list.items[error.children[0]].message == "candidate");
+    CHECK(list.items[error.children[0]].file == -1);
+}
+
+int main() { return run_tests(); }
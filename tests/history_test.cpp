@@ -0,0 +1,156 @@
+/**
+ * @file history_test.cpp
+ * @brief Unit tests for the persistent run history and regression detection.
+ */
+
+#include "main.cpp"
+#include "test_harness.h"
+
+// --- Regression Detection ---
+
+namespace {
+
+RunHistoryEntry history_run(const std::string& commit, double wall_seconds) {
+    RunHistoryEntry entry;
+    entry.project = "demo";
+    entry.configuration = "g++ -O2";
+    entry.commit = commit;
+    entry.exit_code = 0;
+    entry.usage.wall_seconds = wall_seconds;
+    return entry;
+}
+
+} // namespace
+
+TEST(regression_found_after_a_slower_commit) {
+    // Eight runs a side: with five the smallest possible p-value is still above 0.01
+    std::vector<RunHistoryEntry> history;
+    for (double wall : {1.00, 1.01, 0.99, 1.02, 1.00, 0.98, 1.01, 1.00}) history.push_back(history_run("aaaa", wall));
+    for (double wall : {1.30, 1.31, 1.29, 1.32, 1.30, 1.28, 1.31, 1.30}) history.push_back(history_run("bbbb", wall));
+    Regression found;
+    CHECK(detect_regression(history, history.back(), found));
+    CHECK(found.since_commit == "bbbb");
+    CHECK(found.previous_commit == "aaaa");
+    CHECK(found.wall.relative_change > 0.25);
+}
+
+TEST(regression_found_after_an_earlier_speed_up) {
+    // fast -> faster -> slow: the speed-up split has the lower p-value, but only a slow-down is a regression
+    const double jitter[] = {0.0, 0.01, -0.01, 0.02, -0.02, 0.005, -0.005, 0.015, -0.015, 0.0, 0.01, -0.01};
+    std::vector<RunHistoryEntry> history;
+    for (int i = 0; i < 8; ++i) history.push_back(history_run("fast", 1.0 + jitter[i % 12]));
+    for (int i = 0; i < 17; ++i) history.push_back(history_run("faster", 0.5 + jitter[i % 12]));
+    for (int i = 0; i < 3; ++i) history.push_back(history_run("slow", 1.2 + jitter[i % 12]));
+    Regression found;
+    CHECK(detect_regression(history, history.back(), found));
+    CHECK(found.since_commit == "slow");
+    CHECK(found.previous_commit == "faster");
+    CHECK(found.wall.relative_change > 0.5);
+}
+
+TEST(regression_not_reported_for_a_rerun_of_an_old_commit) {
+    std::vector<RunHistoryEntry> history;
+    for (double wall : {1.30, 1.31, 1.29, 1.32, 1.30}) history.push_back(history_run("slow", wall));
+    for (double wall : {1.00, 1.01, 0.99, 1.02, 1.00}) history.push_back(history_run("fast", wall));
+    history.push_back(history_run("slow", 1.31)); // An older commit measured again
+    Regression found;
+    CHECK(!detect_regression(history, history.back(), found));
+}
+
+TEST(regression_ignores_failed_and_instrumented_runs) {
+    std::vector<RunHistoryEntry> history;
+    for (double wall : {1.00, 1.01, 0.99, 1.02, 1.00}) history.push_back(history_run("aaaa", wall));
+    for (double wall : {1.30, 1.31, 1.29, 1.32, 1.30}) {
+        RunHistoryEntry entry = history_run("bbbb", wall);
+        entry.instrumented = true;
+        history.push_back(entry);
+    }
+    RunHistoryEntry failed = history_run("bbbb", 2.0);
+    failed.exit_code = 1;
+    history.push_back(failed);
+    Regression found;
+    CHECK(!detect_regression(history, history_run("bbbb", 1.0), found));
+}
+
+// --- History Store ---
+
+namespace {
+
+/** @brief A fresh directory for a history file, removed with its contents at scope exit. */
+struct ScratchDirectory {
+    std::filesystem::path path;
+    ScratchDirectory() {
+        char pattern[] = "/tmp/boredaf-test-XXXXXX";
+        if (mkdtemp(pattern)) path = pattern;
+    }
+    ~ScratchDirectory() {
+        std::error_code ignored;
+        if (!path.empty()) std::filesystem::remove_all(path, ignored);
+    }
+};
+
+JsonValue numbered_record(int index) {
+    return JsonValue::make_object().set("index", index).set("padding", std::string(4000, 'x'));
+}
+
+std::vector<int> loaded_indices(const HistoryStore& store) {
+    std::vector<int> indices;
+    for (const auto& record : store.load()) indices.push_back(static_cast<int>(record["index"].as_number(-1)));
+    return indices;
+}
+
+} // namespace
+
+TEST(history_store_appends_and_loads_in_order) {
+    ScratchDirectory scratch;
+    HistoryStore store(scratch.path / "history.jsonl");
+    CHECK(store.load().empty()); // Neither file exists yet
+    for (int i = 0; i < 3; ++i) CHECK(store.append(numbered_record(i)));
+    CHECK((loaded_indices(store) == std::vector<int>{0, 1, 2}));
+    CHECK(store.rotated_path() == scratch.path / "history.1.jsonl");
+}
+
+TEST(history_store_rotates_when_full_and_keeps_two_files) {
+    ScratchDirectory scratch;
+    HistoryStore store(scratch.path / "history.jsonl");
+    // Fill the file past kMaxBytes: the append after that moves it aside first
+    int index = 0;
+    do {
+        CHECK(store.append(numbered_record(index++)));
+    } while (std::filesystem::file_size(store.path()) < HistoryStore::kMaxBytes);
+    // The rotating append still writes through the descriptor it opened, into the rotated file
+    CHECK(store.append(numbered_record(index++)));
+    int first_file = index;
+    CHECK(std::filesystem::exists(store.rotated_path()));
+    CHECK(!std::filesystem::exists(store.path()));
+    CHECK(store.append(numbered_record(index++)));
+    CHECK(std::filesystem::file_size(store.path()) < 8192); // Only the newest record
+    std::vector<int> indices = loaded_indices(store);
+    CHECK(static_cast<int>(indices.size()) == index);
+    CHECK(indices.front() == 0 && indices.back() == index - 1);
+    CHECK(std::is_sorted(indices.begin(), indices.end()));
+
+    // A second rotation replaces the first rotated file: the oldest records go
+    while (std::filesystem::file_size(store.path()) < HistoryStore::kMaxBytes) CHECK(store.append(numbered_record(index++)));
+    CHECK(store.append(numbered_record(index++)));
+    CHECK(store.append(numbered_record(index++)));
+    indices = loaded_indices(store);
+    CHECK(indices.front() == first_file);
+    CHECK(indices.back() == index - 1);
+    CHECK(static_cast<int>(indices.size()) == index - first_file);
+}
+
+TEST(history_store_skips_a_torn_line) {
+    ScratchDirectory scratch;
+    HistoryStore store(scratch.path / "history.jsonl");
+    CHECK(store.append(numbered_record(1)));
+    {
+        std::ofstream out(store.path(), std::ios::app);
+        out << "{\"index\": 2, \"padd"; // A crash in the middle of a write
+    }
+    std::ofstream(store.path(), std::ios::app) << "\n";
+    CHECK(store.append(numbered_record(3)));
+    CHECK((loaded_indices(store) == std::vector<int>{1, 3}));
+}
+
+int main() { return run_tests(); }
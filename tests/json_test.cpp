@@ -0,0 +1,58 @@
+/**
+ * @file json_test.cpp
+ * @brief Unit tests for the JSON reader and writer.
+ */
+
+#include "main.cpp"
+#include "test_harness.h"
+
+// --- JSON ---
+
+TEST(json_parses_scalars_and_nesting) {
+    JsonValue value = parse_json(R"({"a": [1, -2.5, 3e2], "b": {"c": true, "d": false, "e": null}, "f": "x"})");
+    CHECK(value.is_object());
+    CHECK(value["a"].is_array());
+    CHECK(value["a"].array.size() == 3);
+    CHECK(value["a"].array[1].as_number() == -2.5);
+    CHECK(value["a"].array[2].as_number() == 300.0);
+    CHECK(value["b"]["c"].as_bool() == true);
+    CHECK(value["b"]["d"].as_bool(true) == false);
+    CHECK(value["b"]["e"].is_null());
+    CHECK(value["f"].as_string() == "x");
+    CHECK(value["missing"].is_null());
+}
+
+TEST(json_decodes_escapes) {
+    JsonValue value = parse_json(R"(["a\"b\\c\n\t", "\u00e9", "\ud83d\ude00"])");
+    CHECK(value.array.size() == 3);
+    CHECK(value.array[0].as_string() == "a\"b\\c\n\t");
+    CHECK(value.array[1].as_string() == "\xc3\xa9");
+    CHECK(value.array[2].as_string() == "\xf0\x9f\x98\x80");
+}
+
+TEST(json_round_trips) {
+    JsonValue original = JsonValue::make_object()
+        .set("text", "quote \" backslash \\ newline \n control \x01")
+        .set("number", 1234.5)
+        .set("flag", true)
+        .set("list", JsonValue::make_array().push(1).push("two").push(JsonValue()));
+    for (int indent : {0, 2}) {
+        JsonValue parsed = parse_json(to_json(original, indent));
+        CHECK(parsed["text"].as_string() == original["text"].as_string());
+        CHECK(parsed["number"].as_number() == 1234.5);
+        CHECK(parsed["flag"].as_bool());
+        CHECK(parsed["list"].array.size() == 3);
+        CHECK(parsed["list"].array[1].as_string() == "two");
+        CHECK(parsed["list"].array[2].is_null());
+    }
+}
+
+TEST(json_rejects_malformed_documents) {
+    CHECK_THROWS(parse_json("{"));
+    CHECK_THROWS(parse_json("[1,"));
+    CHECK_THROWS(parse_json("\"abc"));
+    CHECK_THROWS(parse_json("1 2"));
+    CHECK_THROWS(parse_json(""));
+}
+
+int main() { return run_tests(); }
@@ -0,0 +1,103 @@
+/**
+ * @file output_test.cpp
+ * @brief Unit tests for decoding and recording the live output of runs.
+ */
+
+#include "main.cpp"
+#include "test_harness.h"
+
+#include <cmath>
+
+// --- UTF-8 Decoding ---
+
+namespace {
+
+const std::string kReplacement = "\xEF\xBF\xBD"; // U+FFFD
+
+std::string feed(Utf8Decoder& decoder, const std::string& bytes) {
+    return decoder.feed(bytes.data(), bytes.size());
+}
+
+} // namespace
+
+TEST(utf8_passes_complete_text_through) {
+    Utf8Decoder decoder;
+    CHECK(feed(decoder, "plain \xc3\xa9 \xe2\x82\xac \xf0\x9f\x98\x80\n") == "plain \xc3\xa9 \xe2\x82\xac \xf0\x9f\x98\x80\n");
+    CHECK(decoder.finish().empty());
+}
+
+TEST(utf8_holds_back_a_sequence_split_across_reads) {
+    Utf8Decoder decoder;
+    CHECK(feed(decoder, "caf\xc3") == "caf");
+    CHECK(feed(decoder, "\xa9!") == "\xc3\xa9!");
+    const std::string emoji = "\xf0\x9f\x98\x80";
+    std::string decoded;
+    for (size_t i = 0; i < emoji.size(); ++i) {
+        std::string part = feed(decoder, emoji.substr(i, 1));
+        CHECK(i + 1 == emoji.size() || part.empty()); // Nothing until the last byte arrives
+        decoded += part;
+    }
+    CHECK(decoded == emoji);
+    CHECK(decoder.finish().empty());
+}
+
+TEST(utf8_replaces_invalid_bytes) {
+    Utf8Decoder decoder;
+    CHECK(feed(decoder, "a\xff" "b") == "a" + kReplacement + "b");
+    CHECK(feed(decoder, "\x80") == kReplacement);                   // Stray continuation byte
+    CHECK(feed(decoder, "\xc3" "a") == kReplacement + "a");         // Lead byte without its continuation
+    CHECK(feed(decoder, std::string("x\0y", 3)) == "x" + kReplacement + "y");
+}
+
+TEST(utf8_finish_flushes_an_incomplete_sequence) {
+    Utf8Decoder decoder;
+    CHECK(feed(decoder, "ok\xe2\x82") == "ok");
+    CHECK(decoder.finish() == kReplacement);
+    CHECK(decoder.finish().empty());
+    CHECK(feed(decoder, "next") == "next"); // Nothing left over from before
+}
+
+// --- Output Record ---
+
+TEST(output_record_keeps_both_streams_in_order) {
+    using namespace std::chrono_literals;
+    OutputRecord record;
+    auto t0 = std::chrono::steady_clock::now();
+    record.start(t0);
+    record.append(OutputRecord::Stream::Stdout, "one\n", 4, t0 + 5ms);
+    record.append(OutputRecord::Stream::Stderr, "warn\n", 5, t0 + 20ms);
+    record.append(OutputRecord::Stream::Stdout, "two\n", 4, t0 + 25ms);
+    CHECK(record.chunks().size() == 3);
+    CHECK(record.chunks()[1].stream == OutputRecord::Stream::Stderr);
+    CHECK(record.text(record.chunks()[1]) == "warn\n");
+    CHECK(record.text(record.chunks()[2]) == "two\n");
+    CHECK(record.bytes(OutputRecord::Stream::Stdout) == 8);
+    CHECK(record.bytes(OutputRecord::Stream::Stderr) == 5);
+    CHECK(std::fabs(record.time_to_first_output_ms() - 5.0) < 1e-6);
+    double stall_at = 0.0;
+    CHECK(std::fabs(record.longest_stall_ms(&stall_at) - 15.0) < 1e-6);
+    CHECK(std::fabs(stall_at - 20.0) < 1e-6);
+}
+
+TEST(output_record_keeps_only_the_index_past_its_limit) {
+    OutputRecord record;
+    auto t0 = std::chrono::steady_clock::now();
+    record.start(t0);
+    std::string big(OutputRecord::kMaxBytes, 'x');
+    record.append(OutputRecord::Stream::Stdout, big.data(), big.size(), t0);
+    record.append(OutputRecord::Stream::Stdout, "late", 4, t0);
+    CHECK(record.chunks().size() == 2);
+    CHECK(record.text(record.chunks()[0]).size() == OutputRecord::kMaxBytes);
+    CHECK(record.chunks()[1].offset == OutputRecord::kDropped);
+    CHECK(record.chunks()[1].length == 4);
+    CHECK(record.text(record.chunks()[1]).empty());
+    CHECK(record.bytes(OutputRecord::Stream::Stdout) == OutputRecord::kMaxBytes + 4);
+}
+
+TEST(output_record_without_output) {
+    OutputRecord record;
+    CHECK(record.time_to_first_output_ms() == -1.0);
+    CHECK(record.summary() == "No output.");
+}
+
+int main() { return run_tests(); }
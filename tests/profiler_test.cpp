@@ -0,0 +1,36 @@
+/**
+ * @file profiler_test.cpp
+ * @brief Unit tests for folding sampled call stacks.
+ */
+
+#include "main.cpp"
+#include "test_harness.h"
+
+// --- Sampling Profiler ---
+
+TEST(folded_stacks_merge_and_escape_separators) {
+    FoldedStacks folded;
+    folded.add({"main", "run"});
+    folded.add({"main", "run"}, 2);
+    folded.add({"main", "operator;weird"});
+    folded.add({});
+    CHECK(folded.total() == 4);
+    CHECK(folded.stacks["main;run"] == 3);
+    CHECK(folded.to_text() == "main;operator:weird 1\nmain;run 3\n");
+}
+
+TEST(perf_script_folds_leaf_first_frames) {
+    FoldedStacks folded = parse_perf_script(
+        "prog 123 1.000: 1000 cycles:\n"
+        "\t  4005d6 func+0x10 (/bin/prog)\n"
+        "\t  400400 main+0x20 (/bin/prog)\n"
+        "\n"
+        "prog 123 1.001: 1000 cycles:\n"
+        "\t  7f0000 [unknown] (/lib/libc.so.6)\n"
+        "\t  400400 main+0x20 (/bin/prog)\n");
+    CHECK(folded.total() == 2);
+    CHECK(folded.stacks["main;func"] == 1);
+    CHECK(folded.stacks["main;[libc.so.6]"] == 1);
+}
+
+int main() { return run_tests(); }
@@ -0,0 +1,31 @@
+/**
+ * @file run_controls_test.cpp
+ * @brief Unit tests for the reproducibility controls of benchmark runs.
+ */
+
+#include "main.cpp"
+#include "test_harness.h"
+
+#include <cmath>
+
+// --- Run Controls ---
+
+TEST(cpu_lists_parse_ranges) {
+    CHECK((parse_cpu_list("2-3,6") == std::vector<int>{2, 3, 6}));
+    CHECK((parse_cpu_list(" 1 , 1-2 ") == std::vector<int>{1, 2}));
+    CHECK(parse_cpu_list("").empty());
+    CHECK_THROWS(parse_cpu_list("3-1"));
+    CHECK_THROWS(parse_cpu_list("a"));
+    CHECK_THROWS(parse_cpu_list("1-"));
+}
+
+TEST(coefficient_of_variation_is_relative_noise) {
+    CHECK(SampleStats::of({1.0, 1.0, 1.0}).cv() == 0.0);
+    SampleStats scaled_small = SampleStats::of({1.0, 2.0, 3.0});
+    SampleStats scaled_large = SampleStats::of({100.0, 200.0, 300.0});
+    CHECK(std::fabs(scaled_small.cv() - 0.5) < 1e-12); // stddev 1 over mean 2
+    CHECK(std::fabs(scaled_large.cv() - scaled_small.cv()) < 1e-12);
+    CHECK(SampleStats::of({}).cv() == 0.0);
+}
+
+int main() { return run_tests(); }
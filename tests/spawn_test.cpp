@@ -0,0 +1,113 @@
+/**
+ * @file spawn_test.cpp
+ * @brief Unit tests for spawn_process(), through the pre-forked spawn helper
+ * and through the posix_spawn fallback.
+ */
+
+#include "main.cpp"
+#include "test_harness.h"
+
+// --- Spawning ---
+
+namespace {
+
+/** @brief Runs argv to completion and returns its stdout; exit_code gets the exit status. */
+std::string run_to_end(SpawnOptions options, int& exit_code) {
+    options.stdout_mode = StdioMode::Pipe;
+    ChildProcess child = spawn_process(options);
+    std::string output = read_all(child.stdout_fd);
+    int status = child.wait();
+    exit_code = WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+    return output;
+}
+
+/** @brief Runs body once through the spawn helper and once through posix_spawn. */
+void both_ways(const std::function<void()>& body) {
+    CHECK(g_spawn_helper.available());
+    body();
+    g_spawn_helper.set_enabled(false);
+    body();
+    g_spawn_helper.set_enabled(true);
+}
+
+} // namespace
+
+TEST(spawn_passes_arguments_verbatim) {
+    both_ways([]() {
+        SpawnOptions options;
+        options.argv = {"printf", "%s|%s", "a b", "$HOME;'\""};
+        int exit_code = -1;
+        CHECK(run_to_end(options, exit_code) == "a b|$HOME;'\"");
+        CHECK(exit_code == 0);
+    });
+}
+
+TEST(spawn_applies_environment_and_working_directory) {
+    both_ways([]() {
+        SpawnOptions options;
+        options.argv = {"sh", "-c", "printf '%s %s' \"$BOREDAF_TEST\" \"$(pwd)\""};
+        options.env = {"BOREDAF_TEST=set"};
+        options.working_dir = "/";
+        int exit_code = -1;
+        CHECK(run_to_end(options, exit_code) == "set /");
+    });
+}
+
+TEST(spawn_reports_the_exit_status) {
+    both_ways([]() {
+        SpawnOptions options;
+        options.argv = {"sh", "-c", "exit 7"};
+        int exit_code = -1;
+        run_to_end(options, exit_code);
+        CHECK(exit_code == 7);
+    });
+}
+
+TEST(spawn_throws_when_the_program_does_not_exist) {
+    both_ways([]() {
+        SpawnOptions options;
+        options.argv = {"/nonexistent/boredaf-no-such-program"};
+        CHECK_THROWS(spawn_process(options));
+    });
+    CHECK(g_spawn_helper.available()); // A failed exec leaves the helper running
+}
+
+TEST(spawn_holds_the_child_for_before_exec) {
+    SpawnOptions options;
+    options.argv = {"true"};
+    pid_t seen = -1;
+    bool seen_held = false;
+    options.before_exec = [&](pid_t pid, bool held) {
+        seen = pid;
+        seen_held = held;
+    };
+    ChildProcess child = spawn_process(options);
+    pid_t pid = child.pid;
+    int status = child.wait();
+    CHECK(seen == pid);
+    CHECK(seen_held);
+    CHECK(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+}
+
+TEST(spawn_disables_transparent_hugepages_only_through_the_helper) {
+    SpawnOptions options;
+    options.argv = {"grep", "-c", "^THP_enabled:[[:space:]]*0", "/proc/self/status"};
+    options.disable_thp = true;
+    int exit_code = -1;
+    std::string matches = run_to_end(options, exit_code);
+    // Kernels before 5.0 do not list THP_enabled; the run must still succeed through the helper
+    bool listed = read_text_file("/proc/self/status").find("THP_enabled:") != std::string::npos;
+    CHECK(matches == (listed ? "1\n" : "0\n"));
+    g_spawn_helper.set_enabled(false);
+    CHECK_THROWS(spawn_process(options));
+    g_spawn_helper.set_enabled(true);
+}
+
+int main() {
+    // Like the launcher's main(): before any other thread exists
+    if (!g_spawn_helper.start()) {
+        std::cerr << "Could not start the spawn helper\n";
+        return 1;
+    }
+    return run_tests();
+}
@@ -0,0 +1,103 @@
+/**
+ * @file statistics_test.cpp
+ * @brief Unit tests for the benchmark statistics.
+ */
+
+#include "main.cpp"
+#include "test_harness.h"
+
+#include <cmath>
+
+// --- Summary Statistics ---
+
+namespace {
+
+bool near(double actual, double expected, double tolerance = 1e-9) {
+    return std::fabs(actual - expected) <= tolerance;
+}
+
+} // namespace
+
+TEST(percentile_interpolates_between_neighbours) {
+    std::vector<double> sorted = {10, 20, 30, 40};
+    CHECK(near(percentile(sorted, 0.0), 10));
+    CHECK(near(percentile(sorted, 0.5), 25));
+    CHECK(near(percentile(sorted, 0.9), 37));
+    CHECK(near(percentile(sorted, 1.0), 40));
+    CHECK(percentile({}, 0.5) == 0.0);
+}
+
+TEST(sample_stats_summarise_unsorted_values) {
+    SampleStats stats = SampleStats::of({9, 4, 2, 5, 4, 7, 4, 5});
+    CHECK(stats.count == 8);
+    CHECK(near(stats.mean, 5.0));
+    CHECK(near(stats.median, 4.5));
+    CHECK(near(stats.stddev, std::sqrt(32.0 / 7.0))); // Sample, not population, deviation
+    CHECK(stats.min == 2.0);
+    CHECK(stats.max == 9.0);
+    CHECK(near(stats.p90, 7.6));
+    double margin = 2.365 * std::sqrt(32.0 / 7.0) / std::sqrt(8.0); // t(0.975, 7 degrees of freedom)
+    CHECK(near(stats.ci_low, 5.0 - margin));
+    CHECK(near(stats.ci_high, 5.0 + margin));
+}
+
+TEST(sample_stats_of_one_value_have_no_spread) {
+    SampleStats stats = SampleStats::of({3.5});
+    CHECK(stats.count == 1);
+    CHECK(stats.mean == 3.5);
+    CHECK(stats.median == 3.5);
+    CHECK(stats.stddev == 0.0);
+    CHECK(stats.ci_low == 3.5);
+    CHECK(stats.ci_high == 3.5);
+}
+
+TEST(sample_stats_of_nothing_are_zero) {
+    SampleStats stats = SampleStats::of({});
+    CHECK(stats.count == 0);
+    CHECK(stats.mean == 0.0);
+    CHECK(stats.max == 0.0);
+}
+
+TEST(student_t_matches_the_table_and_approaches_normal) {
+    CHECK(student_t_975(1) == 12.706);
+    CHECK(student_t_975(30) == 2.042);
+    CHECK(near(student_t_975(120), 1.980, 0.002));
+    CHECK(student_t_975(0) == 0.0);
+}
+
+// --- A/B Comparison ---
+
+TEST(ab_comparison_detects_a_clear_change) {
+    std::vector<double> a = {1.00, 1.01, 0.99, 1.02, 0.98, 1.00, 1.01, 0.99};
+    std::vector<double> b = {1.20, 1.21, 1.19, 1.22, 1.18, 1.20, 1.21, 1.19};
+    ABComparison comparison = ABComparison::of(a, b);
+    CHECK(comparison.significant);
+    CHECK(comparison.p_value < 0.01);
+    CHECK(std::fabs(comparison.relative_change - 0.2) < 0.01);
+    CHECK(comparison.ci_low > 0.0);
+}
+
+TEST(ab_comparison_finds_no_change_in_the_same_samples) {
+    std::vector<double> a = {1.00, 1.01, 0.99, 1.02, 0.98, 1.00};
+    ABComparison comparison = ABComparison::of(a, a);
+    CHECK(!comparison.significant);
+    CHECK(comparison.p_value > 0.5);
+    CHECK(comparison.relative_change == 0.0);
+}
+
+TEST(ab_comparison_reports_a_speed_up_as_negative) {
+    std::vector<double> a = {2.00, 2.02, 1.98, 2.01, 1.99, 2.00};
+    std::vector<double> b = {1.50, 1.51, 1.49, 1.52, 1.48, 1.50};
+    ABComparison comparison = ABComparison::of(a, b);
+    CHECK(comparison.significant);
+    CHECK(std::fabs(comparison.relative_change + 0.25) < 0.01);
+    CHECK(comparison.ci_high < 0.0);
+}
+
+TEST(ab_comparison_needs_two_samples_per_side) {
+    ABComparison comparison = ABComparison::of({1.0}, {2.0, 2.1});
+    CHECK(!comparison.significant);
+    CHECK(comparison.p_value == 1.0);
+}
+
+int main() { return run_tests(); }
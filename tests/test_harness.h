@@ -0,0 +1,88 @@
+/**
+ * @file test_harness.h
+ * @brief Minimal test registry shared by the unit tests.
+ * Every test file is its own executable that compiles main.cpp in with
+ * BOREDAF_NO_MAIN, so its internal functions are reachable; the tests need no
+ * display and do not start Gtk. A file includes this header after main.cpp,
+ * defines its cases with TEST and ends with
+ * `int main() { return run_tests(); }`.
+ */
+
+#pragma once
+
+#include <exception>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// --- Test Harness ---
+
+namespace {
+
+struct TestCase {
+    const char* name;
+    std::function<void()> body;
+};
+
+std::vector<TestCase>& test_cases() {
+    static std::vector<TestCase> cases;
+    return cases;
+}
+
+int g_failures = 0;
+
+struct TestRegistration {
+    TestRegistration(const char* name, std::function<void()> body) { test_cases().push_back({name, std::move(body)}); }
+};
+
+/**
+ * @brief Runs every registered test; an exception escaping a test fails it.
+ * @return The process exit code: 0 if all tests passed.
+ */
+int run_tests() {
+    size_t failed_tests = 0;
+    for (const auto& test : test_cases()) {
+        int before = g_failures;
+        try {
+            test.body();
+        } catch (const std::exception& e) {
+            std::cerr << "  unexpected exception: " << e.what() << "\n";
+            ++g_failures;
+        }
+        bool passed = g_failures == before;
+        if (!passed) ++failed_tests;
+        std::cout << (passed ? "[ OK ] " : "[FAIL] ") << test.name << "\n";
+    }
+    std::cout << test_cases().size() - failed_tests << "/" << test_cases().size() << " tests passed\n";
+    return failed_tests == 0 ? 0 : 1;
+}
+
+} // namespace
+
+#define TEST(name)                                                  \
+    static void test_##name();                                      \
+    static TestRegistration register_##name(#name, test_##name);    \
+    static void test_##name()
+
+#define CHECK(condition)                                                                          \
+    do {                                                                                          \
+        if (!(condition)) {                                                                       \
+            std::cerr << "  " << __FILE__ << ":" << __LINE__ << ": CHECK(" #condition ") failed\n"; \
+            ++g_failures;                                                                         \
+        }                                                                                         \
+    } while (false)
+
+#define CHECK_THROWS(expression)                                                                          \
+    do {                                                                                                  \
+        bool thrown = false;                                                                              \
+        try {                                                                                             \
+            (void)(expression);                                                                           \
+        } catch (const std::exception&) {                                                                 \
+            thrown = true;                                                                                \
+        }                                                                                                 \
+        if (!thrown) {                                                                                    \
+            std::cerr << "  " << __FILE__ << ":" << __LINE__ << ": " #expression " did not throw\n";      \
+            ++g_failures;                                                                                 \
+        }                                                                                                 \
+    } while (false)